@@ -0,0 +1,148 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_bit.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Atomically retrieves the state of a bit in an array of atomic words
+    //!
+    //! \param[in]  source     where to read from
+    //! \param[in]  bitNumber  which bit to retrieve (zero-indexed),
+    //!                        bit n lives in bit (n % 64) of word (n / 64)
+    //! \param[in]  order      the memory order of the load
+    //!
+    //! \returns  the state of the bit
+    //!
+    //! \note  on a little endian platform the bits are numbered the same way as #getBit numbers them
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    inline Bit atomicGetBit(const std::atomic<uint64_t>* source, size_t bitNumber, std::memory_order order = std::memory_order_seq_cst);
+
+    //!
+    //! \brief  Atomically sets a bit to #Bit::One, without disturbing other bits of the same word
+    //!
+    //! \param[out]  target     where to write to
+    //! \param[in]   bitNumber  which bit to set (zero-indexed),
+    //!                         bit n lives in bit (n % 64) of word (n / 64)
+    //! \param[in]   order      the memory order of the read-modify-write
+    //!
+    //! \par Example
+    //! \code
+    //!     std::atomic<uint64_t> visited[4] = { };
+    //!     atomicSetBit(visited, 70);                                   // visited[1] is now 64
+    //!     const auto x = atomicTestAndSetBit(visited, 70);             // returns Bit::One
+    //!     atomicClearBit(visited, 70, std::memory_order_relaxed);      // visited[1] is now 0
+    //! \endcode
+    //!
+    //! \note  unlike #setBit, concurrent calls on bits of the same word never lose updates
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #atomicTestAndSetBit
+    //!
+    inline void atomicSetBit(std::atomic<uint64_t>* target, size_t bitNumber, std::memory_order order = std::memory_order_seq_cst);
+
+    //!
+    //! \brief  Atomically sets a bit to #Bit::Zero, without disturbing other bits of the same word
+    //!
+    //! \see  #atomicSetBit
+    //!
+    inline void atomicClearBit(std::atomic<uint64_t>* target, size_t bitNumber, std::memory_order order = std::memory_order_seq_cst);
+
+    //!
+    //! \brief  Atomically sets a bit to #Bit::One, returning what it was before
+    //!
+    //! \returns  the state of the bit before it was set, so exactly one of several
+    //!           threads racing to set the same bit sees #Bit::Zero
+    //!
+    //! \see  #atomicSetBit
+    //!
+    inline Bit atomicTestAndSetBit(std::atomic<uint64_t>* target, size_t bitNumber, std::memory_order order = std::memory_order_seq_cst);
+
+    //!
+    //! \brief  Atomically sets a bit to #Bit::Zero, returning what it was before
+    //!
+    //! \returns  the state of the bit before it was cleared
+    //!
+    //! \see  #atomicSetBit
+    //!
+    inline Bit atomicTestAndClearBit(std::atomic<uint64_t>* target, size_t bitNumber, std::memory_order order = std::memory_order_seq_cst);
+
+    //!
+    //! \brief  Atomically inverts a bit, returning what it was before
+    //!
+    //! \returns  the state of the bit before it was flipped
+    //!
+    //! \see  #atomicSetBit
+    //!
+    inline Bit atomicFlipBit(std::atomic<uint64_t>* target, size_t bitNumber, std::memory_order order = std::memory_order_seq_cst);
+
+    namespace detail {
+        inline constexpr uint64_t atomicBitMask(size_t bitNumber);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+inline constexpr uint64_t bitter::detail::atomicBitMask(const size_t bitNumber) {
+    return uint64_t(1) << (bitNumber % 64);
+}
+
+inline bitter::Bit bitter::atomicGetBit(const std::atomic<uint64_t>* const source, const size_t bitNumber, const std::memory_order order) {
+    return (source[bitNumber / 64].load(order) & detail::atomicBitMask(bitNumber)) ? Bit::One : Bit::Zero;
+}
+
+inline void bitter::atomicSetBit(std::atomic<uint64_t>* const target, const size_t bitNumber, const std::memory_order order) {
+    target[bitNumber / 64].fetch_or(detail::atomicBitMask(bitNumber), order);
+}
+
+inline void bitter::atomicClearBit(std::atomic<uint64_t>* const target, const size_t bitNumber, const std::memory_order order) {
+    target[bitNumber / 64].fetch_and(~detail::atomicBitMask(bitNumber), order);
+}
+
+inline bitter::Bit bitter::atomicTestAndSetBit(std::atomic<uint64_t>* const target, const size_t bitNumber, const std::memory_order order) {
+    const uint64_t mask = detail::atomicBitMask(bitNumber);
+    return (target[bitNumber / 64].fetch_or(mask, order) & mask) ? Bit::One : Bit::Zero;
+}
+
+inline bitter::Bit bitter::atomicTestAndClearBit(std::atomic<uint64_t>* const target, const size_t bitNumber, const std::memory_order order) {
+    const uint64_t mask = detail::atomicBitMask(bitNumber);
+    return (target[bitNumber / 64].fetch_and(~mask, order) & mask) ? Bit::One : Bit::Zero;
+}
+
+inline bitter::Bit bitter::atomicFlipBit(std::atomic<uint64_t>* const target, const size_t bitNumber, const std::memory_order order) {
+    const uint64_t mask = detail::atomicBitMask(bitNumber);
+    return (target[bitNumber / 64].fetch_xor(mask, order) & mask) ? Bit::One : Bit::Zero;
+}
@@ -22,5 +22,23 @@ namespace bitter {
         Zero = 0,
         One = 1
     };
+
+    //!
+    //! \brief  How the bits within each byte are numbered
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0x80 };
+    //!     const auto x = getBit(data, 7);                      // returns Bit::One
+    //!     const auto y = getBit<BitOrder::MsbFirst>(data, 0);  // returns Bit::One
+    //! \endcode
+    //!
+    enum class BitOrder {
+        //! bit 0 is the least significant bit of the first byte, as in DEFLATE
+        LsbFirst,
+
+        //! bit 0 is the most significant bit of the first byte, as in most video, audio and network formats
+        MsbFirst
+    };
 }
 
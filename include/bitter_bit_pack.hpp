@@ -0,0 +1,864 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+#if (defined(__SSE2__) || defined(__AVX2__)) && ! defined(BITTER_BIG_ENDIAN)
+#include <immintrin.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    namespace detail {
+        //!
+        //! \brief  The operations the bit packing kernels need, on plain arrays of lanes
+        //!
+        //! \tparam  Lanes  how many 32-bit lanes a vector has
+        //!
+        //! \note  the kernels produce the same bytes with this as with the SIMD versions,
+        //!        which is what makes it a drop-in fallback
+        //!
+        template <size_t Lanes>
+        struct BitPackScalar {
+            struct Vector {
+                uint32_t lanes[Lanes];
+            };
+
+            static constexpr size_t laneCount = Lanes;
+
+            static Vector loadValues(const uint32_t* source);
+            static void storeValues(uint32_t* target, const Vector& vector);
+
+            // packed words are stored little-endian, so the format does not depend on the host
+            static Vector loadPacked(const uint8_t* source);
+            static void storePacked(uint8_t* target, const Vector& vector);
+
+            static Vector broadcast(uint32_t value);
+
+            template <size_t Count>
+            static Vector shiftLeft(const Vector& vector);
+
+            template <size_t Count>
+            static Vector shiftRight(const Vector& vector);
+
+            static Vector bitAnd(const Vector& lhs, const Vector& rhs);
+            static Vector bitOr(const Vector& lhs, const Vector& rhs);
+            static Vector add(const Vector& lhs, const Vector& rhs);
+            static Vector subtract(const Vector& lhs, const Vector& rhs);
+        };
+
+#if defined(__SSE2__) && ! defined(BITTER_BIG_ENDIAN)
+        //!
+        //! \brief  #BitPackScalar on four lanes of an SSE2 register
+        //!
+        struct BitPackSse2 {
+            using Vector = __m128i;
+
+            static constexpr size_t laneCount = 4;
+
+            static Vector loadValues(const uint32_t* source);
+            static void storeValues(uint32_t* target, Vector vector);
+            static Vector loadPacked(const uint8_t* source);
+            static void storePacked(uint8_t* target, Vector vector);
+            static Vector broadcast(uint32_t value);
+
+            template <size_t Count>
+            static Vector shiftLeft(Vector vector);
+
+            template <size_t Count>
+            static Vector shiftRight(Vector vector);
+
+            static Vector bitAnd(Vector lhs, Vector rhs);
+            static Vector bitOr(Vector lhs, Vector rhs);
+            static Vector add(Vector lhs, Vector rhs);
+            static Vector subtract(Vector lhs, Vector rhs);
+        };
+#endif
+
+#if defined(__AVX2__) && ! defined(BITTER_BIG_ENDIAN)
+        //!
+        //! \brief  #BitPackScalar on eight lanes of an AVX2 register
+        //!
+        struct BitPackAvx2 {
+            using Vector = __m256i;
+
+            static constexpr size_t laneCount = 8;
+
+            static Vector loadValues(const uint32_t* source);
+            static void storeValues(uint32_t* target, Vector vector);
+            static Vector loadPacked(const uint8_t* source);
+            static void storePacked(uint8_t* target, Vector vector);
+            static Vector broadcast(uint32_t value);
+
+            template <size_t Count>
+            static Vector shiftLeft(Vector vector);
+
+            template <size_t Count>
+            static Vector shiftRight(Vector vector);
+
+            static Vector bitAnd(Vector lhs, Vector rhs);
+            static Vector bitOr(Vector lhs, Vector rhs);
+            static Vector add(Vector lhs, Vector rhs);
+            static Vector subtract(Vector lhs, Vector rhs);
+        };
+#endif
+
+        //!
+        //! \brief  The widest vector the compiler targets for a number of lanes, #BitPackScalar if there is none
+        //!
+        template <size_t Lanes>
+        struct BitPackSimd {
+            using Type = BitPackScalar<Lanes>;
+        };
+
+#if defined(__SSE2__) && ! defined(BITTER_BIG_ENDIAN)
+        template <>
+        struct BitPackSimd<4> {
+            using Type = BitPackSse2;
+        };
+#endif
+
+#if defined(__AVX2__) && ! defined(BITTER_BIG_ENDIAN)
+        template <>
+        struct BitPackSimd<8> {
+            using Type = BitPackAvx2;
+        };
+#endif
+
+        //!
+        //! \brief  Packs or unpacks the Index-th value of every lane, a value that ends within its packed word
+        //!
+        template <typename Simd, size_t Width, size_t Index, bool SpansWords = (((Index * Width) % 32) + Width > 32)>
+        struct BitPackStep {
+            using Vector = typename Simd::Vector;
+
+            static void pack(const uint32_t* source, const Vector& reference, const Vector& mask, Vector& word, uint8_t* target);
+            static void unpack(const uint8_t* source, const Vector& reference, const Vector& mask, uint32_t* target);
+        };
+
+        //!
+        //! \brief  #BitPackStep for a value whose high bits go in the next packed word
+        //!
+        template <typename Simd, size_t Width, size_t Index>
+        struct BitPackStep<Simd, Width, Index, true> {
+            using Vector = typename Simd::Vector;
+
+            static void pack(const uint32_t* source, const Vector& reference, const Vector& mask, Vector& word, uint8_t* target);
+            static void unpack(const uint8_t* source, const Vector& reference, const Vector& mask, uint32_t* target);
+        };
+
+        //!
+        //! \brief  Packs and unpacks a whole block at one width, as 32 steps whose shifts are all constants
+        //!
+        template <typename Simd, size_t Width>
+        struct BitPackKernel {
+            static void pack(const uint32_t* source, uint32_t reference, uint8_t* target);
+            static void unpack(const uint8_t* source, uint32_t reference, uint32_t* target);
+
+            template <size_t... Indices>
+            static void packSteps(const uint32_t* source, uint32_t reference, uint8_t* target, std::index_sequence<Indices...>);
+
+            template <size_t... Indices>
+            static void unpackSteps(const uint8_t* source, uint32_t reference, uint32_t* target, std::index_sequence<Indices...>);
+        };
+
+        //!
+        //! \brief  A width of 0 stores nothing, every value is the reference
+        //!
+        template <typename Simd>
+        struct BitPackKernel<Simd, 0> {
+            static void pack(const uint32_t* source, uint32_t reference, uint8_t* target);
+            static void unpack(const uint8_t* source, uint32_t reference, uint32_t* target);
+        };
+
+        //!
+        //! \brief  Picks the kernel for a width from a table of all 33
+        //!
+        template <typename Simd, size_t... Widths>
+        inline void bitPack(const uint32_t* source, size_t bitWidth, uint8_t* target, uint32_t reference, std::index_sequence<Widths...>);
+
+        template <typename Simd, size_t... Widths>
+        inline void bitUnpack(const uint8_t* source, size_t bitWidth, uint32_t* target, uint32_t reference, std::index_sequence<Widths...>);
+    }
+
+    //!
+    //! \brief  Packs blocks of 32-bit integers at a fixed bit width, with frame-of-reference and patched (PFor) variants
+    //!
+    //! \tparam  BlockSize  how many integers a block holds, 128 or 256
+    //!
+    //! \par Example
+    //! \code
+    //!     uint32_t values[128];                  // given a block of values
+    //!     const auto width = BitPack<128>::bitWidth(values);
+    //!
+    //!     uint8_t packed[BitPack<128>::packedBytes(32)];
+    //!     BitPack<128>::pack(values, width, packed);
+    //!     BitPack<128>::unpack(packed, width, values);
+    //!
+    //!     // or let the codec pick a reference, width and exceptions for a whole column
+    //!     const auto encoded = BitPack<128>::encode(column, columnSize);
+    //!     BitPack<128>::decode(encoded.data(), encoded.size(), column, columnSize);
+    //! \endcode
+    //!
+    //! \note  The layout is vertical, as in SIMD-BP128: value i goes to lane i % L of L = BlockSize / 32
+    //!        32-bit lanes, so a vector of L consecutive values is packed and unpacked with the same
+    //!        shift in every lane. Each lane holds 32 values in Width words, and word j of every lane
+    //!        is stored together. The kernels are generated for every width with all shifts as
+    //!        constants and no branches, on SSE2 for 128-value blocks and AVX2 for 256-value blocks
+    //!        when the compiler targets them, and on plain lane arrays otherwise; all produce the same bytes.
+    //!
+    template <size_t BlockSize>
+    class BitPack {
+        static_assert(BlockSize == 128 || BlockSize == 256, "a BitPack block holds 128 or 256 values");
+
+    public:
+        //!
+        //! \brief  How many values a block holds
+        //!
+        static constexpr size_t blockSize = BlockSize;
+
+        //!
+        //! \returns  how many bytes a block packed at \p bitWidth takes, a multiple of 16
+        //!
+        static constexpr size_t packedBytes(size_t bitWidth);
+
+        //!
+        //! \brief  Works out how many bits the values of a block need
+        //!
+        //! \param[in]  source     the block
+        //! \param[in]  reference  subtracted from every value first, so the smallest value makes a good frame of reference
+        //!
+        //! \returns  the bit length of the largest (value - \p reference), in the range [0, 32]
+        //!
+        static size_t bitWidth(const uint32_t* source, uint32_t reference = 0);
+
+        //!
+        //! \brief  Packs a block
+        //!
+        //! \param[in]   source     the block
+        //! \param[in]   bitWidth   how many bits to keep of each value, in the range [0, 32]
+        //! \param[out]  target     where to write #packedBytes(\p bitWidth) bytes
+        //! \param[in]   reference  subtracted from every value before packing it
+        //!
+        //! \note  the bits of (value - \p reference) above \p bitWidth are dropped
+        //!
+        static void pack(const uint32_t* source, size_t bitWidth, uint8_t* target, uint32_t reference = 0);
+
+        //!
+        //! \brief  Unpacks a block
+        //!
+        //! \param[in]   source     #packedBytes(\p bitWidth) bytes written by pack()
+        //! \param[in]   bitWidth   the width the block was packed at, in the range [0, 32]
+        //! \param[out]  target     where to write the #blockSize values
+        //! \param[in]   reference  added to every value after unpacking it
+        //!
+        static void unpack(const uint8_t* source, size_t bitWidth, uint32_t* target, uint32_t reference = 0);
+
+        //!
+        //! \brief  Encodes a block as patched frame-of-reference (PFor)
+        //!
+        //! \param[in]      source  the block
+        //! \param[in,out]  target  where to append the encoded block
+        //!
+        //! \returns  how many bytes were appended
+        //!
+        //! \note  The smallest value becomes the reference. The width is chosen to minimise the size:
+        //!        values that do not fit are exceptions, packed with their low bits like the rest,
+        //!        while their positions and high bits are stored after the block and patched in
+        //!        on decoding. So a few outliers do not widen every value of the block.
+        //!
+        //! \note  the block is a 4-byte little-endian reference, the width, the exception count and
+        //!        the exception high-bit width as a byte each, the packed values, a byte per exception
+        //!        position, and the exception high bits packed as #setBits packs them
+        //!
+        static size_t encodeBlock(const uint32_t* source, std::vector<uint8_t>& target);
+
+        //!
+        //! \brief  Decodes a block encoded by encodeBlock()
+        //!
+        //! \param[in]   source      the encoded block
+        //! \param[in]   sourceSize  how many bytes \p source holds, at least the size of the block
+        //! \param[out]  target      where to write the #blockSize values
+        //!
+        //! \returns  how many bytes the block took, or 0 if it is malformed or runs past \p sourceSize
+        //!
+        static size_t decodeBlock(const uint8_t* source, size_t sourceSize, uint32_t* target);
+
+        //!
+        //! \brief  Encodes a column of any length as a sequence of encodeBlock() blocks
+        //!
+        //! \param[in]  source  the values
+        //! \param[in]  count   how many values there are
+        //!
+        //! \returns  the encoded blocks, the last one padded with copies of its first value
+        //!
+        static std::vector<uint8_t> encode(const uint32_t* source, size_t count);
+
+        //!
+        //! \brief  Decodes a column encoded by encode()
+        //!
+        //! \param[in]   source      the encoded blocks
+        //! \param[in]   sourceSize  how many bytes \p source holds
+        //! \param[out]  target      where to write the values
+        //! \param[in]   count       how many values were encoded
+        //!
+        //! \returns  true if the blocks were well formed and took exactly \p sourceSize bytes, false otherwise
+        //!
+        static bool decode(const uint8_t* source, size_t sourceSize, uint32_t* target, size_t count);
+
+    private:
+        using Simd = typename detail::BitPackSimd<BlockSize / 32>::Type;
+
+        static constexpr size_t headerBytes = 7;
+    };
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    template <size_t Lanes>
+    constexpr size_t detail::BitPackScalar<Lanes>::laneCount;
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::loadValues(const uint32_t* const source) {
+        Vector vector;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            vector.lanes[lane] = source[lane];
+        }
+
+        return vector;
+    }
+
+    template <size_t Lanes>
+    inline void detail::BitPackScalar<Lanes>::storeValues(uint32_t* const target, const Vector& vector) {
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            target[lane] = vector.lanes[lane];
+        }
+    }
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::loadPacked(const uint8_t* const source) {
+        Vector vector;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            vector.lanes[lane] = loadLittleEndian32(source + (lane * 4));
+        }
+
+        return vector;
+    }
+
+    template <size_t Lanes>
+    inline void detail::BitPackScalar<Lanes>::storePacked(uint8_t* const target, const Vector& vector) {
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            storeLittleEndian32(target + (lane * 4), vector.lanes[lane]);
+        }
+    }
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::broadcast(const uint32_t value) {
+        Vector vector;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            vector.lanes[lane] = value;
+        }
+
+        return vector;
+    }
+
+    template <size_t Lanes>
+    template <size_t Count>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::shiftLeft(const Vector& vector) {
+        static_assert(Count < 32, "shifting a 32-bit lane by 32 or more is undefined");
+
+        Vector result;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            result.lanes[lane] = vector.lanes[lane] << Count;
+        }
+
+        return result;
+    }
+
+    template <size_t Lanes>
+    template <size_t Count>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::shiftRight(const Vector& vector) {
+        static_assert(Count < 32, "shifting a 32-bit lane by 32 or more is undefined");
+
+        Vector result;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            result.lanes[lane] = vector.lanes[lane] >> Count;
+        }
+
+        return result;
+    }
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::bitAnd(const Vector& lhs, const Vector& rhs) {
+        Vector result;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            result.lanes[lane] = lhs.lanes[lane] & rhs.lanes[lane];
+        }
+
+        return result;
+    }
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::bitOr(const Vector& lhs, const Vector& rhs) {
+        Vector result;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            result.lanes[lane] = lhs.lanes[lane] | rhs.lanes[lane];
+        }
+
+        return result;
+    }
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::add(const Vector& lhs, const Vector& rhs) {
+        Vector result;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            result.lanes[lane] = lhs.lanes[lane] + rhs.lanes[lane];
+        }
+
+        return result;
+    }
+
+    template <size_t Lanes>
+    inline typename detail::BitPackScalar<Lanes>::Vector detail::BitPackScalar<Lanes>::subtract(const Vector& lhs, const Vector& rhs) {
+        Vector result;
+
+        for(size_t lane = 0; lane < Lanes; ++lane) {
+            result.lanes[lane] = lhs.lanes[lane] - rhs.lanes[lane];
+        }
+
+        return result;
+    }
+
+#if defined(__SSE2__) && ! defined(BITTER_BIG_ENDIAN)
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::loadValues(const uint32_t* const source) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    }
+
+    inline void detail::BitPackSse2::storeValues(uint32_t* const target, const Vector vector) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), vector);
+    }
+
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::loadPacked(const uint8_t* const source) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    }
+
+    inline void detail::BitPackSse2::storePacked(uint8_t* const target, const Vector vector) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), vector);
+    }
+
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::broadcast(const uint32_t value) {
+        return _mm_set1_epi32(static_cast<int>(value));
+    }
+
+    template <size_t Count>
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::shiftLeft(const Vector vector) {
+        return _mm_slli_epi32(vector, Count);
+    }
+
+    template <size_t Count>
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::shiftRight(const Vector vector) {
+        return _mm_srli_epi32(vector, Count);
+    }
+
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::bitAnd(const Vector lhs, const Vector rhs) {
+        return _mm_and_si128(lhs, rhs);
+    }
+
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::bitOr(const Vector lhs, const Vector rhs) {
+        return _mm_or_si128(lhs, rhs);
+    }
+
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::add(const Vector lhs, const Vector rhs) {
+        return _mm_add_epi32(lhs, rhs);
+    }
+
+    inline detail::BitPackSse2::Vector detail::BitPackSse2::subtract(const Vector lhs, const Vector rhs) {
+        return _mm_sub_epi32(lhs, rhs);
+    }
+#endif
+
+#if defined(__AVX2__) && ! defined(BITTER_BIG_ENDIAN)
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::loadValues(const uint32_t* const source) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+    }
+
+    inline void detail::BitPackAvx2::storeValues(uint32_t* const target, const Vector vector) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), vector);
+    }
+
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::loadPacked(const uint8_t* const source) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+    }
+
+    inline void detail::BitPackAvx2::storePacked(uint8_t* const target, const Vector vector) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), vector);
+    }
+
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::broadcast(const uint32_t value) {
+        return _mm256_set1_epi32(static_cast<int>(value));
+    }
+
+    template <size_t Count>
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::shiftLeft(const Vector vector) {
+        return _mm256_slli_epi32(vector, Count);
+    }
+
+    template <size_t Count>
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::shiftRight(const Vector vector) {
+        return _mm256_srli_epi32(vector, Count);
+    }
+
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::bitAnd(const Vector lhs, const Vector rhs) {
+        return _mm256_and_si256(lhs, rhs);
+    }
+
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::bitOr(const Vector lhs, const Vector rhs) {
+        return _mm256_or_si256(lhs, rhs);
+    }
+
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::add(const Vector lhs, const Vector rhs) {
+        return _mm256_add_epi32(lhs, rhs);
+    }
+
+    inline detail::BitPackAvx2::Vector detail::BitPackAvx2::subtract(const Vector lhs, const Vector rhs) {
+        return _mm256_sub_epi32(lhs, rhs);
+    }
+#endif
+
+    template <typename Simd, size_t Width, size_t Index, bool SpansWords>
+    inline void detail::BitPackStep<Simd, Width, Index, SpansWords>::pack(const uint32_t* const source, const Vector& reference, const Vector& mask, Vector& word, uint8_t* const target) {
+        constexpr size_t wordNumber = (Index * Width) / 32;
+        constexpr size_t shift = (Index * Width) % 32;
+
+        const Vector value = Simd::bitAnd(Simd::subtract(Simd::loadValues(source + (Index * Simd::laneCount)), reference), mask);
+        word = Simd::bitOr(word, Simd::template shiftLeft<shift>(value));
+
+        if(shift + Width == 32) {
+            Simd::storePacked(target + (wordNumber * Simd::laneCount * 4), word);
+            word = Simd::broadcast(0);
+        }
+    }
+
+    template <typename Simd, size_t Width, size_t Index, bool SpansWords>
+    inline void detail::BitPackStep<Simd, Width, Index, SpansWords>::unpack(const uint8_t* const source, const Vector& reference, const Vector& mask, uint32_t* const target) {
+        constexpr size_t wordNumber = (Index * Width) / 32;
+        constexpr size_t shift = (Index * Width) % 32;
+
+        const Vector word = Simd::loadPacked(source + (wordNumber * Simd::laneCount * 4));
+        const Vector value = Simd::bitAnd(Simd::template shiftRight<shift>(word), mask);
+
+        Simd::storeValues(target + (Index * Simd::laneCount), Simd::add(value, reference));
+    }
+
+    template <typename Simd, size_t Width, size_t Index>
+    inline void detail::BitPackStep<Simd, Width, Index, true>::pack(const uint32_t* const source, const Vector& reference, const Vector& mask, Vector& word, uint8_t* const target) {
+        // a value spanning two words never starts at bit 0 of one, so no shift here is by 32
+        constexpr size_t wordNumber = (Index * Width) / 32;
+        constexpr size_t shift = (Index * Width) % 32;
+
+        const Vector value = Simd::bitAnd(Simd::subtract(Simd::loadValues(source + (Index * Simd::laneCount)), reference), mask);
+
+        Simd::storePacked(target + (wordNumber * Simd::laneCount * 4), Simd::bitOr(word, Simd::template shiftLeft<shift>(value)));
+        word = Simd::template shiftRight<32 - shift>(value);
+    }
+
+    template <typename Simd, size_t Width, size_t Index>
+    inline void detail::BitPackStep<Simd, Width, Index, true>::unpack(const uint8_t* const source, const Vector& reference, const Vector& mask, uint32_t* const target) {
+        constexpr size_t wordNumber = (Index * Width) / 32;
+        constexpr size_t shift = (Index * Width) % 32;
+
+        const uint8_t* const words = source + (wordNumber * Simd::laneCount * 4);
+
+        const Vector low = Simd::template shiftRight<shift>(Simd::loadPacked(words));
+        const Vector high = Simd::template shiftLeft<32 - shift>(Simd::loadPacked(words + (Simd::laneCount * 4)));
+
+        Simd::storeValues(target + (Index * Simd::laneCount), Simd::add(Simd::bitAnd(Simd::bitOr(low, high), mask), reference));
+    }
+
+    template <typename Simd, size_t Width>
+    inline void detail::BitPackKernel<Simd, Width>::pack(const uint32_t* const source, const uint32_t reference, uint8_t* const target) {
+        packSteps(source, reference, target, std::make_index_sequence<32>());
+    }
+
+    template <typename Simd, size_t Width>
+    inline void detail::BitPackKernel<Simd, Width>::unpack(const uint8_t* const source, const uint32_t reference, uint32_t* const target) {
+        unpackSteps(source, reference, target, std::make_index_sequence<32>());
+    }
+
+    template <typename Simd, size_t Width>
+    template <size_t... Indices>
+    inline void detail::BitPackKernel<Simd, Width>::packSteps(const uint32_t* const source, const uint32_t reference, uint8_t* const target, std::index_sequence<Indices...>) {
+        const typename Simd::Vector referenceVector = Simd::broadcast(reference);
+        const typename Simd::Vector mask = Simd::broadcast(static_cast<uint32_t>(lowBitMask(Width)));
+
+        typename Simd::Vector word = Simd::broadcast(0);
+
+        // a braced list runs the steps in order, which the word being filled relies on
+        (void) std::initializer_list<int> { (BitPackStep<Simd, Width, Indices>::pack(source, referenceVector, mask, word, target), 0)... };
+    }
+
+    template <typename Simd, size_t Width>
+    template <size_t... Indices>
+    inline void detail::BitPackKernel<Simd, Width>::unpackSteps(const uint8_t* const source, const uint32_t reference, uint32_t* const target, std::index_sequence<Indices...>) {
+        const typename Simd::Vector referenceVector = Simd::broadcast(reference);
+        const typename Simd::Vector mask = Simd::broadcast(static_cast<uint32_t>(lowBitMask(Width)));
+
+        (void) std::initializer_list<int> { (BitPackStep<Simd, Width, Indices>::unpack(source, referenceVector, mask, target), 0)... };
+    }
+
+    template <typename Simd>
+    inline void detail::BitPackKernel<Simd, 0>::pack(const uint32_t* const, const uint32_t, uint8_t* const) {
+    }
+
+    template <typename Simd>
+    inline void detail::BitPackKernel<Simd, 0>::unpack(const uint8_t* const, const uint32_t reference, uint32_t* const target) {
+        const typename Simd::Vector referenceVector = Simd::broadcast(reference);
+
+        for(size_t i = 0; i < 32; ++i) {
+            Simd::storeValues(target + (i * Simd::laneCount), referenceVector);
+        }
+    }
+
+    template <typename Simd, size_t... Widths>
+    inline void detail::bitPack(const uint32_t* const source, const size_t bitWidth, uint8_t* const target, const uint32_t reference, std::index_sequence<Widths...>) {
+        using Function = void (*)(const uint32_t*, uint32_t, uint8_t*);
+        static constexpr Function kernels[] = { &BitPackKernel<Simd, Widths>::pack... };
+
+        kernels[bitWidth](source, reference, target);
+    }
+
+    template <typename Simd, size_t... Widths>
+    inline void detail::bitUnpack(const uint8_t* const source, const size_t bitWidth, uint32_t* const target, const uint32_t reference, std::index_sequence<Widths...>) {
+        using Function = void (*)(const uint8_t*, uint32_t, uint32_t*);
+        static constexpr Function kernels[] = { &BitPackKernel<Simd, Widths>::unpack... };
+
+        kernels[bitWidth](source, reference, target);
+    }
+
+    template <size_t BlockSize>
+    constexpr size_t BitPack<BlockSize>::blockSize;
+
+    template <size_t BlockSize>
+    constexpr size_t BitPack<BlockSize>::headerBytes;
+
+    template <size_t BlockSize>
+    inline constexpr size_t BitPack<BlockSize>::packedBytes(const size_t bitWidth) {
+        return (BlockSize * bitWidth) / 8;
+    }
+
+    template <size_t BlockSize>
+    inline size_t BitPack<BlockSize>::bitWidth(const uint32_t* const source, const uint32_t reference) {
+        uint32_t bits = 0;
+
+        for(size_t i = 0; i < BlockSize; ++i) {
+            bits |= source[i] - reference;
+        }
+
+        return bits == 0 ? 0 : static_cast<size_t>(64 - detail::countLeadingZeros(bits));
+    }
+
+    template <size_t BlockSize>
+    inline void BitPack<BlockSize>::pack(const uint32_t* const source, const size_t bitWidth, uint8_t* const target, const uint32_t reference) {
+        detail::bitPack<Simd>(source, bitWidth, target, reference, std::make_index_sequence<33>());
+    }
+
+    template <size_t BlockSize>
+    inline void BitPack<BlockSize>::unpack(const uint8_t* const source, const size_t bitWidth, uint32_t* const target, const uint32_t reference) {
+        detail::bitUnpack<Simd>(source, bitWidth, target, reference, std::make_index_sequence<33>());
+    }
+
+    template <size_t BlockSize>
+    inline size_t BitPack<BlockSize>::encodeBlock(const uint32_t* const source, std::vector<uint8_t>& target) {
+        const uint32_t reference = *std::min_element(source, source + BlockSize);
+
+        // how many values need each bit length
+        size_t lengthCounts[33] = { };
+        for(size_t i = 0; i < BlockSize; ++i) {
+            const uint32_t value = source[i] - reference;
+            ++lengthCounts[value == 0 ? 0 : 64 - detail::countLeadingZeros(value)];
+        }
+
+        size_t maxWidth = 32;
+        while(maxWidth > 0 && lengthCounts[maxWidth] == 0) {
+            --maxWidth;
+        }
+
+        // narrowing the width by one bit turns the values of that length into exceptions,
+        // which cost a position byte and their high bits each; at most 255 fit the count byte
+        size_t bestWidth = maxWidth;
+        size_t bestBits = BlockSize * maxWidth;
+        size_t exceptionCount = 0;
+
+        for(size_t width = maxWidth; width-- > 0;) {
+            exceptionCount += lengthCounts[width + 1];
+
+            if(exceptionCount > 255) {
+                break;
+            }
+
+            const size_t bits = (BlockSize * width) + (exceptionCount * (8 + maxWidth - width));
+            if(bits < bestBits) {
+                bestWidth = width;
+                bestBits = bits;
+            }
+        }
+
+        std::vector<uint8_t> positions;
+        for(size_t i = 0; i < BlockSize; ++i) {
+            if(bestWidth < 32 && ((source[i] - reference) >> bestWidth) != 0) {
+                positions.push_back(static_cast<uint8_t>(i));
+            }
+        }
+
+        const size_t exceptionWidth = positions.empty() ? 0 : maxWidth - bestWidth;
+        const size_t exceptionBytes = ((positions.size() * exceptionWidth) + 7) / 8;
+        const size_t blockBytes = headerBytes + packedBytes(bestWidth) + positions.size() + exceptionBytes;
+
+        const size_t start = target.size();
+        target.resize(start + blockBytes, 0);
+        uint8_t* const block = target.data() + start;
+
+        detail::storeLittleEndian32(block, reference);
+        block[4] = static_cast<uint8_t>(bestWidth);
+        block[5] = static_cast<uint8_t>(positions.size());
+        block[6] = static_cast<uint8_t>(exceptionWidth);
+
+        pack(source, bestWidth, block + headerBytes, reference);
+
+        uint8_t* const exceptions = block + headerBytes + packedBytes(bestWidth);
+        std::copy(positions.begin(), positions.end(), exceptions);
+
+        for(size_t i = 0; i < positions.size(); ++i) {
+            setBits(exceptions + positions.size(), i * exceptionWidth, exceptionWidth, (source[positions[i]] - reference) >> bestWidth);
+        }
+
+        return blockBytes;
+    }
+
+    template <size_t BlockSize>
+    inline size_t BitPack<BlockSize>::decodeBlock(const uint8_t* const source, const size_t sourceSize, uint32_t* const target) {
+        if(sourceSize < headerBytes) {
+            return 0;
+        }
+
+        const uint32_t reference = detail::loadLittleEndian32(source);
+        const size_t width = source[4];
+        const size_t exceptionCount = source[5];
+        const size_t exceptionWidth = source[6];
+
+        if(width + exceptionWidth > 32 || (exceptionCount != 0 && exceptionWidth == 0)) {
+            return 0;
+        }
+
+        const size_t exceptionBytes = ((exceptionCount * exceptionWidth) + 7) / 8;
+        const size_t blockBytes = headerBytes + packedBytes(width) + exceptionCount + exceptionBytes;
+
+        if(blockBytes > sourceSize) {
+            return 0;
+        }
+
+        unpack(source + headerBytes, width, target, reference);
+
+        const uint8_t* const positions = source + headerBytes + packedBytes(width);
+
+        // the reference is already added to the low bits, so the high bits are added on top
+        for(size_t i = 0; i < exceptionCount; ++i) {
+            if(positions[i] >= BlockSize) {
+                return 0;
+            }
+
+            target[positions[i]] += static_cast<uint32_t>(getBits(positions + exceptionCount, i * exceptionWidth, exceptionWidth) << width);
+        }
+
+        return blockBytes;
+    }
+
+    template <size_t BlockSize>
+    inline std::vector<uint8_t> BitPack<BlockSize>::encode(const uint32_t* const source, const size_t count) {
+        std::vector<uint8_t> encoded;
+
+        size_t i = 0;
+        for(; i + BlockSize <= count; i += BlockSize) {
+            encodeBlock(source + i, encoded);
+        }
+
+        if(i < count) {
+            // copies of a value already in the block change neither its reference nor its width
+            uint32_t block[BlockSize];
+            std::fill(std::copy(source + i, source + count, block), block + BlockSize, source[i]);
+
+            encodeBlock(block, encoded);
+        }
+
+        return encoded;
+    }
+
+    template <size_t BlockSize>
+    inline bool BitPack<BlockSize>::decode(const uint8_t* const source, const size_t sourceSize, uint32_t* const target, const size_t count) {
+        size_t position = 0;
+
+        size_t i = 0;
+        for(; i + BlockSize <= count; i += BlockSize) {
+            const size_t blockBytes = decodeBlock(source + position, sourceSize - position, target + i);
+
+            if(blockBytes == 0) {
+                return false;
+            }
+
+            position += blockBytes;
+        }
+
+        if(i < count) {
+            uint32_t block[BlockSize];
+            const size_t blockBytes = decodeBlock(source + position, sourceSize - position, block);
+
+            if(blockBytes == 0) {
+                return false;
+            }
+
+            std::copy(block, block + (count - i), target + i);
+            position += blockBytes;
+        }
+
+        return position == sourceSize;
+    }
+}
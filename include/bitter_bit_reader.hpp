@@ -0,0 +1,355 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_bit.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Reads consecutive bits from a buffer, keeping up to 64 of them in a register
+    //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0xF0, 0x0F };
+    //!     BitReader reader(data, sizeof(data));
+    //!     const auto x = reader.read(4); // returns 0x0
+    //!     const auto y = reader.read(8); // returns 0xFF
+    //!
+    //!     MsbBitReader msbReader(data, sizeof(data));
+    //!     const auto z = msbReader.read(12); // returns 0xF00
+    //! \endcode
+    //!
+    //! \note  bits are numbered the same way as #getBit numbers them for the same \p Order,
+    //!        and a value read with BitOrder::MsbFirst has its first bit as its most significant
+    //!
+    //! \note  with BitOrder::MsbFirst the register is refilled with byte-swapped word loads,
+    //!        so big-endian bitstreams are read as quickly as little-endian ones
+    //!
+    //! \note  reading past the end of the buffer yields zero bits,
+    //!        use bitsRemaining() to find out if that has happened
+    //!
+    //! \warning  the reader does not copy the buffer,
+    //!           so make sure it outlives the reader!
+    //!
+    //! \see  #getBits
+    //! \see  #BitReader
+    //! \see  #MsbBitReader
+    //!
+    template <BitOrder Order>
+    class BasicBitReader {
+    public:
+        //!
+        //! \brief  The largest number of bits that can be peeked at once
+        //!
+        static constexpr size_t maxPeekBits = 56;
+
+        //!
+        //! \brief  Creates a BitReader positioned at the first bit of a buffer
+        //!
+        //! \tparam  T  the type the source pointer points to,
+        //!             should be inferred from the parameter,
+        //!             do not set this explicitly
+        //!
+        //! \param[in]  source       where to read from
+        //! \param[in]  sizeInBytes  how many bytes can be read from \p source
+        //!
+        template <typename T>
+        BasicBitReader(const T* source, size_t sizeInBytes);
+
+        //!
+        //! \brief  Reads bits and moves past them
+        //!
+        //! \param[in]  bitCount  how many bits to read, in the range [0, 64]
+        //!
+        //! \returns  the bits, where the first bit read becomes bit 0 of the result
+        //!           for BitOrder::LsbFirst, or bit (\p bitCount - 1) for BitOrder::MsbFirst
+        //!
+        uint64_t read(size_t bitCount);
+
+        //!
+        //! \brief  Reads a single bit and moves past it
+        //!
+        //! \returns  #Bit::One if the bit is set,
+        //!           #Bit::Zero if it is not.
+        //!
+        Bit readBit();
+
+        //!
+        //! \brief  Counts the zero bits up to the next set bit and moves past them and the set bit
+        //!
+        //! \returns  how many zero bits came before the set bit, there is no upper limit
+        //!
+        //! \note  the zero bits are counted a register at a time with a single
+        //!        count leading (BitOrder::MsbFirst) or trailing (BitOrder::LsbFirst) zeros instruction
+        //!
+        //! \note  if the buffer ends before a set bit, the zero bits up to the end are counted
+        //!        and the reader moves one bit past the end
+        //!
+        size_t readUnary();
+
+        //!
+        //! \brief  Reads bits without moving past them
+        //!
+        //! \param[in]  bitCount  how many bits to read, in the range [0, #maxPeekBits]
+        //!
+        //! \returns  the bits, in the same order as read() returns them
+        //!
+        uint64_t peek(size_t bitCount);
+
+        //!
+        //! \brief  Moves past bits without reading them
+        //!
+        //! \param[in]  bitCount  how many bits to skip, there is no upper limit
+        //!
+        void skip(size_t bitCount);
+
+        //!
+        //! \brief  Moves to an absolute bit position
+        //!
+        //! \param[in]  bitNumber  the bit to move to (zero-indexed)
+        //!
+        void seek(size_t bitNumber);
+
+        //!
+        //! \brief  Skips to the start of the next byte, unless already at the start of one
+        //!
+        void alignToByte();
+
+        //!
+        //! \returns  how many bits have been read or skipped so far
+        //!
+        size_t position() const;
+
+        //!
+        //! \returns  how many bits are left before the end of the buffer,
+        //!           or zero if the reader has moved past the end
+        //!
+        size_t bitsRemaining() const;
+
+    private:
+        void refill();
+        void consume(size_t bitCount);
+
+        const uint8_t* m_source;
+        size_t m_sizeInBytes;
+
+        // the next byte that hasn't been loaded into m_buffer yet
+        size_t m_nextByte = 0;
+
+        // the next unread bit is bit 0 of m_buffer for BitOrder::LsbFirst, or bit 63 for BitOrder::MsbFirst
+        uint64_t m_buffer = 0;
+        size_t m_bufferedBits = 0;
+
+        // how far the reader has moved beyond the end of the buffer
+        size_t m_bitsPastEnd = 0;
+    };
+
+    //!
+    //! \brief  Reads bits numbered the same way as #getBit numbers them by default
+    //!
+    using BitReader = BasicBitReader<BitOrder::LsbFirst>;
+
+    //!
+    //! \brief  Reads bits from a big-endian bitstream, the first bit being the most significant bit of the first byte
+    //!
+    using MsbBitReader = BasicBitReader<BitOrder::MsbFirst>;
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    template <BitOrder Order>
+    constexpr size_t BasicBitReader<Order>::maxPeekBits;
+
+    template <BitOrder Order>
+    template <typename T>
+    inline BasicBitReader<Order>::BasicBitReader(const T* const source, const size_t sizeInBytes)
+    : m_source(detail::asBytes(source)),
+      m_sizeInBytes(sizeInBytes) {
+
+    }
+
+    template <BitOrder Order>
+    inline uint64_t BasicBitReader<Order>::read(const size_t bitCount) {
+        if(bitCount > maxPeekBits) {
+            const uint64_t first = read(32);
+            const uint64_t rest = read(bitCount - 32);
+
+            return Order == BitOrder::MsbFirst ? ((first << (bitCount - 32)) | rest) : (first | (rest << 32));
+        }
+
+        const uint64_t value = peek(bitCount);
+        consume(bitCount);
+        return value;
+    }
+
+    template <BitOrder Order>
+    inline Bit BasicBitReader<Order>::readBit() {
+        return read(1) ? Bit::One : Bit::Zero;
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicBitReader<Order>::readUnary() {
+        size_t zeros = 0;
+
+        for(;;) {
+            refill();
+
+            if(m_buffer != 0) {
+                const size_t bitNumber = static_cast<size_t>(Order == BitOrder::MsbFirst
+                                                                 ? detail::countLeadingZeros(m_buffer)
+                                                                 : detail::countTrailingZeros(m_buffer));
+
+                // bits beyond m_bufferedBits may be set, but they have not been accounted for yet
+                if(bitNumber < m_bufferedBits) {
+                    consume(bitNumber + 1);
+                    return zeros + bitNumber;
+                }
+            }
+
+            if(m_bufferedBits == 0) {
+                consume(1);
+                return zeros;
+            }
+
+            zeros += m_bufferedBits;
+            consume(m_bufferedBits);
+        }
+    }
+
+    template <BitOrder Order>
+    inline uint64_t BasicBitReader<Order>::peek(const size_t bitCount) {
+        if(m_bufferedBits < bitCount) {
+            refill();
+        }
+
+        if(Order == BitOrder::MsbFirst) {
+            return bitCount != 0 ? (m_buffer >> (64 - bitCount)) : 0;
+        }
+
+        return m_buffer & detail::lowBitMask(bitCount);
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitReader<Order>::skip(const size_t bitCount) {
+        if(bitCount <= m_bufferedBits) {
+            consume(bitCount);
+        } else {
+            seek(position() + bitCount);
+        }
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitReader<Order>::seek(const size_t bitNumber) {
+        const size_t totalBits = m_sizeInBytes * 8;
+
+        m_buffer = 0;
+        m_bufferedBits = 0;
+
+        if(bitNumber > totalBits) {
+            m_nextByte = m_sizeInBytes;
+            m_bitsPastEnd = bitNumber - totalBits;
+            return;
+        }
+
+        m_nextByte = bitNumber / 8;
+        m_bitsPastEnd = 0;
+
+        refill();
+        consume(bitNumber % 8);
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitReader<Order>::alignToByte() {
+        skip((8 - (position() % 8)) % 8);
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicBitReader<Order>::position() const {
+        return (m_nextByte * 8) - m_bufferedBits + m_bitsPastEnd;
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicBitReader<Order>::bitsRemaining() const {
+        const size_t totalBits = m_sizeInBytes * 8;
+        const size_t currentPosition = position();
+
+        return currentPosition < totalBits ? totalBits - currentPosition : 0;
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitReader<Order>::refill() {
+        if(m_nextByte + 8 <= m_sizeInBytes) {
+            // Load a whole word and keep as many of its bytes as fit.
+            // Any bits of a partially fitting byte end up beyond m_bufferedBits,
+            // but they are the correct next bits, so the next refill ORs in the same values.
+            if(Order == BitOrder::MsbFirst) {
+                m_buffer |= detail::loadBigEndian64(m_source + m_nextByte) >> m_bufferedBits;
+            } else {
+                m_buffer |= detail::loadLittleEndian64(m_source + m_nextByte) << m_bufferedBits;
+            }
+
+            m_nextByte += (63 - m_bufferedBits) / 8;
+            m_bufferedBits |= 56;
+        } else {
+            // near the end of the buffer, so go a byte at a time to avoid reading past it
+            while(m_bufferedBits <= 56 && m_nextByte < m_sizeInBytes) {
+                if(Order == BitOrder::MsbFirst) {
+                    m_buffer |= static_cast<uint64_t>(m_source[m_nextByte]) << (56 - m_bufferedBits);
+                } else {
+                    m_buffer |= static_cast<uint64_t>(m_source[m_nextByte]) << m_bufferedBits;
+                }
+
+                m_bufferedBits += 8;
+                ++m_nextByte;
+            }
+        }
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitReader<Order>::consume(const size_t bitCount) {
+        if(bitCount <= m_bufferedBits) {
+            // shifting a 64-bit value by 64 is undefined, so that case is handled separately
+            if(bitCount >= 64) {
+                m_buffer = 0;
+            } else if(Order == BitOrder::MsbFirst) {
+                m_buffer <<= bitCount;
+            } else {
+                m_buffer >>= bitCount;
+            }
+
+            m_bufferedBits -= bitCount;
+        } else {
+            m_bitsPastEnd += bitCount - m_bufferedBits;
+            m_buffer = 0;
+            m_bufferedBits = 0;
+        }
+    }
+}
@@ -0,0 +1,682 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include <bitter_bit.hpp>
+#include <bitter_bitwise.hpp>
+#include <bitter_count.hpp>
+#include <bitter_find.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    namespace detail {
+        //!
+        //! \brief  A random access iterator over the bits of a #BitVector
+        //!
+        //! \tparam  Vector     BitVector, or const BitVector for a const_iterator
+        //! \tparam  Reference  what dereferencing yields, BitVector::reference or Bit
+        //!
+        template <typename Vector, typename Reference>
+        class BitVectorIterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Bit;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Reference;
+
+            BitVectorIterator() = default;
+            BitVectorIterator(Vector* vector, size_t bitNumber);
+
+            //!
+            //! \brief  Turns an iterator into a const_iterator
+            //!
+            template <typename OtherVector, typename OtherReference,
+                      typename = typename std::enable_if<std::is_convertible<OtherVector*, Vector*>::value>::type>
+            BitVectorIterator(const BitVectorIterator<OtherVector, OtherReference>& other);
+
+            reference operator*() const;
+            reference operator[](difference_type offset) const;
+
+            BitVectorIterator& operator++();
+            BitVectorIterator operator++(int);
+            BitVectorIterator& operator--();
+            BitVectorIterator operator--(int);
+
+            BitVectorIterator& operator+=(difference_type offset);
+            BitVectorIterator& operator-=(difference_type offset);
+            BitVectorIterator operator+(difference_type offset) const;
+            BitVectorIterator operator-(difference_type offset) const;
+            difference_type operator-(const BitVectorIterator& rhs) const;
+
+            bool operator==(const BitVectorIterator& rhs) const;
+            bool operator!=(const BitVectorIterator& rhs) const;
+            bool operator<(const BitVectorIterator& rhs) const;
+            bool operator>(const BitVectorIterator& rhs) const;
+            bool operator<=(const BitVectorIterator& rhs) const;
+            bool operator>=(const BitVectorIterator& rhs) const;
+
+            //!
+            //! \returns  the vector the iterator points into
+            //!
+            Vector* container() const;
+
+            //!
+            //! \returns  the index of the bit the iterator points to
+            //!
+            size_t bitNumber() const;
+
+        private:
+            Vector* m_vector = nullptr;
+            size_t m_bitNumber = 0;
+        };
+    }
+
+    //!
+    //! \brief  A resizable sequence of bits, stored 64 to a word
+    //!
+    //! \par Example
+    //! \code
+    //!     BitVector bits;
+    //!     bits.push_back(Bit::One);
+    //!     bits.resize(100);
+    //!     bits[70] = Bit::One;
+    //!     const auto x = countOnes(bits.cbegin(), bits.cend());   // returns 2
+    //!     const auto y = findFirstSet(bits.begin() + 1, bits.end()); // points to bit 70
+    //! \endcode
+    //!
+    //! \note  bits are numbered the same way as #getBit numbers them over data(),
+    //!        so the buffer can be handed to any function of the library
+    //!
+    //! \note  #countOnes, #findFirstSet and friends have overloads taking a range of
+    //!        BitVector iterators, and #bitwiseAnd and friends overloads taking vectors;
+    //!        these work a word or vector at a time rather than a bit at a time
+    //!
+    class BitVector {
+    public:
+        //!
+        //! \brief  Stands in for a single bit, as a bit cannot be referenced directly
+        //!
+        class reference {
+        public:
+            reference(BitVector* vector, size_t bitNumber);
+
+            operator Bit() const;
+            reference& operator=(Bit bitValue);
+            reference& operator=(const reference& other);
+
+            //!
+            //! \brief  Inverts the bit
+            //!
+            void flip();
+
+        private:
+            BitVector* m_vector;
+            size_t m_bitNumber;
+        };
+
+        using value_type = Bit;
+        using size_type = size_t;
+        using const_reference = Bit;
+        using iterator = detail::BitVectorIterator<BitVector, reference>;
+        using const_iterator = detail::BitVectorIterator<const BitVector, Bit>;
+
+        //!
+        //! \brief  Creates an empty BitVector
+        //!
+        BitVector() = default;
+
+        //!
+        //! \brief  Creates a BitVector holding \p size copies of a bit
+        //!
+        explicit BitVector(size_t size, Bit bitValue = Bit::Zero);
+
+        //!
+        //! \returns  how many bits there are
+        //!
+        size_t size() const;
+
+        //!
+        //! \returns  true if there are no bits, false otherwise
+        //!
+        bool empty() const;
+
+        //!
+        //! \returns  how many bits fit without allocating
+        //!
+        size_t capacity() const;
+
+        //!
+        //! \brief  Allocates room for at least \p bitCount bits
+        //!
+        void reserve(size_t bitCount);
+
+        //!
+        //! \brief  Removes all bits
+        //!
+        void clear();
+
+        //!
+        //! \brief  Appends a bit
+        //!
+        void push_back(Bit bitValue);
+
+        //!
+        //! \brief  Removes the last bit, there must be one
+        //!
+        void pop_back();
+
+        //!
+        //! \brief  Changes how many bits there are
+        //!
+        //! \param[in]  size      the new number of bits
+        //! \param[in]  bitValue  what any added bits are set to
+        //!
+        void resize(size_t size, Bit bitValue = Bit::Zero);
+
+        reference operator[](size_t bitNumber);
+        Bit operator[](size_t bitNumber) const;
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        //!
+        //! \returns  the words holding the bits, bits after size() in the last word are always clear
+        //!
+        uint64_t* data();
+        const uint64_t* data() const;
+
+        friend bool operator==(const BitVector& lhs, const BitVector& rhs);
+        friend bool operator!=(const BitVector& lhs, const BitVector& rhs);
+
+    private:
+        std::vector<uint64_t> m_words;
+        size_t m_size = 0;
+    };
+
+    //!
+    //! \brief  Counts the set bits in a range of a #BitVector
+    //!
+    //! \returns  the number of bits in [\p first, \p last) that are #Bit::One
+    //!
+    //! \see  #countOnes
+    //!
+    template <typename Vector, typename Reference>
+    inline size_t countOnes(detail::BitVectorIterator<Vector, Reference> first, detail::BitVectorIterator<Vector, Reference> last);
+
+    //!
+    //! \brief  Finds the first set bit in a range of a #BitVector
+    //!
+    //! \returns  an iterator to the bit, or \p last if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findFirstSet(detail::BitVectorIterator<Vector, Reference> first, detail::BitVectorIterator<Vector, Reference> last);
+
+    //!
+    //! \brief  Finds the first clear bit in a range of a #BitVector
+    //!
+    //! \returns  an iterator to the bit, or \p last if there is none
+    //!
+    //! \see  #findFirstClear
+    //!
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findFirstClear(detail::BitVectorIterator<Vector, Reference> first, detail::BitVectorIterator<Vector, Reference> last);
+
+    //!
+    //! \brief  Finds the last set bit in a range of a #BitVector
+    //!
+    //! \returns  an iterator to the bit, or \p last if there is none
+    //!
+    //! \see  #findLastSet
+    //!
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findLastSet(detail::BitVectorIterator<Vector, Reference> first, detail::BitVectorIterator<Vector, Reference> last);
+
+    //!
+    //! \brief  Finds the last clear bit in a range of a #BitVector
+    //!
+    //! \returns  an iterator to the bit, or \p last if there is none
+    //!
+    //! \see  #findLastClear
+    //!
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findLastClear(detail::BitVectorIterator<Vector, Reference> first, detail::BitVectorIterator<Vector, Reference> last);
+
+    //!
+    //! \brief  Sets the target to the AND of two vectors
+    //!
+    //! \param[out]  target  resized to the size of \p a
+    //! \param[in]   a       the first operand
+    //! \param[in]   b       the second operand, at least as long as \p a
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseAnd(BitVector& target, const BitVector& a, const BitVector& b);
+
+    //!
+    //! \brief  Sets the target to the OR of two vectors
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseOr(BitVector& target, const BitVector& a, const BitVector& b);
+
+    //!
+    //! \brief  Sets the target to the XOR of two vectors
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseXor(BitVector& target, const BitVector& a, const BitVector& b);
+
+    //!
+    //! \brief  Sets the target to \p a AND NOT \p b
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseAndNot(BitVector& target, const BitVector& a, const BitVector& b);
+
+    //!
+    //! \brief  ANDs a vector into the target
+    //!
+    //! \param[in,out]  target  the first operand and where to write to
+    //! \param[in]      source  the second operand, at least as long as \p target
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseAnd(BitVector& target, const BitVector& source);
+
+    //!
+    //! \brief  ORs a vector into the target
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseOr(BitVector& target, const BitVector& source);
+
+    //!
+    //! \brief  XORs a vector into the target
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseXor(BitVector& target, const BitVector& source);
+
+    //!
+    //! \brief  Clears the bits of the target that are set in a vector
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    inline void bitwiseAndNot(BitVector& target, const BitVector& source);
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    namespace detail {
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference>::BitVectorIterator(Vector* const vector, const size_t bitNumber)
+        : m_vector(vector),
+          m_bitNumber(bitNumber) {
+
+        }
+
+        template <typename Vector, typename Reference>
+        template <typename OtherVector, typename OtherReference, typename>
+        inline BitVectorIterator<Vector, Reference>::BitVectorIterator(const BitVectorIterator<OtherVector, OtherReference>& other)
+        : m_vector(other.container()),
+          m_bitNumber(other.bitNumber()) {
+
+        }
+
+        template <typename Vector, typename Reference>
+        inline Reference BitVectorIterator<Vector, Reference>::operator*() const {
+            return (*m_vector)[m_bitNumber];
+        }
+
+        template <typename Vector, typename Reference>
+        inline Reference BitVectorIterator<Vector, Reference>::operator[](const difference_type offset) const {
+            return (*m_vector)[m_bitNumber + offset];
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference>& BitVectorIterator<Vector, Reference>::operator++() {
+            ++m_bitNumber;
+            return *this;
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference> BitVectorIterator<Vector, Reference>::operator++(int) {
+            BitVectorIterator previous = *this;
+            ++m_bitNumber;
+            return previous;
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference>& BitVectorIterator<Vector, Reference>::operator--() {
+            --m_bitNumber;
+            return *this;
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference> BitVectorIterator<Vector, Reference>::operator--(int) {
+            BitVectorIterator previous = *this;
+            --m_bitNumber;
+            return previous;
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference>& BitVectorIterator<Vector, Reference>::operator+=(const difference_type offset) {
+            m_bitNumber += offset;
+            return *this;
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference>& BitVectorIterator<Vector, Reference>::operator-=(const difference_type offset) {
+            m_bitNumber -= offset;
+            return *this;
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference> BitVectorIterator<Vector, Reference>::operator+(const difference_type offset) const {
+            return BitVectorIterator(m_vector, m_bitNumber + offset);
+        }
+
+        template <typename Vector, typename Reference>
+        inline BitVectorIterator<Vector, Reference> BitVectorIterator<Vector, Reference>::operator-(const difference_type offset) const {
+            return BitVectorIterator(m_vector, m_bitNumber - offset);
+        }
+
+        template <typename Vector, typename Reference>
+        inline std::ptrdiff_t BitVectorIterator<Vector, Reference>::operator-(const BitVectorIterator& rhs) const {
+            return static_cast<std::ptrdiff_t>(m_bitNumber) - static_cast<std::ptrdiff_t>(rhs.m_bitNumber);
+        }
+
+        template <typename Vector, typename Reference>
+        inline bool BitVectorIterator<Vector, Reference>::operator==(const BitVectorIterator& rhs) const {
+            return m_bitNumber == rhs.m_bitNumber && m_vector == rhs.m_vector;
+        }
+
+        template <typename Vector, typename Reference>
+        inline bool BitVectorIterator<Vector, Reference>::operator!=(const BitVectorIterator& rhs) const {
+            return ! (*this == rhs);
+        }
+
+        template <typename Vector, typename Reference>
+        inline bool BitVectorIterator<Vector, Reference>::operator<(const BitVectorIterator& rhs) const {
+            return m_bitNumber < rhs.m_bitNumber;
+        }
+
+        template <typename Vector, typename Reference>
+        inline bool BitVectorIterator<Vector, Reference>::operator>(const BitVectorIterator& rhs) const {
+            return m_bitNumber > rhs.m_bitNumber;
+        }
+
+        template <typename Vector, typename Reference>
+        inline bool BitVectorIterator<Vector, Reference>::operator<=(const BitVectorIterator& rhs) const {
+            return m_bitNumber <= rhs.m_bitNumber;
+        }
+
+        template <typename Vector, typename Reference>
+        inline bool BitVectorIterator<Vector, Reference>::operator>=(const BitVectorIterator& rhs) const {
+            return m_bitNumber >= rhs.m_bitNumber;
+        }
+
+        template <typename Vector, typename Reference>
+        inline Vector* BitVectorIterator<Vector, Reference>::container() const {
+            return m_vector;
+        }
+
+        template <typename Vector, typename Reference>
+        inline size_t BitVectorIterator<Vector, Reference>::bitNumber() const {
+            return m_bitNumber;
+        }
+    }
+
+    inline BitVector::reference::reference(BitVector* const vector, const size_t bitNumber)
+    : m_vector(vector),
+      m_bitNumber(bitNumber) {
+
+    }
+
+    inline BitVector::reference::operator Bit() const {
+        return getBit(m_vector->data(), m_bitNumber);
+    }
+
+    inline BitVector::reference& BitVector::reference::operator=(const Bit bitValue) {
+        setBit(m_vector->data(), m_bitNumber, bitValue);
+        return *this;
+    }
+
+    inline BitVector::reference& BitVector::reference::operator=(const reference& other) {
+        return *this = static_cast<Bit>(other);
+    }
+
+    inline void BitVector::reference::flip() {
+        *this = static_cast<Bit>(*this) == Bit::One ? Bit::Zero : Bit::One;
+    }
+
+    inline BitVector::BitVector(const size_t size, const Bit bitValue) {
+        resize(size, bitValue);
+    }
+
+    inline size_t BitVector::size() const {
+        return m_size;
+    }
+
+    inline bool BitVector::empty() const {
+        return m_size == 0;
+    }
+
+    inline size_t BitVector::capacity() const {
+        return m_words.capacity() * 64;
+    }
+
+    inline void BitVector::reserve(const size_t bitCount) {
+        m_words.reserve((bitCount + 63) / 64);
+    }
+
+    inline void BitVector::clear() {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    inline void BitVector::push_back(const Bit bitValue) {
+        if(m_size % 64 == 0) {
+            m_words.push_back(0);
+        }
+
+        // the bit is clear already
+        if(bitValue == Bit::One) {
+            setBit(m_words.data(), m_size, Bit::One);
+        }
+
+        ++m_size;
+    }
+
+    inline void BitVector::pop_back() {
+        --m_size;
+        setBit(m_words.data(), m_size, Bit::Zero);
+
+        if(m_size % 64 == 0) {
+            m_words.pop_back();
+        }
+    }
+
+    inline void BitVector::resize(const size_t size, const Bit bitValue) {
+        const size_t oldSize = m_size;
+
+        m_words.resize((size + 63) / 64, 0);
+        m_size = size;
+
+        if(size < oldSize) {
+            // keep the bits after the end clear
+            if(size % 64 != 0) {
+                setBits(m_words.data(), size, 64 - (size % 64), 0);
+            }
+        } else if(bitValue == Bit::One) {
+            for(size_t bitNumber = oldSize; bitNumber < size; bitNumber += 64) {
+                setBits(m_words.data(), bitNumber, std::min<size_t>(64, size - bitNumber), ~uint64_t(0));
+            }
+        }
+    }
+
+    inline BitVector::reference BitVector::operator[](const size_t bitNumber) {
+        return reference(this, bitNumber);
+    }
+
+    inline Bit BitVector::operator[](const size_t bitNumber) const {
+        return getBit(m_words.data(), bitNumber);
+    }
+
+    inline BitVector::iterator BitVector::begin() {
+        return iterator(this, 0);
+    }
+
+    inline BitVector::iterator BitVector::end() {
+        return iterator(this, m_size);
+    }
+
+    inline BitVector::const_iterator BitVector::begin() const {
+        return const_iterator(this, 0);
+    }
+
+    inline BitVector::const_iterator BitVector::end() const {
+        return const_iterator(this, m_size);
+    }
+
+    inline BitVector::const_iterator BitVector::cbegin() const {
+        return begin();
+    }
+
+    inline BitVector::const_iterator BitVector::cend() const {
+        return end();
+    }
+
+    inline uint64_t* BitVector::data() {
+        return m_words.data();
+    }
+
+    inline const uint64_t* BitVector::data() const {
+        return m_words.data();
+    }
+
+    inline bool operator==(const BitVector& lhs, const BitVector& rhs) {
+        // the bits after the end are clear, so whole words can be compared
+        return lhs.m_size == rhs.m_size && lhs.m_words == rhs.m_words;
+    }
+
+    inline bool operator!=(const BitVector& lhs, const BitVector& rhs) {
+        return ! (lhs == rhs);
+    }
+
+    template <typename Vector, typename Reference>
+    inline size_t countOnes(const detail::BitVectorIterator<Vector, Reference> first, const detail::BitVectorIterator<Vector, Reference> last) {
+        return countOnes(first.container()->data(), first.bitNumber(), last.bitNumber() - first.bitNumber());
+    }
+
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findFirstSet(const detail::BitVectorIterator<Vector, Reference> first, const detail::BitVectorIterator<Vector, Reference> last) {
+        if(first == last) {
+            return last;
+        }
+
+        return detail::BitVectorIterator<Vector, Reference>(first.container(), findNextSet(first.container()->data(), last.bitNumber(), first.bitNumber()));
+    }
+
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findFirstClear(const detail::BitVectorIterator<Vector, Reference> first, const detail::BitVectorIterator<Vector, Reference> last) {
+        if(first == last) {
+            return last;
+        }
+
+        return detail::BitVectorIterator<Vector, Reference>(first.container(), findNextClear(first.container()->data(), last.bitNumber(), first.bitNumber()));
+    }
+
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findLastSet(const detail::BitVectorIterator<Vector, Reference> first, const detail::BitVectorIterator<Vector, Reference> last) {
+        if(first == last) {
+            return last;
+        }
+
+        const size_t found = findPreviousSet(first.container()->data(), last.bitNumber(), last.bitNumber() - 1);
+        return (found < first.bitNumber() || found == last.bitNumber()) ? last : detail::BitVectorIterator<Vector, Reference>(first.container(), found);
+    }
+
+    template <typename Vector, typename Reference>
+    inline detail::BitVectorIterator<Vector, Reference> findLastClear(const detail::BitVectorIterator<Vector, Reference> first, const detail::BitVectorIterator<Vector, Reference> last) {
+        if(first == last) {
+            return last;
+        }
+
+        const size_t found = findPreviousClear(first.container()->data(), last.bitNumber(), last.bitNumber() - 1);
+        return (found < first.bitNumber() || found == last.bitNumber()) ? last : detail::BitVectorIterator<Vector, Reference>(first.container(), found);
+    }
+
+    inline void bitwiseAnd(BitVector& target, const BitVector& a, const BitVector& b) {
+        target.resize(a.size());
+        bitwiseAnd(target.data(), a.data(), b.data(), a.size());
+    }
+
+    inline void bitwiseOr(BitVector& target, const BitVector& a, const BitVector& b) {
+        target.resize(a.size());
+        bitwiseOr(target.data(), a.data(), b.data(), a.size());
+    }
+
+    inline void bitwiseXor(BitVector& target, const BitVector& a, const BitVector& b) {
+        target.resize(a.size());
+        bitwiseXor(target.data(), a.data(), b.data(), a.size());
+    }
+
+    inline void bitwiseAndNot(BitVector& target, const BitVector& a, const BitVector& b) {
+        target.resize(a.size());
+        bitwiseAndNot(target.data(), a.data(), b.data(), a.size());
+    }
+
+    inline void bitwiseAnd(BitVector& target, const BitVector& source) {
+        bitwiseAnd(target.data(), source.data(), target.size());
+    }
+
+    inline void bitwiseOr(BitVector& target, const BitVector& source) {
+        bitwiseOr(target.data(), source.data(), target.size());
+    }
+
+    inline void bitwiseXor(BitVector& target, const BitVector& source) {
+        bitwiseXor(target.data(), source.data(), target.size());
+    }
+
+    inline void bitwiseAndNot(BitVector& target, const BitVector& source) {
+        bitwiseAndNot(target.data(), source.data(), target.size());
+    }
+}
@@ -0,0 +1,320 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bitter_bit.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Writes consecutive bits to a buffer, collecting up to 64 of them in a register
+    //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
+    //! \par Example
+    //! \code
+    //!     BitWriter writer;
+    //!     writer.write(0x0, 4);
+    //!     writer.write(0xFF, 8);
+    //!     writer.finish();
+    //!     // writer.buffer() now holds { 0xF0, 0x0F }
+    //!
+    //!     MsbBitWriter msbWriter;
+    //!     msbWriter.write(0xF00, 12);
+    //!     msbWriter.finish();
+    //!     // msbWriter.buffer() now holds { 0xF0, 0x00 }
+    //! \endcode
+    //!
+    //! \note  bits are numbered the same way as #setBit numbers them for the same \p Order,
+    //!        and a value written with BitOrder::MsbFirst has its most significant bit written first
+    //!
+    //! \note  whole bytes are written, so any existing contents of a
+    //!        caller-provided buffer are overwritten rather than merged
+    //!
+    //! \see  #BasicBitReader
+    //! \see  #setBits
+    //!
+    template <BitOrder Order>
+    class BasicBitWriter {
+    public:
+        //!
+        //! \brief  Creates a BitWriter that writes to a buffer it owns and grows as needed
+        //!
+        //! \see  buffer()
+        //!
+        BasicBitWriter();
+
+        //!
+        //! \brief  Creates a BitWriter that writes to a caller-provided buffer
+        //!
+        //! \tparam  T  the type the target pointer points to,
+        //!             should be inferred from the parameter,
+        //!             do not set this explicitly
+        //!
+        //! \param[out]  target       where to write to
+        //! \param[in]   sizeInBytes  how many bytes can be written to \p target
+        //!
+        //! \note  bits that do not fit are dropped, see hasOverflowed()
+        //!
+        //! \warning  the writer does not copy the buffer,
+        //!           so make sure it outlives the writer!
+        //!
+        template <typename T>
+        BasicBitWriter(T* target, size_t sizeInBytes);
+
+        BasicBitWriter(const BasicBitWriter&) = delete;
+        BasicBitWriter& operator=(const BasicBitWriter&) = delete;
+
+        BasicBitWriter(BasicBitWriter&&) = default;
+        BasicBitWriter& operator=(BasicBitWriter&&) = default;
+
+        //!
+        //! \brief  Appends bits
+        //!
+        //! \param[in]  value     the bits to append, bit 0 is written first for BitOrder::LsbFirst,
+        //!                       bit (\p bitCount - 1) for BitOrder::MsbFirst;
+        //!                       bits above \p bitCount are ignored
+        //! \param[in]  bitCount  how many bits to append, in the range [0, 64]
+        //!
+        void write(uint64_t value, size_t bitCount);
+
+        //!
+        //! \brief  Appends a single bit
+        //!
+        //! \param[in]  bitValue  the bit to append
+        //!
+        void writeBit(Bit bitValue);
+
+        //!
+        //! \brief  Appends zero bits up to the start of the next byte, unless already at the start of one
+        //!
+        void padToByte();
+
+        //!
+        //! \brief  Pads to the next byte and writes out everything still held in the register
+        //!
+        //! \returns  how many bytes have been written in total
+        //!
+        //! \note  writing may continue afterwards
+        //!
+        size_t finish();
+
+        //!
+        //! \returns  how many bits have been appended so far
+        //!
+        size_t position() const;
+
+        //!
+        //! \returns  true if bits have been dropped because a caller-provided buffer was full
+        //!
+        bool hasOverflowed() const;
+
+        //!
+        //! \returns  the owned buffer, holding exactly the bytes written as of the last finish()
+        //!
+        //! \note  only meaningful for a BitWriter created without a caller-provided buffer
+        //!
+        const std::vector<uint8_t>& buffer() const;
+
+    private:
+        // the register's bytes in the order they are written, the first in the low 8 bits
+        uint64_t registerBytes() const;
+
+        void writeBytes(uint64_t bytes, size_t byteCount);
+        bool makeRoom(size_t byteCount);
+
+        std::vector<uint8_t> m_buffer;
+        bool m_growable;
+
+        uint8_t* m_target;
+        size_t m_capacity;
+
+        // how many bytes have been written to m_target
+        size_t m_byteCount = 0;
+
+        // the next bit is appended at bit m_bitCount of m_bits for BitOrder::LsbFirst,
+        // or bit (63 - m_bitCount) for BitOrder::MsbFirst
+        uint64_t m_bits = 0;
+        size_t m_bitCount = 0;
+
+        bool m_overflowed = false;
+    };
+
+    //!
+    //! \brief  Writes bits numbered the same way as #setBit numbers them by default
+    //!
+    using BitWriter = BasicBitWriter<BitOrder::LsbFirst>;
+
+    //!
+    //! \brief  Writes a big-endian bitstream, the first bit being the most significant bit of the first byte
+    //!
+    using MsbBitWriter = BasicBitWriter<BitOrder::MsbFirst>;
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    template <BitOrder Order>
+    inline BasicBitWriter<Order>::BasicBitWriter()
+    : m_growable(true),
+      m_target(nullptr),
+      m_capacity(0) {
+
+    }
+
+    template <BitOrder Order>
+    template <typename T>
+    inline BasicBitWriter<Order>::BasicBitWriter(T* const target, const size_t sizeInBytes)
+    : m_growable(false),
+      m_target(detail::asBytes(target)),
+      m_capacity(sizeInBytes) {
+
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitWriter<Order>::write(uint64_t value, const size_t bitCount) {
+        if(bitCount == 0) {
+            return;
+        }
+
+        value &= detail::lowBitMask(bitCount);
+
+        if(Order == BitOrder::MsbFirst) {
+            m_bits |= (value << (64 - bitCount)) >> m_bitCount;
+        } else {
+            m_bits |= value << m_bitCount;
+        }
+
+        const size_t totalBits = m_bitCount + bitCount;
+
+        if(totalBits >= 64) {
+            writeBytes(registerBytes(), 8);
+
+            // whatever didn't fit in the flushed word starts the next one
+            const size_t leftoverBits = totalBits - 64;
+
+            if(Order == BitOrder::MsbFirst) {
+                m_bits = leftoverBits ? (value << (64 - leftoverBits)) : 0;
+            } else {
+                m_bits = m_bitCount ? (value >> (64 - m_bitCount)) : 0;
+            }
+
+            m_bitCount = leftoverBits;
+        } else {
+            m_bitCount = totalBits;
+        }
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitWriter<Order>::writeBit(const Bit bitValue) {
+        write(static_cast<uint64_t>(bitValue), 1);
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitWriter<Order>::padToByte() {
+        write(0, (8 - (m_bitCount % 8)) % 8);
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicBitWriter<Order>::finish() {
+        padToByte();
+
+        writeBytes(registerBytes(), m_bitCount / 8);
+
+        m_bits = 0;
+        m_bitCount = 0;
+
+        if(m_growable) {
+            m_buffer.resize(m_byteCount);
+            m_target = m_buffer.data();
+            m_capacity = m_buffer.size();
+        }
+
+        return m_byteCount;
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicBitWriter<Order>::position() const {
+        return (m_byteCount * 8) + m_bitCount;
+    }
+
+    template <BitOrder Order>
+    inline bool BasicBitWriter<Order>::hasOverflowed() const {
+        return m_overflowed;
+    }
+
+    template <BitOrder Order>
+    inline const std::vector<uint8_t>& BasicBitWriter<Order>::buffer() const {
+        return m_buffer;
+    }
+
+    template <BitOrder Order>
+    inline uint64_t BasicBitWriter<Order>::registerBytes() const {
+        return Order == BitOrder::MsbFirst ? detail::byteSwap(m_bits) : m_bits;
+    }
+
+    template <BitOrder Order>
+    inline void BasicBitWriter<Order>::writeBytes(const uint64_t bytes, const size_t byteCount) {
+        if(byteCount == 8 && makeRoom(8)) {
+            detail::storeLittleEndian64(m_target + m_byteCount, bytes);
+            m_byteCount += 8;
+            return;
+        }
+
+        size_t fittingBytes = byteCount;
+
+        if(! makeRoom(byteCount)) {
+            fittingBytes = m_capacity - m_byteCount;
+            m_overflowed = true;
+        }
+
+        for(size_t i = 0; i < fittingBytes; ++i) {
+            m_target[m_byteCount + i] = static_cast<uint8_t>(bytes >> (i * 8));
+        }
+
+        m_byteCount += fittingBytes;
+    }
+
+    template <BitOrder Order>
+    inline bool BasicBitWriter<Order>::makeRoom(const size_t byteCount) {
+        if(m_byteCount + byteCount <= m_capacity) {
+            return true;
+        }
+
+        if(! m_growable) {
+            return false;
+        }
+
+        m_buffer.resize(std::max<size_t>(m_buffer.size() * 2, std::max<size_t>(m_byteCount + byteCount, 64)));
+        m_target = m_buffer.data();
+        m_capacity = m_buffer.size();
+
+        return true;
+    }
+}
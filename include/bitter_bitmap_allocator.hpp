@@ -0,0 +1,231 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <bitter_atomic.hpp>
+#include <bitter_bit.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Hands out numbered slots from a fixed-size pool, safely from any number of threads without locking
+    //!
+    //! \par Example
+    //! \code
+    //!     BitmapAllocator allocator(1000);
+    //!     const size_t slot = allocator.allocate(); // some slot in [0, 1000)
+    //!     allocator.deallocate(slot);
+    //! \endcode
+    //!
+    //! \note  Each slot is a bit in an array of atomic words, claimed with a compare-and-swap.
+    //!        A second bitmap marks which words are full, so a search skips 4096 slots per summary word,
+    //!        and every thread remembers the word it last allocated from so threads tend to stay apart.
+    //!        That hint is kept for one allocator per thread: switching to another allocator restarts
+    //!        its search from a place picked from the thread and the allocator.
+    //!
+    class BitmapAllocator {
+    public:
+        //!
+        //! \brief  Creates an allocator with every slot free
+        //!
+        //! \param[in]  capacity  how many slots there are
+        //!
+        explicit BitmapAllocator(size_t capacity);
+
+        BitmapAllocator(const BitmapAllocator&) = delete;
+        BitmapAllocator& operator=(const BitmapAllocator&) = delete;
+
+        //!
+        //! \brief  Claims a free slot
+        //!
+        //! \returns  the claimed slot, or capacity() if every slot was taken
+        //!
+        size_t allocate();
+
+        //!
+        //! \brief  Gives a slot back so it can be allocated again
+        //!
+        //! \param[in]  slot  a slot returned by allocate() that has not been deallocated since
+        //!
+        void deallocate(size_t slot);
+
+        //!
+        //! \returns  true if \p slot is currently allocated, false otherwise
+        //!
+        bool isAllocated(size_t slot) const;
+
+        //!
+        //! \returns  how many slots there are
+        //!
+        size_t capacity() const;
+
+    private:
+        // tries to claim a bit of a word, returning 64 if it is full
+        size_t claimInWord(size_t wordNumber);
+
+        // marks a word as full in the summary, unless a slot in it was freed in the meantime
+        void markFull(size_t wordNumber);
+
+        size_t m_capacity;
+        size_t m_wordCount;
+        size_t m_summaryWordCount;
+
+        // one bit per slot, set when allocated; bits past the capacity are always set
+        std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+
+        // one bit per word of m_words, set when the word is full; bits past the last word are always set
+        std::unique_ptr<std::atomic<uint64_t>[]> m_fullWords;
+    };
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    inline BitmapAllocator::BitmapAllocator(const size_t capacity)
+    : m_capacity(capacity),
+      m_wordCount((capacity + 63) / 64),
+      m_summaryWordCount((m_wordCount + 63) / 64),
+      m_words(new std::atomic<uint64_t>[m_wordCount]),
+      m_fullWords(new std::atomic<uint64_t>[m_summaryWordCount]) {
+        for(size_t i = 0; i < m_wordCount; ++i) {
+            m_words[i].store(0, std::memory_order_relaxed);
+        }
+
+        for(size_t i = 0; i < m_summaryWordCount; ++i) {
+            m_fullWords[i].store(0, std::memory_order_relaxed);
+        }
+
+        if(capacity % 64 != 0) {
+            m_words[m_wordCount - 1].store(~detail::lowBitMask(capacity % 64), std::memory_order_relaxed);
+        }
+
+        if(m_wordCount % 64 != 0) {
+            m_fullWords[m_summaryWordCount - 1].store(~detail::lowBitMask(m_wordCount % 64), std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    inline size_t BitmapAllocator::allocate() {
+        // the word this thread last allocated from, only trusted for the allocator it came from;
+        // any other allocator starts from the thread's id mixed with its address, so threads start
+        // searching in different places and one allocator's hint never steers another's search
+        struct Hint {
+            const BitmapAllocator* allocator;
+            size_t word;
+        };
+
+        static thread_local Hint hint = { nullptr, 0 };
+
+        if(m_wordCount == 0) {
+            return m_capacity;
+        }
+
+        if(hint.allocator != this) {
+            hint.allocator = this;
+            hint.word = std::hash<std::thread::id>()(std::this_thread::get_id()) ^ std::hash<const BitmapAllocator*>()(this);
+        }
+
+        const size_t firstWord = hint.word % m_wordCount;
+        const size_t firstSummaryWord = firstWord / 64;
+
+        // visit every summary word starting at the hinted one, then the part of it before the hint
+        for(size_t step = 0; step <= m_summaryWordCount; ++step) {
+            const size_t summaryWord = (firstSummaryWord + step) % m_summaryWordCount;
+
+            uint64_t candidates = ~m_fullWords[summaryWord].load(std::memory_order_relaxed);
+
+            if(step == 0) {
+                candidates &= ~detail::lowBitMask(firstWord % 64);
+            } else if(step == m_summaryWordCount) {
+                candidates &= detail::lowBitMask(firstWord % 64);
+            }
+
+            for(; candidates != 0; candidates &= candidates - 1) {
+                const size_t wordNumber = (summaryWord * 64) + detail::countTrailingZeros(candidates);
+                const size_t bitNumber = claimInWord(wordNumber);
+
+                if(bitNumber < 64) {
+                    hint.word = wordNumber;
+                    return (wordNumber * 64) + bitNumber;
+                }
+            }
+        }
+
+        return m_capacity;
+    }
+
+    inline void BitmapAllocator::deallocate(const size_t slot) {
+        // the slot has to be visibly free before the word is unmarked, see markFull
+        atomicClearBit(m_words.get(), slot);
+        atomicClearBit(m_fullWords.get(), slot / 64);
+    }
+
+    inline bool BitmapAllocator::isAllocated(const size_t slot) const {
+        return atomicGetBit(m_words.get(), slot, std::memory_order_acquire) == Bit::One;
+    }
+
+    inline size_t BitmapAllocator::capacity() const {
+        return m_capacity;
+    }
+
+    inline size_t BitmapAllocator::claimInWord(const size_t wordNumber) {
+        std::atomic<uint64_t>& word = m_words[wordNumber];
+        uint64_t current = word.load(std::memory_order_relaxed);
+
+        while(current != ~uint64_t(0)) {
+            const size_t bitNumber = detail::countTrailingZeros(~current);
+            const uint64_t claimed = current | (uint64_t(1) << bitNumber);
+
+            // on failure current is reloaded, and the next free bit is tried
+            if(word.compare_exchange_weak(current, claimed, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                if(claimed == ~uint64_t(0)) {
+                    markFull(wordNumber);
+                }
+
+                return bitNumber;
+            }
+        }
+
+        markFull(wordNumber);
+        return 64;
+    }
+
+    inline void BitmapAllocator::markFull(const size_t wordNumber) {
+        atomicSetBit(m_fullWords.get(), wordNumber);
+
+        // a slot freed between the word filling up and the mark being set would otherwise be hidden,
+        // since deallocate clears the slot before the mark, one of the two always clears the mark last
+        if(m_words[wordNumber].load(std::memory_order_seq_cst) != ~uint64_t(0)) {
+            atomicClearBit(m_fullWords.get(), wordNumber);
+        }
+    }
+}
@@ -0,0 +1,377 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_count.hpp>
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Sets each bit of the target to the AND of the corresponding bits of two sources
+    //!
+    //! \tparam  T  the type the target pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \tparam  U  the type the first source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \tparam  V  the type the second source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[out]  target    where to write to, may be the same as either source
+    //! \param[in]   a         the first source
+    //! \param[in]   b         the second source
+    //! \param[in]   bitCount  how many bits to process, starting at bit 0 of each buffer
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t a[] = { 0x0F, 0xFF };
+    //!     constexpr uint8_t b[] = { 0x3C, 0x00 };
+    //!     uint8_t target[2] = { };
+    //!     bitwiseAnd(target, a, b, 16); // target is now { 0x0C, 0x00 }
+    //! \endcode
+    //!
+    //! \note  the whole bytes are processed a word or vector at a time,
+    //!        using AVX-512 or AVX2 when the compiler targets them;
+    //!        bits of the target after \p bitCount keep their values
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target, \p a and \p b pointers,
+    //!           so make sure they point to valid memory!
+    //!
+    //! \see  #bitwiseAndCount
+    //!
+    template <typename T, typename U, typename V>
+    inline void bitwiseAnd(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  Sets each bit of the target to the OR of the corresponding bits of two sources
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U, typename V>
+    inline void bitwiseOr(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  Sets each bit of the target to the XOR of the corresponding bits of two sources
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U, typename V>
+    inline void bitwiseXor(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  Sets each bit of the target to the corresponding bit of \p a AND NOT the corresponding bit of \p b
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U, typename V>
+    inline void bitwiseAndNot(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  ANDs the bits of a source into the target
+    //!
+    //! \param[in,out]  target    the first operand and where to write to
+    //! \param[in]      source    the second operand
+    //! \param[in]      bitCount  how many bits to process, starting at bit 0 of each buffer
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U>
+    inline void bitwiseAnd(T* target, const U* source, size_t bitCount);
+
+    //!
+    //! \brief  ORs the bits of a source into the target
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U>
+    inline void bitwiseOr(T* target, const U* source, size_t bitCount);
+
+    //!
+    //! \brief  XORs the bits of a source into the target
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U>
+    inline void bitwiseXor(T* target, const U* source, size_t bitCount);
+
+    //!
+    //! \brief  Clears the bits of the target that are set in a source
+    //!
+    //! \see  #bitwiseAnd
+    //!
+    template <typename T, typename U>
+    inline void bitwiseAndNot(T* target, const U* source, size_t bitCount);
+
+    //!
+    //! \brief  Does the same as #bitwiseAnd, counting the set bits of the result on the way
+    //!
+    //! \returns  how many of the \p bitCount bits written are #Bit::One
+    //!
+    //! \note  saves a second pass over the target with #countOnes
+    //!
+    template <typename T, typename U, typename V>
+    inline size_t bitwiseAndCount(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  Does the same as #bitwiseOr, counting the set bits of the result on the way
+    //!
+    //! \see  #bitwiseAndCount
+    //!
+    template <typename T, typename U, typename V>
+    inline size_t bitwiseOrCount(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  Does the same as #bitwiseXor, counting the set bits of the result on the way
+    //!
+    //! \see  #bitwiseAndCount
+    //!
+    template <typename T, typename U, typename V>
+    inline size_t bitwiseXorCount(T* target, const U* a, const V* b, size_t bitCount);
+
+    //!
+    //! \brief  Does the same as #bitwiseAndNot, counting the set bits of the result on the way
+    //!
+    //! \see  #bitwiseAndCount
+    //!
+    template <typename T, typename U, typename V>
+    inline size_t bitwiseAndNotCount(T* target, const U* a, const V* b, size_t bitCount);
+
+    namespace detail {
+        struct AndOperation;
+        struct OrOperation;
+        struct XorOperation;
+        struct AndNotOperation;
+
+        //!
+        //! \brief  Applies an operation to whole bytes, optionally counting the set bits of the result
+        //!
+        template <typename Operation, bool Count>
+        inline size_t applyBitwiseToBytes(uint8_t* target, const uint8_t* a, const uint8_t* b, size_t byteCount);
+
+        //!
+        //! \brief  Applies an operation to the first bitCount bits, optionally counting the set bits of the result
+        //!
+        template <typename Operation, bool Count>
+        inline size_t applyBitwise(uint8_t* target, const uint8_t* a, const uint8_t* b, size_t bitCount);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    namespace detail {
+        struct AndOperation {
+            static uint64_t apply(const uint64_t a, const uint64_t b) { return a & b; }
+#if defined(__AVX2__)
+            static __m256i apply(const __m256i a, const __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+#if defined(__AVX512F__)
+            static __m512i apply(const __m512i a, const __m512i b) { return _mm512_and_si512(a, b); }
+#endif
+        };
+
+        struct OrOperation {
+            static uint64_t apply(const uint64_t a, const uint64_t b) { return a | b; }
+#if defined(__AVX2__)
+            static __m256i apply(const __m256i a, const __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+#if defined(__AVX512F__)
+            static __m512i apply(const __m512i a, const __m512i b) { return _mm512_or_si512(a, b); }
+#endif
+        };
+
+        struct XorOperation {
+            static uint64_t apply(const uint64_t a, const uint64_t b) { return a ^ b; }
+#if defined(__AVX2__)
+            static __m256i apply(const __m256i a, const __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+#if defined(__AVX512F__)
+            static __m512i apply(const __m512i a, const __m512i b) { return _mm512_xor_si512(a, b); }
+#endif
+        };
+
+        struct AndNotOperation {
+            static uint64_t apply(const uint64_t a, const uint64_t b) { return a & ~b; }
+#if defined(__AVX2__)
+            static __m256i apply(const __m256i a, const __m256i b) { return _mm256_andnot_si256(b, a); }
+#endif
+#if defined(__AVX512F__)
+            static __m512i apply(const __m512i a, const __m512i b) { return _mm512_andnot_si512(b, a); }
+#endif
+        };
+    }
+}
+
+template <typename Operation, bool Count>
+inline size_t bitter::detail::applyBitwiseToBytes(uint8_t* target, const uint8_t* a, const uint8_t* b, size_t byteCount) {
+    size_t count = 0;
+
+    // every iteration loads both operands before storing, so the target may alias either of them
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i total = _mm512_setzero_si512();
+
+    for(; byteCount >= 64; byteCount -= 64, target += 64, a += 64, b += 64) {
+        const __m512i result = Operation::apply(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+        _mm512_storeu_si512(target, result);
+
+        if(Count) {
+            total = _mm512_add_epi64(total, _mm512_popcnt_epi64(result));
+        }
+    }
+
+    count += static_cast<size_t>(_mm512_reduce_add_epi64(total));
+#elif defined(__AVX2__)
+    __m256i total = _mm256_setzero_si256();
+
+    for(; byteCount >= 32; byteCount -= 32, target += 32, a += 32, b += 32) {
+        const __m256i result = Operation::apply(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b))
+        );
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), result);
+
+        if(Count) {
+            total = _mm256_add_epi64(total, popCount256(result));
+        }
+    }
+
+    count += static_cast<size_t>(_mm256_extract_epi64(total, 0))
+           + static_cast<size_t>(_mm256_extract_epi64(total, 1))
+           + static_cast<size_t>(_mm256_extract_epi64(total, 2))
+           + static_cast<size_t>(_mm256_extract_epi64(total, 3));
+#endif
+
+    for(; byteCount >= 8; byteCount -= 8, target += 8, a += 8, b += 8) {
+        const uint64_t result = Operation::apply(loadLittleEndian64(a), loadLittleEndian64(b));
+        storeLittleEndian64(target, result);
+
+        if(Count) {
+            count += popCount(result);
+        }
+    }
+
+    for(; byteCount > 0; --byteCount, ++target, ++a, ++b) {
+        *target = static_cast<uint8_t>(Operation::apply(*a, *b));
+
+        if(Count) {
+            count += popCount(*target);
+        }
+    }
+
+    return count;
+}
+
+template <typename Operation, bool Count>
+inline size_t bitter::detail::applyBitwise(uint8_t* const target, const uint8_t* const a, const uint8_t* const b, const size_t bitCount) {
+    const size_t byteCount = bitCount / 8;
+    size_t count = applyBitwiseToBytes<Operation, Count>(target, a, b, byteCount);
+
+    // the bits after the last whole byte are merged, so the rest of that byte is left alone
+    const size_t tailOffset = byteCount * 8;
+    const size_t tailBits = bitCount - tailOffset;
+
+    const uint64_t tail = Operation::apply(getBits(a, tailOffset, tailBits), getBits(b, tailOffset, tailBits)) & lowBitMask(tailBits);
+    setBits(target, tailOffset, tailBits, tail);
+
+    if(Count) {
+        count += popCount(tail);
+    }
+
+    return count;
+}
+
+template <typename T, typename U, typename V>
+inline void bitter::bitwiseAnd(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    detail::applyBitwise<detail::AndOperation, false>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline void bitter::bitwiseOr(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    detail::applyBitwise<detail::OrOperation, false>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline void bitter::bitwiseXor(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    detail::applyBitwise<detail::XorOperation, false>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline void bitter::bitwiseAndNot(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    detail::applyBitwise<detail::AndNotOperation, false>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U>
+inline void bitter::bitwiseAnd(T* const target, const U* const source, const size_t bitCount) {
+    bitwiseAnd(target, target, source, bitCount);
+}
+
+template <typename T, typename U>
+inline void bitter::bitwiseOr(T* const target, const U* const source, const size_t bitCount) {
+    bitwiseOr(target, target, source, bitCount);
+}
+
+template <typename T, typename U>
+inline void bitter::bitwiseXor(T* const target, const U* const source, const size_t bitCount) {
+    bitwiseXor(target, target, source, bitCount);
+}
+
+template <typename T, typename U>
+inline void bitter::bitwiseAndNot(T* const target, const U* const source, const size_t bitCount) {
+    bitwiseAndNot(target, target, source, bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline size_t bitter::bitwiseAndCount(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    return detail::applyBitwise<detail::AndOperation, true>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline size_t bitter::bitwiseOrCount(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    return detail::applyBitwise<detail::OrOperation, true>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline size_t bitter::bitwiseXorCount(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    return detail::applyBitwise<detail::XorOperation, true>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
+
+template <typename T, typename U, typename V>
+inline size_t bitter::bitwiseAndNotCount(T* const target, const U* const a, const V* const b, const size_t bitCount) {
+    return detail::applyBitwise<detail::AndNotOperation, true>(detail::asBytes(target), detail::asBytes(a), detail::asBytes(b), bitCount);
+}
@@ -0,0 +1,361 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  A Bloom filter that keeps all bits of a key inside one 64-byte block, so a lookup is a single cache miss
+    //!
+    //! \par Example
+    //! \code
+    //!     BlockedBloomFilter filter(BlockedBloomFilter::bitCountFor(1000000, 0.01));
+    //!     filter.insert(hash("apple"));
+    //!     const auto x = filter.contains(hash("apple")); // returns true
+    //!     const auto y = filter.contains(hash("pear"));  // returns false, most likely
+    //! \endcode
+    //!
+    //! \note  A key is given as a 64-bit hash, which has to be well mixed since the filter does not hash it again.
+    //!        The high 32 bits pick a 512-bit block, and the low 32 bits, multiplied by eight odd
+    //!        constants, pick one bit in each of the eight 64-bit words of the block.
+    //!        With AVX2 the eight bits are computed and tested with a handful of vector instructions.
+    //!
+    //! \note  the filter holds at most 2^32 blocks, 256 GiB
+    //!
+    class BlockedBloomFilter {
+    public:
+        //!
+        //! \brief  How many bits a block holds
+        //!
+        static constexpr size_t blockBits = 512;
+
+        //!
+        //! \brief  Creates an empty filter
+        //!
+        //! \param[in]  bitCount  how many bits the filter should hold, rounded up to whole blocks
+        //!
+        explicit BlockedBloomFilter(size_t bitCount);
+
+        BlockedBloomFilter(const BlockedBloomFilter&) = delete;
+        BlockedBloomFilter& operator=(const BlockedBloomFilter&) = delete;
+
+        BlockedBloomFilter(BlockedBloomFilter&&) = default;
+        BlockedBloomFilter& operator=(BlockedBloomFilter&&) = default;
+
+        //!
+        //! \brief  Adds a key
+        //!
+        //! \param[in]  hash  the hash of the key
+        //!
+        void insert(uint64_t hash);
+
+        //!
+        //! \brief  Adds many keys, prefetching the blocks of keys further ahead
+        //!
+        //! \param[in]  hashes  the hashes of the keys
+        //! \param[in]  count   how many keys there are
+        //!
+        void insert(const uint64_t* hashes, size_t count);
+
+        //!
+        //! \brief  Tests whether a key may have been added
+        //!
+        //! \param[in]  hash  the hash of the key
+        //!
+        //! \returns  false if the key has certainly not been added, true if it probably has
+        //!
+        bool contains(uint64_t hash) const;
+
+        //!
+        //! \brief  Tests many keys, prefetching the blocks of keys further ahead
+        //!
+        //! \param[in]   hashes   the hashes of the keys
+        //! \param[out]  results  receives contains() of each key
+        //! \param[in]   count    how many keys there are
+        //!
+        //! \returns  how many keys may have been added
+        //!
+        size_t contains(const uint64_t* hashes, bool* results, size_t count) const;
+
+        //!
+        //! \brief  Removes all keys
+        //!
+        void clear();
+
+        //!
+        //! \returns  how many bits the filter holds
+        //!
+        size_t size() const;
+
+        //!
+        //! \returns  the blocks, eight words each, aligned to 64 bytes
+        //!
+        const uint64_t* data() const;
+
+        //!
+        //! \brief  Works out how large a filter has to be to hold a number of keys with a given false positive rate
+        //!
+        //! \param[in]  keyCount           how many keys will be added
+        //! \param[in]  falsePositiveRate  the wanted chance of contains() returning true for a key that was not added
+        //!
+        //! \returns  the bit count to create the filter with
+        //!
+        //! \note  blocks fill up unevenly, so this is a few bits per key more than a classic Bloom filter needs
+        //!
+        //! \note  a rate of 1 or above gives a single block; a rate of 0 or below, or one that not even
+        //!        2^32 blocks reach, gives the largest filter, 2^32 blocks or as many as a size_t can count
+        //!
+        static size_t bitCountFor(size_t keyCount, double falsePositiveRate);
+
+        //!
+        //! \brief  Works out the false positive rate of a filter
+        //!
+        //! \param[in]  bitCount  how many bits the filter holds
+        //! \param[in]  keyCount  how many keys have been added
+        //!
+        //! \returns  the chance of contains() returning true for a key that was not added
+        //!
+        static double expectedFalsePositiveRate(size_t bitCount, size_t keyCount);
+
+    private:
+        static constexpr size_t wordsPerBlock = blockBits / 64;
+        static constexpr size_t prefetchDistance = 16;
+
+        size_t blockIndex(uint64_t hash) const;
+        void prefetch(uint64_t hash) const;
+
+        // fastrange of the high half of the hash, so any number of blocks works without a division
+        size_t m_blockCount;
+
+        // padded so the blocks can start at a 64-byte boundary
+        std::vector<uint64_t> m_storage;
+        uint64_t* m_blocks;
+    };
+
+    namespace detail {
+        //!
+        //! \returns  the odd multiplier picking the bit of a key in a word of a block
+        //!
+        //! \param[in]  wordNumber  the word of the block, in the range [0, 8)
+        //!
+        inline uint32_t bloomSalt(size_t wordNumber);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    inline BlockedBloomFilter::BlockedBloomFilter(const size_t bitCount)
+    : m_blockCount(std::max<size_t>(1, (bitCount + blockBits - 1) / blockBits)),
+      m_storage((m_blockCount * wordsPerBlock) + wordsPerBlock - 1, 0) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.data());
+        m_blocks = m_storage.data() + (((64 - (address % 64)) % 64) / sizeof(uint64_t));
+    }
+
+    inline void BlockedBloomFilter::insert(const uint64_t hash) {
+        uint64_t* const block = m_blocks + (blockIndex(hash) * wordsPerBlock);
+
+#if defined(__AVX2__)
+        const __m256i salts = _mm256_setr_epi32(
+            int(detail::bloomSalt(0)), int(detail::bloomSalt(1)), int(detail::bloomSalt(2)), int(detail::bloomSalt(3)),
+            int(detail::bloomSalt(4)), int(detail::bloomSalt(5)), int(detail::bloomSalt(6)), int(detail::bloomSalt(7)));
+        const __m256i bitNumbers = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(int(uint32_t(hash))), salts), 26);
+        const __m256i one = _mm256_set1_epi64x(1);
+
+        __m256i* const words = reinterpret_cast<__m256i*>(block);
+        const __m256i low = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bitNumbers)));
+        const __m256i high = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bitNumbers, 1)));
+
+        _mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words), low));
+        _mm256_store_si256(words + 1, _mm256_or_si256(_mm256_load_si256(words + 1), high));
+#else
+        for(size_t word = 0; word < wordsPerBlock; ++word) {
+            block[word] |= uint64_t(1) << ((uint32_t(hash) * detail::bloomSalt(word)) >> 26);
+        }
+#endif
+    }
+
+    inline void BlockedBloomFilter::insert(const uint64_t* const hashes, const size_t count) {
+        for(size_t i = 0; i < count; ++i) {
+            if(i + prefetchDistance < count) {
+                prefetch(hashes[i + prefetchDistance]);
+            }
+
+            insert(hashes[i]);
+        }
+    }
+
+    inline bool BlockedBloomFilter::contains(const uint64_t hash) const {
+        const uint64_t* const block = m_blocks + (blockIndex(hash) * wordsPerBlock);
+
+#if defined(__AVX2__)
+        const __m256i salts = _mm256_setr_epi32(
+            int(detail::bloomSalt(0)), int(detail::bloomSalt(1)), int(detail::bloomSalt(2)), int(detail::bloomSalt(3)),
+            int(detail::bloomSalt(4)), int(detail::bloomSalt(5)), int(detail::bloomSalt(6)), int(detail::bloomSalt(7)));
+        const __m256i bitNumbers = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(int(uint32_t(hash))), salts), 26);
+        const __m256i one = _mm256_set1_epi64x(1);
+
+        const __m256i* const words = reinterpret_cast<const __m256i*>(block);
+        const __m256i low = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bitNumbers)));
+        const __m256i high = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bitNumbers, 1)));
+
+        // testc is set when every bit of the mask is set in the block
+        return _mm256_testc_si256(_mm256_load_si256(words), low) && _mm256_testc_si256(_mm256_load_si256(words + 1), high);
+#else
+        uint64_t missing = 0;
+
+        for(size_t word = 0; word < wordsPerBlock; ++word) {
+            missing |= ~block[word] & (uint64_t(1) << ((uint32_t(hash) * detail::bloomSalt(word)) >> 26));
+        }
+
+        return missing == 0;
+#endif
+    }
+
+    inline size_t BlockedBloomFilter::contains(const uint64_t* const hashes, bool* const results, const size_t count) const {
+        size_t found = 0;
+
+        for(size_t i = 0; i < count; ++i) {
+            if(i + prefetchDistance < count) {
+                prefetch(hashes[i + prefetchDistance]);
+            }
+
+            results[i] = contains(hashes[i]);
+            found += results[i] ? 1 : 0;
+        }
+
+        return found;
+    }
+
+    inline void BlockedBloomFilter::clear() {
+        std::fill(m_storage.begin(), m_storage.end(), 0);
+    }
+
+    inline size_t BlockedBloomFilter::size() const {
+        return m_blockCount * blockBits;
+    }
+
+    inline const uint64_t* BlockedBloomFilter::data() const {
+        return m_blocks;
+    }
+
+    inline size_t BlockedBloomFilter::bitCountFor(const size_t keyCount, const double falsePositiveRate) {
+        const size_t maxBlockCount = static_cast<size_t>(std::min<uint64_t>(uint64_t(1) << 32, std::numeric_limits<size_t>::max() / blockBits));
+
+        if(falsePositiveRate >= 1) {
+            return blockBits;
+        }
+
+        // written so that NaN is caught too
+        if(! (falsePositiveRate > 0)) {
+            return maxBlockCount * blockBits;
+        }
+
+        // the rate falls as blocks are added, so search for the fewest blocks that are enough
+        size_t low = 1;
+        size_t high = 1;
+
+        while(high < maxBlockCount && expectedFalsePositiveRate(high * blockBits, keyCount) > falsePositiveRate) {
+            low = high + 1;
+            high = std::min(high * 2, maxBlockCount);
+        }
+
+        while(low < high) {
+            const size_t middle = low + ((high - low) / 2);
+
+            if(expectedFalsePositiveRate(middle * blockBits, keyCount) > falsePositiveRate) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        return high * blockBits;
+    }
+
+    inline double BlockedBloomFilter::expectedFalsePositiveRate(const size_t bitCount, const size_t keyCount) {
+        const size_t blockCount = std::max<size_t>(1, (bitCount + blockBits - 1) / blockBits);
+        const double keysPerBlock = static_cast<double>(keyCount) / static_cast<double>(blockCount);
+
+        // the keys in a block follow a Poisson distribution, a block holding i keys
+        // answers yes for a key that was not added if each of its eight words has the bit set;
+        // the probabilities are worked out in log space as e^-keysPerBlock underflows for full filters
+        const double spread = (10 * std::sqrt(keysPerBlock)) + 20;
+        const size_t minKeys = static_cast<size_t>(std::max(0.0, keysPerBlock - spread));
+        const size_t maxKeys = static_cast<size_t>(keysPerBlock + spread);
+
+        double rate = 0;
+
+        for(size_t keys = minKeys; keys <= maxKeys; ++keys) {
+            const double i = static_cast<double>(keys);
+            double probability = keys == 0 ? 1 : 0;
+
+            if(keysPerBlock > 0) {
+                probability = std::exp((i * std::log(keysPerBlock)) - keysPerBlock - std::lgamma(i + 1));
+            }
+
+            const double wordRate = 1 - std::pow(63.0 / 64.0, i);
+
+            rate += probability * std::pow(wordRate, 8);
+        }
+
+        return rate;
+    }
+
+    inline size_t BlockedBloomFilter::blockIndex(const uint64_t hash) const {
+        return static_cast<size_t>(((hash >> 32) * m_blockCount) >> 32);
+    }
+
+    inline void BlockedBloomFilter::prefetch(const uint64_t hash) const {
+        const uint64_t* const block = m_blocks + (blockIndex(hash) * wordsPerBlock);
+
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(block);
+#elif defined(_MSC_VER)
+        _mm_prefetch(reinterpret_cast<const char*>(block), _MM_HINT_T0);
+#else
+        (void)block;
+#endif
+    }
+}
+
+inline uint32_t bitter::detail::bloomSalt(const size_t wordNumber) {
+    static constexpr uint32_t salts[8] = {
+        0x47B6137B, 0x44974D91, 0x8824AD5B, 0xA2B7289D, 0x705495C7, 0x2DF1424B, 0x9EFC4947, 0x5C6BFB31
+    };
+
+    return salts[wordNumber];
+}
@@ -0,0 +1,1065 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <bitter_bit.hpp>
+#include <bitter_bitwise.hpp>
+#include <bitter_count.hpp>
+#include <bitter_find.hpp>
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    namespace detail {
+        //!
+        //! \brief  Holds the values of a CompressedBitmap that share their upper 16 bits
+        //!
+        struct BitmapContainer {
+            enum class Type : uint8_t {
+                Array = 0,
+                Bitmap = 1,
+                Run = 2
+            };
+
+            // an array container turns into a bitmap container once it would take up more space
+            static constexpr uint32_t maxArrayCardinality = 4096;
+            static constexpr size_t bitmapBits = 65536;
+            static constexpr size_t bitmapBytes = bitmapBits / 8;
+
+            Type type = Type::Array;
+            uint32_t cardinality = 0;
+
+            // Array: the values in increasing order
+            // Run: pairs of (first value, length - 1), in increasing order
+            std::vector<uint16_t> values;
+
+            // Bitmap: one bit per value, numbered the same way as #getBit numbers them
+            std::vector<uint8_t> bits;
+
+            bool contains(uint16_t value) const;
+            void add(uint16_t value);
+            void remove(uint16_t value);
+
+            size_t runCount() const;
+
+            // switches a run container to whichever of array or bitmap suits its cardinality
+            void uncompress();
+
+            // switches between array and bitmap to suit the cardinality
+            void normalise();
+
+            void toArray();
+            void toBitmap();
+            void toRuns();
+
+            size_t serialisedPayloadSize() const;
+        };
+
+        // run containers are uncompressed into scratch, the others are returned as they are
+        inline const BitmapContainer& uncompressed(const BitmapContainer& container, BitmapContainer& scratch);
+
+        // combine source into target, which is the only container modified or uncompressed
+        inline void containerOr(BitmapContainer& target, const BitmapContainer& source);
+        inline void containerAnd(BitmapContainer& target, const BitmapContainer& source);
+        inline void containerAndNot(BitmapContainer& target, const BitmapContainer& source);
+    }
+
+    //!
+    //! \brief  A set of 32-bit unsigned integers that is compact whether it is sparse or dense
+    //!
+    //! \par Example
+    //! \code
+    //!     CompressedBitmap a;
+    //!     a.add(7);
+    //!     a.add(1000000);
+    //!
+    //!     CompressedBitmap b;
+    //!     b.add(7);
+    //!
+    //!     const auto c = a & b;
+    //!     const auto x = c.cardinality(); // returns 1
+    //!
+    //!     for(const uint32_t value : a) {
+    //!         // visits 7 then 1000000
+    //!     }
+    //! \endcode
+    //!
+    //! \note  The values are split into chunks of 65536 by their upper 16 bits.
+    //!        Each chunk is held in whichever container is smallest: a sorted array
+    //!        of up to 4096 values, a 65536 bit bitmap, or (after runOptimize()) a list of runs.
+    //!        Operations between bitmap containers use #bitwiseAndCount and friends.
+    //!
+    class CompressedBitmap {
+    public:
+        //!
+        //! \brief  Iterates over the values of a CompressedBitmap, in increasing order
+        //!
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = uint32_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const uint32_t*;
+            using reference = const uint32_t&;
+
+            const_iterator(const CompressedBitmap* bitmap, size_t containerNumber);
+
+            reference operator*() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+
+            bool operator==(const const_iterator& rhs) const;
+            bool operator!=(const const_iterator& rhs) const;
+
+        private:
+            // moves forward to a value at or after the current position, if there is one
+            void settle();
+
+            const CompressedBitmap* m_bitmap;
+            size_t m_containerNumber;
+
+            // the array index, bit number or run number within the container
+            size_t m_position = 0;
+
+            // how far into the current run the value is
+            size_t m_runOffset = 0;
+
+            uint32_t m_value = 0;
+        };
+
+        //!
+        //! \brief  Creates an empty CompressedBitmap
+        //!
+        CompressedBitmap() = default;
+
+        //!
+        //! \brief  Adds a value, doing nothing if it is already present
+        //!
+        void add(uint32_t value);
+
+        //!
+        //! \brief  Removes a value, doing nothing if it is not present
+        //!
+        void remove(uint32_t value);
+
+        //!
+        //! \returns  true if \p value is present, false otherwise
+        //!
+        bool contains(uint32_t value) const;
+
+        //!
+        //! \returns  how many values are present
+        //!
+        uint64_t cardinality() const;
+
+        //!
+        //! \returns  true if no values are present, false otherwise
+        //!
+        bool isEmpty() const;
+
+        //!
+        //! \brief  Switches each chunk to a list of runs where that takes up less space
+        //!
+        //! \note  adding or removing a value in a chunk held as runs switches it back to an array or bitmap
+        //!
+        void runOptimize();
+
+        //!
+        //! \brief  Writes the bitmap out in a portable form
+        //!
+        //! \returns  the serialised bytes, which are the same on every platform
+        //!
+        //! \see  deserialise()
+        //!
+        std::vector<uint8_t> serialise() const;
+
+        //!
+        //! \brief  Replaces the contents with those of a serialised bitmap
+        //!
+        //! \tparam  T  the type the source pointer points to,
+        //!             should be inferred from the parameter,
+        //!             do not set this explicitly
+        //!
+        //! \param[in]  source       where to read from
+        //! \param[in]  sizeInBytes  how many bytes \p source holds
+        //!
+        //! \returns  true on success, false if \p source does not hold a valid serialised bitmap,
+        //!           in which case the bitmap is left empty
+        //!
+        //! \see  serialise()
+        //!
+        template <typename T>
+        bool deserialise(const T* source, size_t sizeInBytes);
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        CompressedBitmap& operator|=(const CompressedBitmap& rhs);
+        CompressedBitmap& operator&=(const CompressedBitmap& rhs);
+        CompressedBitmap& operator-=(const CompressedBitmap& rhs);
+
+        //!
+        //! \returns  the values present in either operand
+        //!
+        friend CompressedBitmap operator|(CompressedBitmap lhs, const CompressedBitmap& rhs);
+
+        //!
+        //! \returns  the values present in both operands
+        //!
+        friend CompressedBitmap operator&(CompressedBitmap lhs, const CompressedBitmap& rhs);
+
+        //!
+        //! \returns  the values present in \p lhs but not in \p rhs
+        //!
+        friend CompressedBitmap operator-(CompressedBitmap lhs, const CompressedBitmap& rhs);
+
+        friend bool operator==(const CompressedBitmap& lhs, const CompressedBitmap& rhs);
+        friend bool operator!=(const CompressedBitmap& lhs, const CompressedBitmap& rhs);
+
+    private:
+        static constexpr uint32_t serialCookie = 0x42435442; // "BTCB"
+
+        // the index of the container for a key, or where it would be inserted
+        size_t findContainer(uint16_t key) const;
+
+        // the upper 16 bits of the values held by each container, in increasing order
+        std::vector<uint16_t> m_keys;
+        std::vector<detail::BitmapContainer> m_containers;
+    };
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    namespace detail {
+        inline bool BitmapContainer::contains(const uint16_t value) const {
+            switch(type) {
+                case Type::Array:
+                    return std::binary_search(values.begin(), values.end(), value);
+
+                case Type::Bitmap:
+                    return getBit(bits.data(), value) == Bit::One;
+
+                case Type::Run: {
+                    // find the last run starting at or before the value
+                    size_t low = 0;
+                    size_t high = values.size() / 2;
+
+                    while(low < high) {
+                        const size_t middle = low + ((high - low) / 2);
+
+                        if(values[middle * 2] <= value) {
+                            low = middle + 1;
+                        } else {
+                            high = middle;
+                        }
+                    }
+
+                    return low > 0 && value - values[(low - 1) * 2] <= values[((low - 1) * 2) + 1];
+                }
+            }
+
+            return false;
+        }
+
+        inline void BitmapContainer::add(const uint16_t value) {
+            uncompress();
+
+            if(type == Type::Array) {
+                const auto position = std::lower_bound(values.begin(), values.end(), value);
+
+                if(position != values.end() && *position == value) {
+                    return;
+                }
+
+                if(cardinality < maxArrayCardinality) {
+                    values.insert(position, value);
+                    ++cardinality;
+                    return;
+                }
+
+                toBitmap();
+            }
+
+            if(getBit(bits.data(), value) == Bit::Zero) {
+                setBit(bits.data(), value, Bit::One);
+                ++cardinality;
+            }
+        }
+
+        inline void BitmapContainer::remove(const uint16_t value) {
+            uncompress();
+
+            if(type == Type::Array) {
+                const auto position = std::lower_bound(values.begin(), values.end(), value);
+
+                if(position != values.end() && *position == value) {
+                    values.erase(position);
+                    --cardinality;
+                }
+
+                return;
+            }
+
+            if(getBit(bits.data(), value) == Bit::One) {
+                setBit(bits.data(), value, Bit::Zero);
+                --cardinality;
+                normalise();
+            }
+        }
+
+        inline size_t BitmapContainer::runCount() const {
+            switch(type) {
+                case Type::Array: {
+                    size_t runs = values.empty() ? 0 : 1;
+
+                    for(size_t i = 1; i < values.size(); ++i) {
+                        runs += (values[i] != values[i - 1] + 1) ? 1 : 0;
+                    }
+
+                    return runs;
+                }
+
+                case Type::Bitmap: {
+                    // a run starts at every set bit whose lower neighbour is clear
+                    size_t runs = 0;
+                    uint64_t carry = 0;
+
+                    for(size_t byte = 0; byte < bitmapBytes; byte += 8) {
+                        const uint64_t word = loadLittleEndian64(bits.data() + byte);
+                        runs += popCount(word & ~((word << 1) | carry));
+                        carry = word >> 63;
+                    }
+
+                    return runs;
+                }
+
+                case Type::Run:
+                    return values.size() / 2;
+            }
+
+            return 0;
+        }
+
+        inline void BitmapContainer::uncompress() {
+            if(type == Type::Run) {
+                if(cardinality <= maxArrayCardinality) {
+                    toArray();
+                } else {
+                    toBitmap();
+                }
+            }
+        }
+
+        inline void BitmapContainer::normalise() {
+            if(type == Type::Array && cardinality > maxArrayCardinality) {
+                toBitmap();
+            } else if(type == Type::Bitmap && cardinality <= maxArrayCardinality) {
+                toArray();
+            }
+        }
+
+        inline void BitmapContainer::toArray() {
+            std::vector<uint16_t> array;
+            array.reserve(cardinality);
+
+            if(type == Type::Bitmap) {
+                for(const size_t value : eachSetBit(bits.data(), bitmapBits)) {
+                    array.push_back(static_cast<uint16_t>(value));
+                }
+            } else if(type == Type::Run) {
+                for(size_t run = 0; run < values.size(); run += 2) {
+                    for(uint32_t value = values[run]; value <= uint32_t(values[run]) + values[run + 1]; ++value) {
+                        array.push_back(static_cast<uint16_t>(value));
+                    }
+                }
+            } else {
+                return;
+            }
+
+            type = Type::Array;
+            values = std::move(array);
+            bits = std::vector<uint8_t>();
+        }
+
+        inline void BitmapContainer::toBitmap() {
+            if(type == Type::Bitmap) {
+                return;
+            }
+
+            bits.assign(bitmapBytes, 0);
+
+            if(type == Type::Array) {
+                for(const uint16_t value : values) {
+                    setBit(bits.data(), value, Bit::One);
+                }
+            } else {
+                for(size_t run = 0; run < values.size(); run += 2) {
+                    size_t bitNumber = values[run];
+                    size_t remaining = size_t(values[run + 1]) + 1;
+
+                    for(; remaining > 0; ) {
+                        const size_t chunkBits = std::min<size_t>(remaining, 64);
+                        setBits(bits.data(), bitNumber, chunkBits, ~uint64_t(0));
+                        bitNumber += chunkBits;
+                        remaining -= chunkBits;
+                    }
+                }
+            }
+
+            type = Type::Bitmap;
+            values = std::vector<uint16_t>();
+        }
+
+        inline void BitmapContainer::toRuns() {
+            if(type == Type::Run) {
+                return;
+            }
+
+            std::vector<uint16_t> runs;
+            runs.reserve(runCount() * 2);
+
+            if(type == Type::Array) {
+                for(size_t i = 0; i < values.size(); ) {
+                    size_t last = i;
+
+                    while(last + 1 < values.size() && values[last + 1] == values[last] + 1) {
+                        ++last;
+                    }
+
+                    runs.push_back(values[i]);
+                    runs.push_back(static_cast<uint16_t>(last - i));
+
+                    i = last + 1;
+                }
+            } else {
+                for(size_t start = findFirstSet(bits.data(), bitmapBits); start < bitmapBits; ) {
+                    const size_t end = findNextClear(bits.data(), bitmapBits, start);
+
+                    runs.push_back(static_cast<uint16_t>(start));
+                    runs.push_back(static_cast<uint16_t>(end - start - 1));
+
+                    start = findNextSet(bits.data(), bitmapBits, end);
+                }
+            }
+
+            type = Type::Run;
+            values = std::move(runs);
+            bits = std::vector<uint8_t>();
+        }
+
+        inline size_t BitmapContainer::serialisedPayloadSize() const {
+            switch(type) {
+                case Type::Array:
+                    return values.size() * 2;
+
+                case Type::Bitmap:
+                    return bitmapBytes;
+
+                case Type::Run:
+                    return 2 + (values.size() * 2);
+            }
+
+            return 0;
+        }
+
+        inline const BitmapContainer& uncompressed(const BitmapContainer& container, BitmapContainer& scratch) {
+            if(container.type != BitmapContainer::Type::Run) {
+                return container;
+            }
+
+            scratch = container;
+            scratch.uncompress();
+            return scratch;
+        }
+
+        inline void containerOr(BitmapContainer& target, const BitmapContainer& sourceContainer) {
+            BitmapContainer scratch;
+            const BitmapContainer& source = uncompressed(sourceContainer, scratch);
+
+            target.uncompress();
+
+            if(target.type == BitmapContainer::Type::Array && source.type == BitmapContainer::Type::Array) {
+                std::vector<uint16_t> values;
+                values.reserve(target.values.size() + source.values.size());
+                std::set_union(target.values.begin(), target.values.end(), source.values.begin(), source.values.end(), std::back_inserter(values));
+
+                target.values = std::move(values);
+                target.cardinality = static_cast<uint32_t>(target.values.size());
+                target.normalise();
+                return;
+            }
+
+            // the union holds more values than the bitmap operand, so it is a bitmap too
+            target.toBitmap();
+
+            if(source.type == BitmapContainer::Type::Array) {
+                for(const uint16_t value : source.values) {
+                    if(getBit(target.bits.data(), value) == Bit::Zero) {
+                        setBit(target.bits.data(), value, Bit::One);
+                        ++target.cardinality;
+                    }
+                }
+
+                return;
+            }
+
+            target.cardinality = static_cast<uint32_t>(bitwiseOrCount(target.bits.data(), target.bits.data(), source.bits.data(), BitmapContainer::bitmapBits));
+        }
+
+        inline void containerAnd(BitmapContainer& target, const BitmapContainer& sourceContainer) {
+            BitmapContainer scratch;
+            const BitmapContainer& source = uncompressed(sourceContainer, scratch);
+
+            target.uncompress();
+
+            if(target.type == BitmapContainer::Type::Bitmap && source.type == BitmapContainer::Type::Bitmap) {
+                target.cardinality = static_cast<uint32_t>(bitwiseAndCount(target.bits.data(), target.bits.data(), source.bits.data(), BitmapContainer::bitmapBits));
+                target.normalise();
+                return;
+            }
+
+            if(target.type == BitmapContainer::Type::Bitmap) {
+                // the intersection is no larger than the array operand, so keep those of its values target holds
+                std::vector<uint16_t> values;
+                std::copy_if(source.values.begin(), source.values.end(), std::back_inserter(values), [&target](const uint16_t value) {
+                    return getBit(target.bits.data(), value) == Bit::One;
+                });
+
+                target.type = BitmapContainer::Type::Array;
+                target.values = std::move(values);
+                target.bits = std::vector<uint8_t>();
+                target.cardinality = static_cast<uint32_t>(target.values.size());
+                return;
+            }
+
+            // target is an array, so drop the values source does not hold, walking both arrays together
+            size_t kept = 0;
+            size_t j = 0;
+
+            for(const uint16_t value : target.values) {
+                bool found = false;
+
+                if(source.type == BitmapContainer::Type::Bitmap) {
+                    found = getBit(source.bits.data(), value) == Bit::One;
+                } else {
+                    while(j < source.values.size() && source.values[j] < value) {
+                        ++j;
+                    }
+
+                    found = j < source.values.size() && source.values[j] == value;
+                }
+
+                if(found) {
+                    target.values[kept++] = value;
+                }
+            }
+
+            target.values.resize(kept);
+            target.cardinality = static_cast<uint32_t>(kept);
+        }
+
+        inline void containerAndNot(BitmapContainer& target, const BitmapContainer& sourceContainer) {
+            BitmapContainer scratch;
+            const BitmapContainer& source = uncompressed(sourceContainer, scratch);
+
+            target.uncompress();
+
+            if(target.type == BitmapContainer::Type::Array) {
+                target.values.erase(std::remove_if(target.values.begin(), target.values.end(), [&source](const uint16_t value) {
+                    return source.contains(value);
+                }), target.values.end());
+
+                target.cardinality = static_cast<uint32_t>(target.values.size());
+                return;
+            }
+
+            if(source.type == BitmapContainer::Type::Array) {
+                for(const uint16_t value : source.values) {
+                    if(getBit(target.bits.data(), value) == Bit::One) {
+                        setBit(target.bits.data(), value, Bit::Zero);
+                        --target.cardinality;
+                    }
+                }
+            } else {
+                target.cardinality = static_cast<uint32_t>(bitwiseAndNotCount(target.bits.data(), target.bits.data(), source.bits.data(), BitmapContainer::bitmapBits));
+            }
+
+            target.normalise();
+        }
+    }
+
+    inline CompressedBitmap::const_iterator::const_iterator(const CompressedBitmap* const bitmap, const size_t containerNumber)
+    : m_bitmap(bitmap),
+      m_containerNumber(containerNumber) {
+        settle();
+    }
+
+    inline CompressedBitmap::const_iterator::reference CompressedBitmap::const_iterator::operator*() const {
+        return m_value;
+    }
+
+    inline CompressedBitmap::const_iterator& CompressedBitmap::const_iterator::operator++() {
+        const auto& container = m_bitmap->m_containers[m_containerNumber];
+
+        if(container.type == detail::BitmapContainer::Type::Run) {
+            if(m_runOffset < container.values[(m_position * 2) + 1]) {
+                ++m_runOffset;
+            } else {
+                ++m_position;
+                m_runOffset = 0;
+            }
+        } else {
+            ++m_position;
+        }
+
+        settle();
+        return *this;
+    }
+
+    inline CompressedBitmap::const_iterator CompressedBitmap::const_iterator::operator++(int) {
+        const_iterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    inline bool CompressedBitmap::const_iterator::operator==(const const_iterator& rhs) const {
+        return m_bitmap == rhs.m_bitmap
+            && m_containerNumber == rhs.m_containerNumber
+            && m_position == rhs.m_position
+            && m_runOffset == rhs.m_runOffset;
+    }
+
+    inline bool CompressedBitmap::const_iterator::operator!=(const const_iterator& rhs) const {
+        return ! (*this == rhs);
+    }
+
+    inline void CompressedBitmap::const_iterator::settle() {
+        using Type = detail::BitmapContainer::Type;
+
+        for(; m_containerNumber < m_bitmap->m_containers.size(); ++m_containerNumber, m_position = 0, m_runOffset = 0) {
+            const auto& container = m_bitmap->m_containers[m_containerNumber];
+            const uint32_t high = uint32_t(m_bitmap->m_keys[m_containerNumber]) << 16;
+
+            if(container.type == Type::Array && m_position < container.values.size()) {
+                m_value = high | container.values[m_position];
+                return;
+            }
+
+            if(container.type == Type::Bitmap && m_position < detail::BitmapContainer::bitmapBits) {
+                m_position = findNextSet(container.bits.data(), detail::BitmapContainer::bitmapBits, m_position);
+
+                if(m_position < detail::BitmapContainer::bitmapBits) {
+                    m_value = high | static_cast<uint32_t>(m_position);
+                    return;
+                }
+            }
+
+            if(container.type == Type::Run && (m_position * 2) < container.values.size()) {
+                m_value = high | static_cast<uint32_t>(container.values[m_position * 2] + m_runOffset);
+                return;
+            }
+        }
+
+        // every end iterator compares equal
+        m_position = 0;
+        m_runOffset = 0;
+    }
+
+    inline void CompressedBitmap::add(const uint32_t value) {
+        const uint16_t key = static_cast<uint16_t>(value >> 16);
+        const size_t index = findContainer(key);
+
+        if(index == m_keys.size() || m_keys[index] != key) {
+            m_keys.insert(m_keys.begin() + index, key);
+            m_containers.insert(m_containers.begin() + index, detail::BitmapContainer());
+        }
+
+        m_containers[index].add(static_cast<uint16_t>(value));
+    }
+
+    inline void CompressedBitmap::remove(const uint32_t value) {
+        const uint16_t key = static_cast<uint16_t>(value >> 16);
+        const size_t index = findContainer(key);
+
+        if(index == m_keys.size() || m_keys[index] != key) {
+            return;
+        }
+
+        m_containers[index].remove(static_cast<uint16_t>(value));
+
+        if(m_containers[index].cardinality == 0) {
+            m_keys.erase(m_keys.begin() + index);
+            m_containers.erase(m_containers.begin() + index);
+        }
+    }
+
+    inline bool CompressedBitmap::contains(const uint32_t value) const {
+        const uint16_t key = static_cast<uint16_t>(value >> 16);
+        const size_t index = findContainer(key);
+
+        return index < m_keys.size() && m_keys[index] == key && m_containers[index].contains(static_cast<uint16_t>(value));
+    }
+
+    inline uint64_t CompressedBitmap::cardinality() const {
+        uint64_t total = 0;
+
+        for(const auto& container : m_containers) {
+            total += container.cardinality;
+        }
+
+        return total;
+    }
+
+    inline bool CompressedBitmap::isEmpty() const {
+        return m_containers.empty();
+    }
+
+    inline void CompressedBitmap::runOptimize() {
+        for(auto& container : m_containers) {
+            container.uncompress();
+
+            const size_t runBytes = 2 + (container.runCount() * 4);
+
+            if(runBytes < container.serialisedPayloadSize()) {
+                container.toRuns();
+            }
+        }
+    }
+
+    inline std::vector<uint8_t> CompressedBitmap::serialise() const {
+        // cookie, container count, then per container:
+        // key (2 bytes), type (1 byte), cardinality (4 bytes) and the payload,
+        // all little endian: array values, bitmap bytes, or a run count followed by the runs
+        size_t size = 8;
+
+        for(const auto& container : m_containers) {
+            size += 7 + container.serialisedPayloadSize();
+        }
+
+        std::vector<uint8_t> result(size);
+        uint8_t* target = result.data();
+
+        detail::storeLittleEndian32(target, serialCookie);
+        detail::storeLittleEndian32(target + 4, static_cast<uint32_t>(m_containers.size()));
+        target += 8;
+
+        for(size_t i = 0; i < m_containers.size(); ++i) {
+            const auto& container = m_containers[i];
+
+            detail::storeLittleEndian16(target, m_keys[i]);
+            target[2] = static_cast<uint8_t>(container.type);
+            detail::storeLittleEndian32(target + 3, container.cardinality);
+            target += 7;
+
+            if(container.type == detail::BitmapContainer::Type::Bitmap) {
+                std::copy(container.bits.begin(), container.bits.end(), target);
+                target += container.bits.size();
+                continue;
+            }
+
+            if(container.type == detail::BitmapContainer::Type::Run) {
+                detail::storeLittleEndian16(target, static_cast<uint16_t>(container.values.size() / 2));
+                target += 2;
+            }
+
+            for(const uint16_t value : container.values) {
+                detail::storeLittleEndian16(target, value);
+                target += 2;
+            }
+        }
+
+        return result;
+    }
+
+    template <typename T>
+    inline bool CompressedBitmap::deserialise(const T* const source, const size_t sizeInBytes) {
+        using Container = detail::BitmapContainer;
+
+        m_keys.clear();
+        m_containers.clear();
+
+        const uint8_t* bytes = detail::asBytes(source);
+        size_t remaining = sizeInBytes;
+
+        const auto fail = [this]() {
+            m_keys.clear();
+            m_containers.clear();
+            return false;
+        };
+
+        if(remaining < 8 || detail::loadLittleEndian32(bytes) != serialCookie) {
+            return fail();
+        }
+
+        const uint32_t containerCount = detail::loadLittleEndian32(bytes + 4);
+        bytes += 8;
+        remaining -= 8;
+
+        for(uint32_t i = 0; i < containerCount; ++i) {
+            if(remaining < 7) {
+                return fail();
+            }
+
+            const uint16_t key = detail::loadLittleEndian16(bytes);
+            const uint8_t type = bytes[2];
+            const uint32_t cardinality = detail::loadLittleEndian32(bytes + 3);
+            bytes += 7;
+            remaining -= 7;
+
+            if((! m_keys.empty() && key <= m_keys.back()) || type > 2 || cardinality == 0 || cardinality > Container::bitmapBits) {
+                return fail();
+            }
+
+            Container container;
+            container.type = static_cast<Container::Type>(type);
+            container.cardinality = cardinality;
+
+            if(container.type == Container::Type::Bitmap) {
+                if(remaining < Container::bitmapBytes) {
+                    return fail();
+                }
+
+                container.bits.assign(bytes, bytes + Container::bitmapBytes);
+                bytes += Container::bitmapBytes;
+                remaining -= Container::bitmapBytes;
+
+                if(countOnes(container.bits.data(), 0, Container::bitmapBits) != cardinality) {
+                    return fail();
+                }
+            } else if(container.type == Container::Type::Array) {
+                if(remaining / 2 < cardinality) {
+                    return fail();
+                }
+
+                for(uint32_t j = 0; j < cardinality; ++j) {
+                    const uint16_t value = detail::loadLittleEndian16(bytes + (j * 2));
+
+                    if(j > 0 && value <= container.values.back()) {
+                        return fail();
+                    }
+
+                    container.values.push_back(value);
+                }
+
+                bytes += cardinality * 2;
+                remaining -= cardinality * 2;
+            } else {
+                if(remaining < 2) {
+                    return fail();
+                }
+
+                const size_t runCount = detail::loadLittleEndian16(bytes);
+                bytes += 2;
+                remaining -= 2;
+
+                if(remaining / 4 < runCount) {
+                    return fail();
+                }
+
+                // runs have to be in order, must not overlap and must stay within the chunk
+                uint32_t total = 0;
+                uint32_t nextAllowed = 0;
+
+                for(size_t run = 0; run < runCount; ++run) {
+                    const uint32_t start = detail::loadLittleEndian16(bytes + (run * 4));
+                    const uint32_t lengthMinusOne = detail::loadLittleEndian16(bytes + (run * 4) + 2);
+
+                    if(start < nextAllowed || start + lengthMinusOne >= Container::bitmapBits) {
+                        return fail();
+                    }
+
+                    container.values.push_back(static_cast<uint16_t>(start));
+                    container.values.push_back(static_cast<uint16_t>(lengthMinusOne));
+
+                    total += lengthMinusOne + 1;
+                    nextAllowed = start + lengthMinusOne + 1;
+                }
+
+                bytes += runCount * 4;
+                remaining -= runCount * 4;
+
+                if(total != cardinality) {
+                    return fail();
+                }
+            }
+
+            m_keys.push_back(key);
+            m_containers.push_back(std::move(container));
+        }
+
+        return remaining == 0 ? true : fail();
+    }
+
+    inline CompressedBitmap::const_iterator CompressedBitmap::begin() const {
+        return const_iterator(this, 0);
+    }
+
+    inline CompressedBitmap::const_iterator CompressedBitmap::end() const {
+        return const_iterator(this, m_containers.size());
+    }
+
+    inline CompressedBitmap& CompressedBitmap::operator|=(const CompressedBitmap& rhs) {
+        if(this == &rhs) {
+            return *this;
+        }
+
+        // containers only in rhs are inserted between the existing ones, which are moved rather than copied
+        std::vector<uint16_t> keys;
+        std::vector<detail::BitmapContainer> containers;
+        keys.reserve(m_keys.size() + rhs.m_keys.size());
+        containers.reserve(m_keys.size() + rhs.m_keys.size());
+
+        size_t i = 0;
+        size_t j = 0;
+
+        while(i < m_keys.size() || j < rhs.m_keys.size()) {
+            if(j == rhs.m_keys.size() || (i < m_keys.size() && m_keys[i] < rhs.m_keys[j])) {
+                keys.push_back(m_keys[i]);
+                containers.push_back(std::move(m_containers[i]));
+                ++i;
+            } else if(i == m_keys.size() || rhs.m_keys[j] < m_keys[i]) {
+                keys.push_back(rhs.m_keys[j]);
+                containers.push_back(rhs.m_containers[j]);
+                ++j;
+            } else {
+                detail::containerOr(m_containers[i], rhs.m_containers[j]);
+                keys.push_back(m_keys[i]);
+                containers.push_back(std::move(m_containers[i]));
+                ++i;
+                ++j;
+            }
+        }
+
+        m_keys = std::move(keys);
+        m_containers = std::move(containers);
+        return *this;
+    }
+
+    inline CompressedBitmap& CompressedBitmap::operator&=(const CompressedBitmap& rhs) {
+        if(this == &rhs) {
+            return *this;
+        }
+
+        size_t kept = 0;
+        size_t j = 0;
+
+        for(size_t i = 0; i < m_keys.size(); ++i) {
+            while(j < rhs.m_keys.size() && rhs.m_keys[j] < m_keys[i]) {
+                ++j;
+            }
+
+            if(j == rhs.m_keys.size() || rhs.m_keys[j] != m_keys[i]) {
+                continue;
+            }
+
+            detail::containerAnd(m_containers[i], rhs.m_containers[j]);
+
+            if(m_containers[i].cardinality != 0) {
+                m_keys[kept] = m_keys[i];
+                if(kept != i) {
+                    m_containers[kept] = std::move(m_containers[i]);
+                }
+
+                ++kept;
+            }
+        }
+
+        m_keys.resize(kept);
+        m_containers.resize(kept);
+        return *this;
+    }
+
+    inline CompressedBitmap& CompressedBitmap::operator-=(const CompressedBitmap& rhs) {
+        if(this == &rhs) {
+            m_keys.clear();
+            m_containers.clear();
+            return *this;
+        }
+
+        size_t kept = 0;
+        size_t j = 0;
+
+        for(size_t i = 0; i < m_keys.size(); ++i) {
+            while(j < rhs.m_keys.size() && rhs.m_keys[j] < m_keys[i]) {
+                ++j;
+            }
+
+            if(j < rhs.m_keys.size() && rhs.m_keys[j] == m_keys[i]) {
+                detail::containerAndNot(m_containers[i], rhs.m_containers[j]);
+            }
+
+            if(m_containers[i].cardinality != 0) {
+                m_keys[kept] = m_keys[i];
+                if(kept != i) {
+                    m_containers[kept] = std::move(m_containers[i]);
+                }
+
+                ++kept;
+            }
+        }
+
+        m_keys.resize(kept);
+        m_containers.resize(kept);
+        return *this;
+    }
+
+    inline CompressedBitmap operator|(CompressedBitmap lhs, const CompressedBitmap& rhs) {
+        lhs |= rhs;
+        return lhs;
+    }
+
+    inline CompressedBitmap operator&(CompressedBitmap lhs, const CompressedBitmap& rhs) {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    inline CompressedBitmap operator-(CompressedBitmap lhs, const CompressedBitmap& rhs) {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    inline bool operator==(const CompressedBitmap& lhs, const CompressedBitmap& rhs) {
+        // the same values can be held by different kinds of container, so compare the values themselves
+        return lhs.m_keys == rhs.m_keys
+            && lhs.cardinality() == rhs.cardinality()
+            && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    inline bool operator!=(const CompressedBitmap& lhs, const CompressedBitmap& rhs) {
+        return ! (lhs == rhs);
+    }
+
+    inline size_t CompressedBitmap::findContainer(const uint16_t key) const {
+        return static_cast<size_t>(std::lower_bound(m_keys.begin(), m_keys.end(), key) - m_keys.begin());
+    }
+}
@@ -0,0 +1,156 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Copies a range of bits from one place to another
+    //!
+    //! \tparam  T  the type the target pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \tparam  U  the type the source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[out]  target           where to write to
+    //! \param[in]   targetBitOffset  the first bit to write (zero-indexed)
+    //! \param[in]   source           where to read from
+    //! \param[in]   sourceBitOffset  the first bit to read (zero-indexed)
+    //! \param[in]   bitCount         how many bits to copy
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t source[] = { 0xF0 };
+    //!     uint8_t target[] = { 0x00, 0x00 };
+    //!     copyBits(target, 6, source, 4, 4); // target is now { 0xC0, 0x03 }
+    //! \endcode
+    //!
+    //! \note  like memmove, the ranges may overlap
+    //!
+    //! \note  bits outside of the target range keep their values;
+    //!        when both offsets are the same distance from a byte boundary
+    //!        the whole bytes are copied with memmove, otherwise the target is
+    //!        written a word at a time from funnel-shifted unaligned source loads
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target and \p source pointers,
+    //!           so make sure they point to valid memory!
+    //!
+    //! \see  #getBits
+    //! \see  #setBits
+    //!
+    template <typename T, typename U>
+    inline void copyBits(T* target, size_t targetBitOffset, const U* source, size_t sourceBitOffset, size_t bitCount);
+
+    namespace detail {
+        inline void copyBitsSameAlignment(uint8_t* target, size_t targetBitOffset, const uint8_t* source, size_t sourceBitOffset, size_t bitCount);
+        inline void copyBitsForwards(uint8_t* target, size_t targetBitOffset, const uint8_t* source, size_t sourceBitOffset, size_t bitCount);
+        inline void copyBitsBackwards(uint8_t* target, size_t targetBitOffset, const uint8_t* source, size_t sourceBitOffset, size_t bitCount);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <typename T, typename U>
+inline void bitter::copyBits(T* const target, const size_t targetBitOffset, const U* const source, const size_t sourceBitOffset, const size_t bitCount) {
+    if(bitCount == 0) {
+        return;
+    }
+
+    uint8_t* const targetBytes = detail::asBytes(target);
+    const uint8_t* const sourceBytes = detail::asBytes(source);
+
+    if(targetBitOffset % 8 == sourceBitOffset % 8) {
+        detail::copyBitsSameAlignment(targetBytes, targetBitOffset, sourceBytes, sourceBitOffset, bitCount);
+        return;
+    }
+
+    // an overlapping copy to a later bit has to start at the end, so no source bit is overwritten before it is read
+    const uint8_t* const firstTargetByte = targetBytes + (targetBitOffset / 8);
+    const uint8_t* const firstSourceByte = sourceBytes + (sourceBitOffset / 8);
+
+    const bool backwards = std::greater<const uint8_t*>()(firstTargetByte, firstSourceByte)
+                        || (firstTargetByte == firstSourceByte && targetBitOffset % 8 > sourceBitOffset % 8);
+
+    if(backwards) {
+        detail::copyBitsBackwards(targetBytes, targetBitOffset, sourceBytes, sourceBitOffset, bitCount);
+    } else {
+        detail::copyBitsForwards(targetBytes, targetBitOffset, sourceBytes, sourceBitOffset, bitCount);
+    }
+}
+
+inline void bitter::detail::copyBitsSameAlignment(uint8_t* const target, size_t targetBitOffset, const uint8_t* const source, size_t sourceBitOffset, size_t bitCount) {
+    const size_t headBits = std::min<size_t>((8 - (targetBitOffset % 8)) % 8, bitCount);
+    const size_t byteCount = (bitCount - headBits) / 8;
+    const size_t tailBits = bitCount - headBits - (byteCount * 8);
+
+    // the partial bytes at either end are read before anything is written, in case the ranges overlap
+    const uint64_t head = getBits(source, sourceBitOffset, headBits);
+    const uint64_t tail = getBits(source, sourceBitOffset + headBits + (byteCount * 8), tailBits);
+
+    std::memmove(target + ((targetBitOffset + headBits) / 8), source + ((sourceBitOffset + headBits) / 8), byteCount);
+
+    setBits(target, targetBitOffset, headBits, head);
+    setBits(target, targetBitOffset + headBits + (byteCount * 8), tailBits, tail);
+}
+
+inline void bitter::detail::copyBitsForwards(uint8_t* const target, size_t targetBitOffset, const uint8_t* const source, size_t sourceBitOffset, size_t bitCount) {
+    // bits up to the first target byte boundary, after which whole words can be stored
+    const size_t headBits = std::min<size_t>((8 - (targetBitOffset % 8)) % 8, bitCount);
+    setBits(target, targetBitOffset, headBits, getBits(source, sourceBitOffset, headBits));
+    targetBitOffset += headBits;
+    sourceBitOffset += headBits;
+    bitCount -= headBits;
+
+    for(; bitCount >= 64; bitCount -= 64, targetBitOffset += 64, sourceBitOffset += 64) {
+        storeLittleEndian64(target + (targetBitOffset / 8), getBits(source, sourceBitOffset, 64));
+    }
+
+    setBits(target, targetBitOffset, bitCount, getBits(source, sourceBitOffset, bitCount));
+}
+
+inline void bitter::detail::copyBitsBackwards(uint8_t* const target, const size_t targetBitOffset, const uint8_t* const source, const size_t sourceBitOffset, size_t bitCount) {
+    // bits after the last target byte boundary, before which whole words can be stored
+    const size_t tailBits = std::min<size_t>((targetBitOffset + bitCount) % 8, bitCount);
+    bitCount -= tailBits;
+    setBits(target, targetBitOffset + bitCount, tailBits, getBits(source, sourceBitOffset + bitCount, tailBits));
+
+    for(; bitCount >= 64; bitCount -= 64) {
+        storeLittleEndian64(target + ((targetBitOffset + bitCount - 64) / 8), getBits(source, sourceBitOffset + bitCount - 64, 64));
+    }
+
+    setBits(target, targetBitOffset, bitCount, getBits(source, sourceBitOffset, bitCount));
+}
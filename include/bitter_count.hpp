@@ -0,0 +1,225 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+
+#if defined(__AVX2__) || (defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__))
+#include <immintrin.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Counts how many bits in a range are set
+    //!
+    //! \tparam  T  the type the source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[in]  source     where to read from
+    //! \param[in]  bitOffset  the first bit to count (zero-indexed)
+    //! \param[in]  bitCount   how many bits to count
+    //!
+    //! \returns  the number of bits in the range that are #Bit::One
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0xF0, 0x0F };
+    //!     const auto x = countOnes(data, 0, 16); // returns 8
+    //!     const auto y = countOnes(data, 2, 4);  // returns 2
+    //! \endcode
+    //!
+    //! \note  the bits before the first and after the last whole byte are read with #getBits,
+    //!        the whole bytes in between are counted a word or vector at a time,
+    //!        using AVX-512 VPOPCNTDQ or an AVX2 Harley-Seal kernel when the compiler targets them
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #getBit
+    //!
+    template <typename T>
+    inline size_t countOnes(const T* source, size_t bitOffset, size_t bitCount);
+
+    namespace detail {
+        //!
+        //! \brief  Counts how many bits are set in a run of whole bytes
+        //!
+        inline size_t countOnesInBytes(const uint8_t* source, size_t byteCount);
+
+#if defined(__AVX2__)
+        //!
+        //! \brief  Counts how many bits are set in a run of 32 byte vectors using the Harley-Seal carry-save adder tree
+        //!
+        //! \returns  the count, with \p vectorCount rounded down to a multiple of 16 vectors having been consumed
+        //!
+        inline uint64_t countOnesHarleySeal(const uint8_t* source, size_t vectorCount);
+#endif
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <typename T>
+inline size_t bitter::countOnes(const T* const source, size_t bitOffset, size_t bitCount) {
+    size_t count = 0;
+
+    // bits up to the first byte boundary
+    const size_t headBits = std::min<size_t>((8 - (bitOffset % 8)) % 8, bitCount);
+    count += detail::popCount(getBits(source, bitOffset, headBits));
+    bitOffset += headBits;
+    bitCount -= headBits;
+
+    // whole bytes
+    const size_t byteCount = bitCount / 8;
+    count += detail::countOnesInBytes(detail::asBytes(source) + (bitOffset / 8), byteCount);
+    bitOffset += byteCount * 8;
+    bitCount -= byteCount * 8;
+
+    // bits after the last whole byte
+    count += detail::popCount(getBits(source, bitOffset, bitCount));
+
+    return count;
+}
+
+#if defined(__AVX2__)
+namespace bitter {
+    namespace detail {
+        // a carry-save adder: counts the ones in each bit position of a, b and c,
+        // leaving the low bit of each count in low and the high bit in high
+        inline void carrySaveAdd(__m256i& high, __m256i& low, const __m256i a, const __m256i b, const __m256i c) {
+            const __m256i u = _mm256_xor_si256(a, b);
+            high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+            low = _mm256_xor_si256(u, c);
+        }
+
+        // per 64-bit lane bit counts, using a nibble lookup table
+        inline __m256i popCount256(const __m256i value) {
+            const __m256i lookup = _mm256_setr_epi8(
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+            );
+
+            const __m256i lowNibbleMask = _mm256_set1_epi8(0x0F);
+
+            const __m256i lowNibbles = _mm256_and_si256(value, lowNibbleMask);
+            const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowNibbleMask);
+
+            const __m256i byteCounts = _mm256_add_epi8(
+                _mm256_shuffle_epi8(lookup, lowNibbles),
+                _mm256_shuffle_epi8(lookup, highNibbles)
+            );
+
+            return _mm256_sad_epu8(byteCounts, _mm256_setzero_si256());
+        }
+    }
+}
+
+inline uint64_t bitter::detail::countOnesHarleySeal(const uint8_t* const source, const size_t vectorCount) {
+    const auto load = [source](const size_t index) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source) + index);
+    };
+
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256();
+    __m256i twos = _mm256_setzero_si256();
+    __m256i fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256();
+    __m256i sixteens;
+
+    __m256i twosA, twosB, foursA, foursB, eightsA, eightsB;
+
+    size_t i = 0;
+
+    for(; i + 16 <= vectorCount; i += 16) {
+        carrySaveAdd(twosA, ones, ones, load(i + 0), load(i + 1));
+        carrySaveAdd(twosB, ones, ones, load(i + 2), load(i + 3));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, load(i + 4), load(i + 5));
+        carrySaveAdd(twosB, ones, ones, load(i + 6), load(i + 7));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd(twosA, ones, ones, load(i + 8), load(i + 9));
+        carrySaveAdd(twosB, ones, ones, load(i + 10), load(i + 11));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, load(i + 12), load(i + 13));
+        carrySaveAdd(twosB, ones, ones, load(i + 14), load(i + 15));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd(sixteens, eights, eights, eightsA, eightsB);
+
+        total = _mm256_add_epi64(total, popCount256(sixteens));
+    }
+
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popCount256(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popCount256(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popCount256(twos), 1));
+    total = _mm256_add_epi64(total, popCount256(ones));
+
+    return static_cast<uint64_t>(_mm256_extract_epi64(total, 0))
+         + static_cast<uint64_t>(_mm256_extract_epi64(total, 1))
+         + static_cast<uint64_t>(_mm256_extract_epi64(total, 2))
+         + static_cast<uint64_t>(_mm256_extract_epi64(total, 3));
+}
+#endif
+
+inline size_t bitter::detail::countOnesInBytes(const uint8_t* source, size_t byteCount) {
+    size_t count = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i total = _mm512_setzero_si512();
+
+    for(; byteCount >= 64; byteCount -= 64, source += 64) {
+        total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_loadu_si512(source)));
+    }
+
+    count += static_cast<size_t>(_mm512_reduce_add_epi64(total));
+#elif defined(__AVX2__)
+    // the adder tree only pays off with a few blocks of 16 vectors to chew through
+    if(byteCount >= 32 * 16) {
+        const size_t blockBytes = (byteCount / (32 * 16)) * (32 * 16);
+
+        count += static_cast<size_t>(countOnesHarleySeal(source, blockBytes / 32));
+        source += blockBytes;
+        byteCount -= blockBytes;
+    }
+#endif
+
+    for(; byteCount >= 8; byteCount -= 8, source += 8) {
+        count += popCount(loadLittleEndian64(source));
+    }
+
+    for(; byteCount > 0; --byteCount, ++source) {
+        count += popCount(*source);
+    }
+
+    return count;
+}
@@ -0,0 +1,482 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_word.hpp>
+
+// PEXT and PDEP are used whenever the CPU running the code has fast ones, which is checked once at runtime:
+// AMD CPUs before Zen 3 implement them in microcode, taking hundreds of cycles, so a compile-time
+// __BMI2__ (as set by -march=znver2) is not enough to pick them. The 64-bit intrinsics only exist on x86-64,
+// so 32-bit x86 builds always take the portable path.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define BITTER_RUNTIME_BMI2 1
+#define BITTER_TARGET_BMI2 __attribute__((target("bmi2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#define BITTER_RUNTIME_BMI2 1
+#define BITTER_TARGET_BMI2
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Gathers the bits of a value selected by a mask into the low bits of the result
+    //!
+    //! \param[in]  value  where to take the bits from
+    //! \param[in]  mask   which bits of \p value to take
+    //!
+    //! \returns  bit i of the result is the bit of \p value under the i-th set bit of \p mask,
+    //!           counting from the least significant bit
+    //!
+    //! \par Example
+    //! \code
+    //!     const auto x = extractBits(uint64_t(0b10110010), uint64_t(0b11110000)); // returns 0b1011
+    //! \endcode
+    //!
+    //! \note  uses PEXT on CPUs where it is fast, and otherwise moves
+    //!        each run of set bits in \p mask with one shift and AND
+    //!
+    //! \see  #depositBits
+    //!
+    inline uint64_t extractBits(uint64_t value, uint64_t mask);
+
+    //!
+    //! \brief  Gathers the bits of a 32-bit value selected by a mask into the low bits of the result
+    //!
+    //! \see  #extractBits
+    //!
+    inline uint32_t extractBits(uint32_t value, uint32_t mask);
+
+    //!
+    //! \brief  Gathers the bits selected by the same mask out of many values
+    //!
+    //! \param[in]   source  the values
+    //! \param[in]   mask    which bits of each value to take
+    //! \param[out]  target  where to store the results, may be \p source
+    //! \param[in]   count   how many values to process
+    //!
+    //! \note  the CPU check happens once per call, and without fast PEXT the mask is turned
+    //!        into six masked shifts up front, so each value then costs the same however
+    //!        scattered the mask is
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source and \p target pointers, so make sure they
+    //!           point to valid memory!
+    //!
+    //! \see  #extractBits
+    //!
+    inline void extractBits(const uint64_t* source, uint64_t mask, uint64_t* target, size_t count);
+
+    //!
+    //! \brief  Gathers the bits selected by the same mask out of many 32-bit values
+    //!
+    //! \see  #extractBits
+    //!
+    inline void extractBits(const uint32_t* source, uint32_t mask, uint32_t* target, size_t count);
+
+    //!
+    //! \brief  Scatters the low bits of a value to the positions of the set bits of a mask
+    //!
+    //! \param[in]  value  where to take the bits from, starting at the least significant bit
+    //! \param[in]  mask   where to put the bits
+    //!
+    //! \returns  the bit under the i-th set bit of \p mask is bit i of \p value,
+    //!           all bits outside \p mask are clear
+    //!
+    //! \par Example
+    //! \code
+    //!     const auto x = depositBits(uint64_t(0b1011), uint64_t(0b11110000)); // returns 0b10110000
+    //! \endcode
+    //!
+    //! \note  uses PDEP on CPUs where it is fast, and otherwise moves
+    //!        each run of set bits in \p mask with one shift and AND
+    //!
+    //! \see  #extractBits
+    //!
+    inline uint64_t depositBits(uint64_t value, uint64_t mask);
+
+    //!
+    //! \brief  Scatters the low bits of a 32-bit value to the positions of the set bits of a mask
+    //!
+    //! \see  #depositBits
+    //!
+    inline uint32_t depositBits(uint32_t value, uint32_t mask);
+
+    //!
+    //! \brief  Scatters the low bits of many values under the same mask
+    //!
+    //! \param[in]   source  the values
+    //! \param[in]   mask    where to put the bits of each value
+    //! \param[out]  target  where to store the results, may be \p source
+    //! \param[in]   count   how many values to process
+    //!
+    //! \note  the CPU check happens once per call, and without fast PDEP the mask is
+    //!        turned into six masked shifts up front, as for the array #extractBits
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source and \p target pointers, so make sure they
+    //!           point to valid memory!
+    //!
+    //! \see  #depositBits
+    //!
+    inline void depositBits(const uint64_t* source, uint64_t mask, uint64_t* target, size_t count);
+
+    //!
+    //! \brief  Scatters the low bits of many 32-bit values under the same mask
+    //!
+    //! \see  #depositBits
+    //!
+    inline void depositBits(const uint32_t* source, uint32_t mask, uint32_t* target, size_t count);
+
+    namespace detail {
+        //!
+        //! \brief  Checks, once, whether the CPU has PEXT and PDEP and they are not microcoded
+        //!
+        inline bool hasFastBmi2();
+
+        //!
+        //! \brief  Does the CPUID queries behind #hasFastBmi2
+        //!
+        inline bool detectFastBmi2();
+
+        //!
+        //! \brief  #extractBits without PEXT, a shift and AND per run of set bits in the mask
+        //!
+        inline uint64_t extractBitsPortable(uint64_t value, uint64_t mask);
+
+        //!
+        //! \brief  #depositBits without PDEP, a shift and AND per run of set bits in the mask
+        //!
+        inline uint64_t depositBitsPortable(uint64_t value, uint64_t mask);
+
+        //!
+        //! \brief  A mask broken down into the bits that move by 1, 2, 4, 8, 16 and 32 places
+        //!         when it is compressed, after Hacker's Delight 7-4 and 7-5
+        //!
+        struct BitMaskPlan {
+            explicit BitMaskPlan(uint64_t bitMask);
+
+            uint64_t extract(uint64_t value) const;
+            uint64_t deposit(uint64_t value) const;
+
+            uint64_t mask;
+            uint64_t moves[6];
+        };
+
+#if defined(BITTER_RUNTIME_BMI2)
+        BITTER_TARGET_BMI2 inline uint64_t extractBitsWithBmi2(uint64_t value, uint64_t mask);
+        BITTER_TARGET_BMI2 inline uint32_t extractBitsWithBmi2(uint32_t value, uint32_t mask);
+        BITTER_TARGET_BMI2 inline uint64_t depositBitsWithBmi2(uint64_t value, uint64_t mask);
+        BITTER_TARGET_BMI2 inline uint32_t depositBitsWithBmi2(uint32_t value, uint32_t mask);
+
+        //!
+        //! \brief  The array loops compiled for BMI2, so PEXT and PDEP are inlined into them
+        //!
+        template <typename T>
+        BITTER_TARGET_BMI2 inline void extractBitsWithBmi2(const T* source, T mask, T* target, size_t count);
+
+        template <typename T>
+        BITTER_TARGET_BMI2 inline void depositBitsWithBmi2(const T* source, T mask, T* target, size_t count);
+#endif
+
+        //!
+        //! \brief  The array loops without PEXT and PDEP
+        //!
+        template <typename T>
+        inline void extractBitsPortable(const T* source, T mask, T* target, size_t count);
+
+        template <typename T>
+        inline void depositBitsPortable(const T* source, T mask, T* target, size_t count);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+inline uint64_t bitter::extractBits(const uint64_t value, const uint64_t mask) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        return detail::extractBitsWithBmi2(value, mask);
+    }
+#endif
+
+    return detail::extractBitsPortable(value, mask);
+}
+
+inline uint32_t bitter::extractBits(const uint32_t value, const uint32_t mask) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        return detail::extractBitsWithBmi2(value, mask);
+    }
+#endif
+
+    return static_cast<uint32_t>(detail::extractBitsPortable(value, mask));
+}
+
+inline void bitter::extractBits(const uint64_t* const source, const uint64_t mask, uint64_t* const target, const size_t count) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        detail::extractBitsWithBmi2(source, mask, target, count);
+        return;
+    }
+#endif
+
+    detail::extractBitsPortable(source, mask, target, count);
+}
+
+inline void bitter::extractBits(const uint32_t* const source, const uint32_t mask, uint32_t* const target, const size_t count) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        detail::extractBitsWithBmi2(source, mask, target, count);
+        return;
+    }
+#endif
+
+    detail::extractBitsPortable(source, mask, target, count);
+}
+
+inline uint64_t bitter::depositBits(const uint64_t value, const uint64_t mask) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        return detail::depositBitsWithBmi2(value, mask);
+    }
+#endif
+
+    return detail::depositBitsPortable(value, mask);
+}
+
+inline uint32_t bitter::depositBits(const uint32_t value, const uint32_t mask) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        return detail::depositBitsWithBmi2(value, mask);
+    }
+#endif
+
+    return static_cast<uint32_t>(detail::depositBitsPortable(value, mask));
+}
+
+inline void bitter::depositBits(const uint64_t* const source, const uint64_t mask, uint64_t* const target, const size_t count) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        detail::depositBitsWithBmi2(source, mask, target, count);
+        return;
+    }
+#endif
+
+    detail::depositBitsPortable(source, mask, target, count);
+}
+
+inline void bitter::depositBits(const uint32_t* const source, const uint32_t mask, uint32_t* const target, const size_t count) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(detail::hasFastBmi2()) {
+        detail::depositBitsWithBmi2(source, mask, target, count);
+        return;
+    }
+#endif
+
+    detail::depositBitsPortable(source, mask, target, count);
+}
+
+inline bool bitter::detail::hasFastBmi2() {
+    // a function local static is initialised once, thread safely, and shared by every translation unit
+    static const bool fast = detectFastBmi2();
+    return fast;
+}
+
+inline bool bitter::detail::detectFastBmi2() {
+#if defined(BITTER_RUNTIME_BMI2)
+    unsigned int registers[4] = { };
+
+#if defined(_MSC_VER)
+    const auto cpuid = [&registers](const unsigned int leaf) {
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), 0);
+
+        for(size_t i = 0; i < 4; ++i) {
+            registers[i] = static_cast<unsigned int>(values[i]);
+        }
+    };
+#else
+    const auto cpuid = [&registers](const unsigned int leaf) {
+        __cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+    };
+#endif
+
+    cpuid(0);
+    const unsigned int maxLeaf = registers[0];
+
+    // "AuthenticAMD" and "HygonGenuine" (a Zen 1 licensee), as spelled out by EBX
+    const bool isAmd = registers[1] == 0x68747541 || registers[1] == 0x6F677948;
+
+    if(maxLeaf < 7) {
+        return false;
+    }
+
+    cpuid(7);
+
+    // BMI2 is bit 8 of EBX
+    if((registers[1] & (1u << 8)) == 0) {
+        return false;
+    }
+
+    cpuid(1);
+
+    unsigned int family = (registers[0] >> 8) & 0xF;
+    if(family == 0xF) {
+        family += (registers[0] >> 20) & 0xFF;
+    }
+
+    // Excavator and Zen 1 and 2 are families 0x15 to 0x18, Zen 3 is 0x19
+    return ! isAmd || family >= 0x19;
+#else
+    return false;
+#endif
+}
+
+inline uint64_t bitter::detail::extractBitsPortable(const uint64_t value, uint64_t mask) {
+    uint64_t result = 0;
+    size_t resultBits = 0;
+
+    while(mask != 0) {
+        // adding the lowest set bit carries through the lowest run and clears it
+        const uint64_t run = mask & ~(mask + (mask & (~mask + 1)));
+
+        result |= (value & run) >> (static_cast<size_t>(countTrailingZeros(run)) - resultBits);
+        resultBits += static_cast<size_t>(popCount(run));
+        mask ^= run;
+    }
+
+    return result;
+}
+
+inline uint64_t bitter::detail::depositBitsPortable(const uint64_t value, uint64_t mask) {
+    uint64_t result = 0;
+    size_t valueBits = 0;
+
+    while(mask != 0) {
+        const uint64_t run = mask & ~(mask + (mask & (~mask + 1)));
+
+        result |= (value << (static_cast<size_t>(countTrailingZeros(run)) - valueBits)) & run;
+        valueBits += static_cast<size_t>(popCount(run));
+        mask ^= run;
+    }
+
+    return result;
+}
+
+inline bitter::detail::BitMaskPlan::BitMaskPlan(const uint64_t bitMask)
+    : mask(bitMask) {
+    uint64_t remaining = bitMask;
+
+    // the bits with a zero below them that have to move right, by 1 << step places at step
+    uint64_t zerosBelow = ~bitMask << 1;
+
+    for(size_t step = 0; step < 6; ++step) {
+        // parallel suffix XOR: bit i is set if the number of zeros below it is odd
+        uint64_t oddZerosBelow = zerosBelow ^ (zerosBelow << 1);
+        oddZerosBelow ^= oddZerosBelow << 2;
+        oddZerosBelow ^= oddZerosBelow << 4;
+        oddZerosBelow ^= oddZerosBelow << 8;
+        oddZerosBelow ^= oddZerosBelow << 16;
+        oddZerosBelow ^= oddZerosBelow << 32;
+
+        moves[step] = oddZerosBelow & remaining;
+        remaining = (remaining ^ moves[step]) | (moves[step] >> (size_t(1) << step));
+        zerosBelow &= ~oddZerosBelow;
+    }
+}
+
+inline uint64_t bitter::detail::BitMaskPlan::extract(uint64_t value) const {
+    value &= mask;
+
+    for(size_t step = 0; step < 6; ++step) {
+        const uint64_t moving = value & moves[step];
+        value = (value ^ moving) | (moving >> (size_t(1) << step));
+    }
+
+    return value;
+}
+
+inline uint64_t bitter::detail::BitMaskPlan::deposit(uint64_t value) const {
+    // undoing the moves of #extract in reverse order
+    for(size_t step = 6; step-- > 0;) {
+        value = (value & ~moves[step]) | ((value << (size_t(1) << step)) & moves[step]);
+    }
+
+    return value & mask;
+}
+
+#if defined(BITTER_RUNTIME_BMI2)
+BITTER_TARGET_BMI2 inline uint64_t bitter::detail::extractBitsWithBmi2(const uint64_t value, const uint64_t mask) {
+    return _pext_u64(value, mask);
+}
+
+BITTER_TARGET_BMI2 inline uint32_t bitter::detail::extractBitsWithBmi2(const uint32_t value, const uint32_t mask) {
+    return _pext_u32(value, mask);
+}
+
+BITTER_TARGET_BMI2 inline uint64_t bitter::detail::depositBitsWithBmi2(const uint64_t value, const uint64_t mask) {
+    return _pdep_u64(value, mask);
+}
+
+BITTER_TARGET_BMI2 inline uint32_t bitter::detail::depositBitsWithBmi2(const uint32_t value, const uint32_t mask) {
+    return _pdep_u32(value, mask);
+}
+
+template <typename T>
+BITTER_TARGET_BMI2 inline void bitter::detail::extractBitsWithBmi2(const T* const source, const T mask, T* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = extractBitsWithBmi2(source[i], mask);
+    }
+}
+
+template <typename T>
+BITTER_TARGET_BMI2 inline void bitter::detail::depositBitsWithBmi2(const T* const source, const T mask, T* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = depositBitsWithBmi2(source[i], mask);
+    }
+}
+#endif
+
+template <typename T>
+inline void bitter::detail::extractBitsPortable(const T* const source, const T mask, T* const target, const size_t count) {
+    const BitMaskPlan plan(mask);
+
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = static_cast<T>(plan.extract(source[i]));
+    }
+}
+
+template <typename T>
+inline void bitter::detail::depositBitsPortable(const T* const source, const T mask, T* const target, const size_t count) {
+    const BitMaskPlan plan(mask);
+
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = static_cast<T>(plan.deposit(source[i]));
+    }
+}
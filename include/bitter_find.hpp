@@ -0,0 +1,412 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Finds the first set bit
+    //!
+    //! \tparam  T  the type the source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //!
+    //! \returns  the index of the first bit that is #Bit::One,
+    //!           or \p bitCount if there is none
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0x00, 0x14 };
+    //!     const auto x = findFirstSet(data, 16);     // returns 10
+    //!     const auto y = findNextSet(data, 16, 11);  // returns 12
+    //!     const auto z = findNextSet(data, 16, 13);  // returns 16
+    //! \endcode
+    //!
+    //! \note  the bits are scanned a word at a time, so runs of zeros are cheap to skip
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #findNextSet
+    //! \see  #findLastSet
+    //! \see  #eachSetBit
+    //!
+    template <typename T>
+    inline size_t findFirstSet(const T* source, size_t bitCount);
+
+    //!
+    //! \brief  Finds the first set bit at or after a given bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //! \param[in]  from      the first bit to look at (zero-indexed)
+    //!
+    //! \returns  the index of the first bit at or after \p from that is #Bit::One,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findNextSet(const T* source, size_t bitCount, size_t from);
+
+    //!
+    //! \brief  Finds the first clear bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //!
+    //! \returns  the index of the first bit that is #Bit::Zero,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findFirstClear(const T* source, size_t bitCount);
+
+    //!
+    //! \brief  Finds the first clear bit at or after a given bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //! \param[in]  from      the first bit to look at (zero-indexed)
+    //!
+    //! \returns  the index of the first bit at or after \p from that is #Bit::Zero,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findNextClear(const T* source, size_t bitCount, size_t from);
+
+    //!
+    //! \brief  Finds the last set bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //!
+    //! \returns  the index of the last bit that is #Bit::One,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findLastSet(const T* source, size_t bitCount);
+
+    //!
+    //! \brief  Finds the last set bit at or before a given bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //! \param[in]  from      the last bit to look at (zero-indexed)
+    //!
+    //! \returns  the index of the last bit at or before \p from that is #Bit::One,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findPreviousSet(const T* source, size_t bitCount, size_t from);
+
+    //!
+    //! \brief  Finds the last clear bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //!
+    //! \returns  the index of the last bit that is #Bit::Zero,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findLastClear(const T* source, size_t bitCount);
+
+    //!
+    //! \brief  Finds the last clear bit at or before a given bit
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //! \param[in]  from      the last bit to look at (zero-indexed)
+    //!
+    //! \returns  the index of the last bit at or before \p from that is #Bit::Zero,
+    //!           or \p bitCount if there is none
+    //!
+    //! \see  #findFirstSet
+    //!
+    template <typename T>
+    inline size_t findPreviousClear(const T* source, size_t bitCount, size_t from);
+
+    //!
+    //! \brief  Walks the indices of the set bits in a buffer, in increasing order
+    //!
+    //! \see  #eachSetBit
+    //!
+    class SetBitIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t*;
+        using reference = const size_t&;
+
+        //!
+        //! \brief  Creates an iterator at the first set bit at or after \p from
+        //!
+        SetBitIterator(const uint8_t* source, size_t bitCount, size_t from);
+
+        reference operator*() const;
+        SetBitIterator& operator++();
+        SetBitIterator operator++(int);
+
+        bool operator==(const SetBitIterator& rhs) const;
+        bool operator!=(const SetBitIterator& rhs) const;
+
+    private:
+        void seek(size_t from);
+
+        const uint8_t* m_source;
+        size_t m_bitCount;
+
+        // the set bit the iterator is on, or m_bitCount at the end
+        size_t m_current;
+
+        // the not yet visited set bits of the word starting at m_current's word
+        uint64_t m_word;
+        size_t m_wordStart;
+    };
+
+    //!
+    //! \brief  The range returned by #eachSetBit
+    //!
+    class SetBitRange {
+    public:
+        SetBitRange(const uint8_t* source, size_t bitCount);
+
+        SetBitIterator begin() const;
+        SetBitIterator end() const;
+
+    private:
+        const uint8_t* m_source;
+        size_t m_bitCount;
+    };
+
+    //!
+    //! \brief  Lets the indices of the set bits be used in a range-based for loop
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits \p source holds
+    //!
+    //! \returns  a range over the indices of the bits that are #Bit::One
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0x00, 0x14 };
+    //!     for(const size_t bitNumber : eachSetBit(data, 16)) {
+    //!         // visits 10 then 12
+    //!     }
+    //! \endcode
+    //!
+    //! \warning  the range does not copy the buffer,
+    //!           so make sure it outlives the range!
+    //!
+    template <typename T>
+    inline SetBitRange eachSetBit(const T* source, size_t bitCount);
+
+    namespace detail {
+        template <bool FindClear>
+        inline size_t findNext(const uint8_t* source, size_t bitCount, size_t from);
+
+        template <bool FindClear>
+        inline size_t findPrevious(const uint8_t* source, size_t bitCount, size_t from);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <bool FindClear>
+inline size_t bitter::detail::findNext(const uint8_t* const source, const size_t bitCount, size_t from) {
+    while(from < bitCount) {
+        // the first chunk ends on a 64 bit boundary, so every later chunk is a single word load
+        const size_t chunkBits = std::min<size_t>(64 - (from % 64), bitCount - from);
+
+        uint64_t word = getBits(source, from, chunkBits);
+
+        if(FindClear) {
+            word = ~word & lowBitMask(chunkBits);
+        }
+
+        if(word != 0) {
+            return from + countTrailingZeros(word);
+        }
+
+        from += chunkBits;
+    }
+
+    return bitCount;
+}
+
+template <bool FindClear>
+inline size_t bitter::detail::findPrevious(const uint8_t* const source, const size_t bitCount, const size_t from) {
+    // one past the last bit that still needs looking at
+    size_t end = std::min<size_t>(from + 1, bitCount);
+
+    while(end > 0) {
+        // every chunk but the first starts and ends on a 64 bit boundary
+        const size_t chunkBits = (end % 64) != 0 ? (end % 64) : 64;
+        const size_t start = end - chunkBits;
+
+        uint64_t word = getBits(source, start, chunkBits);
+
+        if(FindClear) {
+            word = ~word & lowBitMask(chunkBits);
+        }
+
+        if(word != 0) {
+            return start + 63 - countLeadingZeros(word);
+        }
+
+        end = start;
+    }
+
+    return bitCount;
+}
+
+template <typename T>
+inline size_t bitter::findFirstSet(const T* const source, const size_t bitCount) {
+    return detail::findNext<false>(detail::asBytes(source), bitCount, 0);
+}
+
+template <typename T>
+inline size_t bitter::findNextSet(const T* const source, const size_t bitCount, const size_t from) {
+    return detail::findNext<false>(detail::asBytes(source), bitCount, from);
+}
+
+template <typename T>
+inline size_t bitter::findFirstClear(const T* const source, const size_t bitCount) {
+    return detail::findNext<true>(detail::asBytes(source), bitCount, 0);
+}
+
+template <typename T>
+inline size_t bitter::findNextClear(const T* const source, const size_t bitCount, const size_t from) {
+    return detail::findNext<true>(detail::asBytes(source), bitCount, from);
+}
+
+template <typename T>
+inline size_t bitter::findLastSet(const T* const source, const size_t bitCount) {
+    return bitCount == 0 ? 0 : detail::findPrevious<false>(detail::asBytes(source), bitCount, bitCount - 1);
+}
+
+template <typename T>
+inline size_t bitter::findPreviousSet(const T* const source, const size_t bitCount, const size_t from) {
+    return detail::findPrevious<false>(detail::asBytes(source), bitCount, from);
+}
+
+template <typename T>
+inline size_t bitter::findLastClear(const T* const source, const size_t bitCount) {
+    return bitCount == 0 ? 0 : detail::findPrevious<true>(detail::asBytes(source), bitCount, bitCount - 1);
+}
+
+template <typename T>
+inline size_t bitter::findPreviousClear(const T* const source, const size_t bitCount, const size_t from) {
+    return detail::findPrevious<true>(detail::asBytes(source), bitCount, from);
+}
+
+template <typename T>
+inline bitter::SetBitRange bitter::eachSetBit(const T* const source, const size_t bitCount) {
+    return SetBitRange(detail::asBytes(source), bitCount);
+}
+
+namespace bitter {
+    inline SetBitIterator::SetBitIterator(const uint8_t* const source, const size_t bitCount, const size_t from)
+    : m_source(source),
+      m_bitCount(bitCount) {
+        seek(from);
+    }
+
+    inline SetBitIterator::reference SetBitIterator::operator*() const {
+        return m_current;
+    }
+
+    inline SetBitIterator& SetBitIterator::operator++() {
+        // clear the bit we're on, the next set bit of the word (if any) is the new lowest one
+        m_word &= m_word - 1;
+
+        if(m_word != 0) {
+            m_current = m_wordStart + detail::countTrailingZeros(m_word);
+        } else {
+            seek(m_wordStart + 64);
+        }
+
+        return *this;
+    }
+
+    inline SetBitIterator SetBitIterator::operator++(int) {
+        SetBitIterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    inline bool SetBitIterator::operator==(const SetBitIterator& rhs) const {
+        return m_source == rhs.m_source && m_current == rhs.m_current;
+    }
+
+    inline bool SetBitIterator::operator!=(const SetBitIterator& rhs) const {
+        return ! (*this == rhs);
+    }
+
+    inline void SetBitIterator::seek(const size_t from) {
+        m_current = detail::findNext<false>(m_source, m_bitCount, from);
+        m_wordStart = m_current;
+        m_word = 0;
+
+        if(m_current < m_bitCount) {
+            m_word = getBits(m_source, m_current, std::min<size_t>(64, m_bitCount - m_current));
+        }
+    }
+
+    inline SetBitRange::SetBitRange(const uint8_t* const source, const size_t bitCount)
+    : m_source(source),
+      m_bitCount(bitCount) {
+
+    }
+
+    inline SetBitIterator SetBitRange::begin() const {
+        return SetBitIterator(m_source, m_bitCount, 0);
+    }
+
+    inline SetBitIterator SetBitRange::end() const {
+        return SetBitIterator(m_source, m_bitCount, m_bitCount);
+    }
+}
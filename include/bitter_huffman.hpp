@@ -0,0 +1,424 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bitter_bit.hpp>
+#include <bitter_bit_reader.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Decodes a canonical Huffman (prefix) code with lookup tables
+    //!
+    //! \tparam  Order  the bit order of the stream, BitOrder::LsbFirst for DEFLATE or BitOrder::MsbFirst for JPEG;
+    //!                 either way the first bit of a code in the stream is its most significant
+    //!
+    //! \par Example
+    //! \code
+    //!     // codes: symbol 0 is 0, symbol 1 is 10, symbol 2 is 11
+    //!     constexpr uint8_t codeLengths[] = { 1, 2, 2 };
+    //!     const MsbHuffmanDecoder decoder(codeLengths, 3);
+    //!
+    //!     constexpr uint8_t data[] = { 0b01100000 };
+    //!     MsbBitReader reader(data, sizeof(data));
+    //!     const auto x = decoder.decode(reader); // returns 0
+    //!     const auto y = decoder.decode(reader); // returns 2
+    //! \endcode
+    //!
+    //! \note  The first #rootBits bits of a code index a root table. Codes that are longer
+    //!        lead to a sub-table sized for the longest code sharing those bits, so a
+    //!        symbol takes at most two lookups. Where a short code leaves enough bits of
+    //!        the root index over to hold another complete code, the root entry holds both
+    //!        symbols, and decoding into an array takes a single lookup for the pair.
+    //!
+    template <BitOrder Order>
+    class BasicHuffmanDecoder {
+    public:
+        //!
+        //! \brief  The longest code length supported
+        //!
+        static constexpr size_t maxCodeLength = 16;
+
+        //!
+        //! \brief  The most bits the root table is indexed by
+        //!
+        static constexpr size_t rootBits = 10;
+
+        //!
+        //! \brief  Returned by decode() for a bit pattern that is not a code
+        //!
+        static constexpr size_t invalidSymbol = ~size_t(0);
+
+        //!
+        //! \brief  Builds the tables for the canonical code with the given code lengths, as DEFLATE describes its codes
+        //!
+        //! \param[in]  codeLengths  the code length of each symbol, 0 if the symbol does not occur
+        //! \param[in]  symbolCount  how many symbols there are, at most 65536
+        //!
+        //! \note  the code is invalid if a length exceeds #maxCodeLength or the lengths over-subscribe the code space,
+        //!        an incomplete code is fine and its unused bit patterns decode as #invalidSymbol
+        //!
+        //! \see  isValid()
+        //!
+        BasicHuffmanDecoder(const uint8_t* codeLengths, size_t symbolCount);
+
+        //!
+        //! \brief  Builds the tables for a canonical code given as symbol counts per length, as a JPEG DHT segment describes it
+        //!
+        //! \param[in]  countsPerLength  how many codes of each length from 1 to 16 there are
+        //! \param[in]  symbols          the symbols in code order, as many as \p countsPerLength adds up to
+        //!
+        //! \see  isValid()
+        //!
+        BasicHuffmanDecoder(const uint8_t (&countsPerLength)[16], const uint8_t* symbols);
+
+        //!
+        //! \returns  false if the code lengths did not describe a prefix code, true otherwise
+        //!
+        bool isValid() const;
+
+        //!
+        //! \brief  Decodes a single symbol and moves the reader past its code
+        //!
+        //! \param[in,out]  reader  where to read from
+        //!
+        //! \returns  the symbol, or #invalidSymbol if the next bits are not a code, in which case the reader does not move
+        //!
+        size_t decode(BasicBitReader<Order>& reader) const;
+
+        //!
+        //! \brief  Decodes symbols into an array, two per lookup where the root table allows
+        //!
+        //! \param[in,out]  reader  where to read from
+        //! \param[out]     target  where to store the symbols
+        //! \param[in]      count   how many symbols to decode
+        //!
+        //! \returns  how many symbols were decoded, less than \p count if bits that are not a code were met
+        //!
+        size_t decode(BasicBitReader<Order>& reader, uint16_t* target, size_t count) const;
+
+    private:
+        struct Entry {
+            // the first symbol in the low 16 bits and the second in the high 16 bits,
+            // or for a link, where its sub-table starts in m_table
+            uint32_t value;
+
+            // bits taken by the first symbol
+            uint8_t firstBitCount;
+
+            // bits taken by all symbols of the entry
+            uint8_t bitCount;
+
+            // 0 for a link or an unused bit pattern, otherwise 1 or 2
+            uint8_t symbolCount;
+
+            // for a link, how many bits after the root bits index the sub-table
+            uint8_t subTableBits;
+        };
+
+        // symbols and code lengths in code order: by length, then as given
+        void build(const std::vector<uint16_t>& symbols, const std::vector<uint8_t>& codeLengths);
+
+        // sets the entries of a table whose index starts with the given code
+        void fill(size_t tableStart, size_t tableBits, uint32_t code, size_t codeLength, const Entry& entry);
+
+        void pairSymbols();
+
+        size_t rootIndex(uint64_t bits) const;
+        size_t subTableIndex(uint64_t bits, size_t subTableBits) const;
+
+        static uint32_t reverseBits(uint32_t value, size_t bitCount);
+
+        std::vector<Entry> m_table;
+        size_t m_rootBits = 1;
+        bool m_valid = true;
+    };
+
+    //!
+    //! \brief  Decodes Huffman codes from an LSB-first stream, as DEFLATE uses
+    //!
+    using HuffmanDecoder = BasicHuffmanDecoder<BitOrder::LsbFirst>;
+
+    //!
+    //! \brief  Decodes Huffman codes from an MSB-first stream, as JPEG uses
+    //!
+    using MsbHuffmanDecoder = BasicHuffmanDecoder<BitOrder::MsbFirst>;
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    template <BitOrder Order>
+    constexpr size_t BasicHuffmanDecoder<Order>::maxCodeLength;
+
+    template <BitOrder Order>
+    constexpr size_t BasicHuffmanDecoder<Order>::rootBits;
+
+    template <BitOrder Order>
+    constexpr size_t BasicHuffmanDecoder<Order>::invalidSymbol;
+
+    template <BitOrder Order>
+    inline BasicHuffmanDecoder<Order>::BasicHuffmanDecoder(const uint8_t* const codeLengths, const size_t symbolCount) {
+        std::vector<uint16_t> symbols;
+        std::vector<uint8_t> lengths;
+
+        for(size_t length = 1; length <= maxCodeLength; ++length) {
+            for(size_t symbol = 0; symbol < symbolCount; ++symbol) {
+                if(codeLengths[symbol] == length) {
+                    symbols.push_back(static_cast<uint16_t>(symbol));
+                    lengths.push_back(static_cast<uint8_t>(length));
+                }
+            }
+        }
+
+        for(size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            if(codeLengths[symbol] > maxCodeLength) {
+                m_valid = false;
+            }
+        }
+
+        build(symbols, lengths);
+    }
+
+    template <BitOrder Order>
+    inline BasicHuffmanDecoder<Order>::BasicHuffmanDecoder(const uint8_t (&countsPerLength)[16], const uint8_t* const symbols) {
+        std::vector<uint16_t> codeSymbols;
+        std::vector<uint8_t> lengths;
+
+        for(size_t length = 1; length <= 16; ++length) {
+            for(size_t i = 0; i < countsPerLength[length - 1]; ++i) {
+                codeSymbols.push_back(symbols[codeSymbols.size()]);
+                lengths.push_back(static_cast<uint8_t>(length));
+            }
+        }
+
+        build(codeSymbols, lengths);
+    }
+
+    template <BitOrder Order>
+    inline bool BasicHuffmanDecoder<Order>::isValid() const {
+        return m_valid;
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicHuffmanDecoder<Order>::decode(BasicBitReader<Order>& reader) const {
+        const uint64_t bits = reader.peek(maxCodeLength);
+        const Entry* entry = &m_table[rootIndex(bits)];
+
+        if(entry->symbolCount == 0) {
+            if(entry->subTableBits == 0) {
+                return invalidSymbol;
+            }
+
+            entry = &m_table[entry->value + subTableIndex(bits, entry->subTableBits)];
+
+            if(entry->symbolCount == 0) {
+                return invalidSymbol;
+            }
+        }
+
+        reader.skip(entry->firstBitCount);
+        return entry->value & 0xFFFF;
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicHuffmanDecoder<Order>::decode(BasicBitReader<Order>& reader, uint16_t* const target, const size_t count) const {
+        size_t decoded = 0;
+
+        while(decoded < count) {
+            const uint64_t bits = reader.peek(maxCodeLength);
+            const Entry* entry = &m_table[rootIndex(bits)];
+
+            if(entry->symbolCount == 2 && decoded + 1 < count) {
+                target[decoded] = static_cast<uint16_t>(entry->value);
+                target[decoded + 1] = static_cast<uint16_t>(entry->value >> 16);
+                decoded += 2;
+
+                reader.skip(entry->bitCount);
+                continue;
+            }
+
+            if(entry->symbolCount == 0) {
+                if(entry->subTableBits == 0) {
+                    break;
+                }
+
+                entry = &m_table[entry->value + subTableIndex(bits, entry->subTableBits)];
+
+                if(entry->symbolCount == 0) {
+                    break;
+                }
+            }
+
+            target[decoded] = static_cast<uint16_t>(entry->value);
+            ++decoded;
+
+            reader.skip(entry->firstBitCount);
+        }
+
+        return decoded;
+    }
+
+    template <BitOrder Order>
+    inline void BasicHuffmanDecoder<Order>::build(const std::vector<uint16_t>& symbols, const std::vector<uint8_t>& codeLengths) {
+        const size_t longest = codeLengths.empty() ? 1 : codeLengths.back();
+        m_rootBits = std::min(longest, rootBits);
+
+        // the canonical codes, checking none runs out of code space
+        std::vector<uint32_t> codes(symbols.size());
+
+        uint32_t code = 0;
+        size_t previousLength = codeLengths.empty() ? 0 : codeLengths.front();
+
+        for(size_t i = 0; i < symbols.size(); ++i) {
+            code <<= codeLengths[i] - previousLength;
+            previousLength = codeLengths[i];
+
+            if(code >= (uint32_t(1) << codeLengths[i])) {
+                m_valid = false;
+            }
+
+            codes[i] = code++;
+        }
+
+        if(! m_valid) {
+            m_table.assign(size_t(1) << m_rootBits, Entry{ 0, 0, 0, 0, 0 });
+            return;
+        }
+
+        // the longest code starting with each root index decides the size of its sub-table,
+        // and as codes are in order, those sharing root bits are next to each other
+        m_table.assign(size_t(1) << m_rootBits, Entry{ 0, 0, 0, 0, 0 });
+
+        for(size_t i = 0; i < symbols.size(); ++i) {
+            const size_t length = codeLengths[i];
+
+            if(length <= m_rootBits) {
+                const uint32_t value = symbols[i];
+                fill(0, m_rootBits, codes[i], length, Entry{ value, uint8_t(length), uint8_t(length), 1, 0 });
+                continue;
+            }
+
+            const uint32_t prefix = codes[i] >> (length - m_rootBits);
+            const size_t index = Order == BitOrder::MsbFirst ? prefix : reverseBits(prefix, m_rootBits);
+            Entry& link = m_table[index];
+
+            if(link.subTableBits == 0) {
+                size_t last = i;
+                while(last + 1 < symbols.size() && (codes[last + 1] >> (codeLengths[last + 1] - m_rootBits)) == prefix) {
+                    ++last;
+                }
+
+                const size_t subTableBits = codeLengths[last] - m_rootBits;
+                const uint32_t subTableStart = static_cast<uint32_t>(m_table.size());
+
+                // assigning to the link has to happen before the table grows and invalidates it
+                link = Entry{ subTableStart, 0, 0, 0, uint8_t(subTableBits) };
+                m_table.resize(m_table.size() + (size_t(1) << subTableBits), Entry{ 0, 0, 0, 0, 0 });
+            }
+
+            const Entry& current = m_table[index];
+            const uint32_t value = symbols[i];
+
+            fill(current.value, current.subTableBits, codes[i] & uint32_t(detail::lowBitMask(length - m_rootBits)), length - m_rootBits,
+                 Entry{ value, uint8_t(length), uint8_t(length), 1, 0 });
+        }
+
+        pairSymbols();
+    }
+
+    template <BitOrder Order>
+    inline void BasicHuffmanDecoder<Order>::fill(const size_t tableStart, const size_t tableBits, const uint32_t code, const size_t codeLength, const Entry& entry) {
+        const size_t freeBits = tableBits - codeLength;
+
+        for(size_t rest = 0; rest < (size_t(1) << freeBits); ++rest) {
+            // with BitOrder::LsbFirst the first bit of the code is the lowest bit of the index
+            const size_t index = Order == BitOrder::MsbFirst ? ((size_t(code) << freeBits) | rest)
+                                                             : (reverseBits(code, codeLength) | (rest << codeLength));
+            m_table[tableStart + index] = entry;
+        }
+    }
+
+    template <BitOrder Order>
+    inline void BasicHuffmanDecoder<Order>::pairSymbols() {
+        const std::vector<Entry> single(m_table.begin(), m_table.begin() + (size_t(1) << m_rootBits));
+
+        for(size_t index = 0; index < single.size(); ++index) {
+            const Entry& first = single[index];
+
+            if(first.symbolCount != 1 || first.bitCount >= m_rootBits) {
+                continue;
+            }
+
+            // the bits of the index after the first code, with zeros standing in for the bits not known yet
+            const size_t knownBits = m_rootBits - first.bitCount;
+            const size_t nextIndex = Order == BitOrder::MsbFirst ? ((index << first.bitCount) & detail::lowBitMask(m_rootBits))
+                                                                 : (index >> first.bitCount);
+            const Entry& second = single[nextIndex];
+
+            // only a code no longer than the known bits is unaffected by the unknown ones
+            if(second.symbolCount == 1 && second.bitCount <= knownBits) {
+                Entry& pair = m_table[index];
+
+                pair.value |= second.value << 16;
+                pair.bitCount = static_cast<uint8_t>(first.bitCount + second.bitCount);
+                pair.symbolCount = 2;
+            }
+        }
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicHuffmanDecoder<Order>::rootIndex(const uint64_t bits) const {
+        if(Order == BitOrder::MsbFirst) {
+            return static_cast<size_t>(bits >> (maxCodeLength - m_rootBits));
+        }
+
+        return static_cast<size_t>(bits & detail::lowBitMask(m_rootBits));
+    }
+
+    template <BitOrder Order>
+    inline size_t BasicHuffmanDecoder<Order>::subTableIndex(const uint64_t bits, const size_t subTableBits) const {
+        if(Order == BitOrder::MsbFirst) {
+            return static_cast<size_t>((bits >> (maxCodeLength - m_rootBits - subTableBits)) & detail::lowBitMask(subTableBits));
+        }
+
+        return static_cast<size_t>((bits >> m_rootBits) & detail::lowBitMask(subTableBits));
+    }
+
+    template <BitOrder Order>
+    inline uint32_t BasicHuffmanDecoder<Order>::reverseBits(const uint32_t value, const size_t bitCount) {
+        uint32_t reversed = 0;
+
+        for(size_t i = 0; i < bitCount; ++i) {
+            reversed |= ((value >> i) & 1) << (bitCount - 1 - i);
+        }
+
+        return reversed;
+    }
+}
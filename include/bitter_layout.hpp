@@ -0,0 +1,451 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+#include <bitter_bit.hpp>
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Describes a field of a packed record, for use with #BasicLayout
+    //!
+    //! \tparam  Offset  the first bit of the field, numbered as #getBits numbers bits
+    //! \tparam  Width   how many bits the field has, in the range [1, 64]
+    //!
+    template <size_t Offset, size_t Width>
+    struct Field {
+        static_assert(Width >= 1 && Width <= 64, "a Field must be between 1 and 64 bits wide");
+
+        static constexpr size_t offset = Offset;
+        static constexpr size_t width = Width;
+    };
+
+    namespace detail {
+        //!
+        //! \returns  the bit just past the end of the last field
+        //!
+        template <typename... Fields>
+        inline constexpr size_t layoutBitCount();
+
+        //!
+        //! \returns  true if any two fields share a bit
+        //!
+        template <typename... Fields>
+        inline constexpr bool layoutFieldsOverlap();
+
+        //!
+        //! \returns  the bits of word \p word (bit i being bit 64 * \p word + i of the record)
+        //!           that fall in the field starting at \p offset
+        //!
+        inline constexpr uint64_t fieldBitsInWord(size_t offset, size_t width, size_t word);
+
+        //!
+        //! \brief  Moves a field out of and into the words of a record, with every shift known at compile time
+        //!
+        //! \note  words hold the record as loaded by #BasicLayout: for BitOrder::MsbFirst the
+        //!        first bit of a word is its most significant, otherwise its least significant
+        //!
+        template <BitOrder Order, typename FieldType, bool SpansWords = ((FieldType::offset % 64) + FieldType::width > 64)>
+        struct LayoutField {
+            static uint64_t extract(const uint64_t* words);
+            static void insert(uint64_t* words, uint64_t value);
+        };
+
+        template <BitOrder Order, typename FieldType>
+        struct LayoutField<Order, FieldType, true> {
+            static uint64_t extract(const uint64_t* words);
+            static void insert(uint64_t* words, uint64_t value);
+        };
+    }
+
+    //!
+    //! \brief  A packed record layout, from which whole records are decoded and encoded
+    //!
+    //! \tparam  Order   how the bits within each byte are numbered
+    //! \tparam  Fields  the fields, as #Field types, in the order their values are stored in #Values;
+    //!                  they need not be sorted or contiguous but may not overlap
+    //!
+    //! \par Example
+    //! \code
+    //!     using Header = Layout<Field<0, 3>, Field<3, 13>, Field<16, 16>>;
+    //!
+    //!     constexpr uint8_t data[] = { 0x29, 0x01, 0x34, 0x12 };
+    //!     const auto x = Header::decode(data); // returns { 1, 37, 0x1234 }
+    //! \endcode
+    //!
+    //! \note  The record is loaded into registers a 64-bit word at a time, each word once,
+    //!        and every field is then cut out with shifts and masks that are constants
+    //!        of the instantiation, so decoding takes no loops and no per-field loads.
+    //!        Encoding stores each word once, and only loads the words that have bits
+    //!        outside every field, so those bits are kept.
+    //!
+    template <BitOrder Order, typename... Fields>
+    class BasicLayout {
+        static_assert(sizeof...(Fields) > 0, "a Layout needs at least one Field");
+        static_assert(! detail::layoutFieldsOverlap<Fields...>(), "the Fields of a Layout may not overlap");
+
+    public:
+        //!
+        //! \brief  How many fields the record has
+        //!
+        static constexpr size_t fieldCount = sizeof...(Fields);
+
+        //!
+        //! \brief  How many bits the record takes, up to the end of its last field
+        //!
+        static constexpr size_t bitCount = detail::layoutBitCount<Fields...>();
+
+        //!
+        //! \brief  How many bytes the record takes, the only ones decode() and encode() touch
+        //!
+        static constexpr size_t byteCount = (bitCount + 7) / 8;
+
+        //!
+        //! \brief  The values of the fields, in the order the fields were given
+        //!
+        using Values = std::array<uint64_t, sizeof...(Fields)>;
+
+        //!
+        //! \brief  Decodes every field of a record
+        //!
+        //! \tparam  T  the type the source pointer points to,
+        //!             should be inferred from the parameter,
+        //!             do not set this explicitly
+        //!
+        //! \param[in]  source  where the record starts
+        //!
+        //! \returns  the value of each field
+        //!
+        //! \warning  this function necessarily dereferences
+        //!           the \p source pointer, so make sure it
+        //!           points to at least #byteCount bytes!
+        //!
+        template <typename T>
+        static Values decode(const T* source);
+
+        //!
+        //! \brief  Encodes every field of a record
+        //!
+        //! \tparam  T  the type the target pointer points to,
+        //!             should be inferred from the parameter,
+        //!             do not set this explicitly
+        //!
+        //! \param[out]  target  where the record starts
+        //! \param[in]   values  the value of each field, the bits above a field's width are ignored
+        //!
+        //! \note  bits of \p target that are in no field keep their values
+        //!
+        //! \warning  this function necessarily dereferences
+        //!           the \p target pointer, so make sure it
+        //!           points to at least #byteCount bytes!
+        //!
+        template <typename T>
+        static void encode(T* target, const Values& values);
+
+    private:
+        static constexpr size_t wordCount = (byteCount + 7) / 8;
+
+        // how many bytes of the record fall in a word, 8 for all but possibly the last one
+        static constexpr size_t bytesInWord(size_t word);
+
+        // the bits of a word that are in some field, in the word's own bit order
+        static constexpr uint64_t fieldBits(size_t word);
+
+        // whether every bit of a word is in some field, so it can be encoded without loading it first
+        static constexpr bool isCovered(size_t word);
+
+        template <size_t Word>
+        static uint64_t loadWord(const uint8_t* source);
+
+        template <size_t Word>
+        static void storeWord(uint8_t* target, uint64_t word);
+
+        template <size_t... Words>
+        static void loadWords(const uint8_t* source, uint64_t* words, std::index_sequence<Words...>);
+
+        template <size_t... Words>
+        static void loadUncoveredWords(const uint8_t* source, uint64_t* words, std::index_sequence<Words...>);
+
+        template <size_t... Words>
+        static void storeWords(uint8_t* target, const uint64_t* words, std::index_sequence<Words...>);
+
+        template <size_t... Indices>
+        static void extractFields(const uint64_t* words, Values& values, std::index_sequence<Indices...>);
+
+        template <size_t... Indices>
+        static void insertFields(uint64_t* words, const Values& values, std::index_sequence<Indices...>);
+    };
+
+    //!
+    //! \brief  A packed record layout with bits numbered as #getBits numbers them
+    //!
+    template <typename... Fields>
+    using Layout = BasicLayout<BitOrder::LsbFirst, Fields...>;
+
+    //!
+    //! \brief  A packed record layout with bits numbered from the most significant bit of each byte, as network formats do
+    //!
+    template <typename... Fields>
+    using MsbLayout = BasicLayout<BitOrder::MsbFirst, Fields...>;
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    template <size_t Offset, size_t Width>
+    constexpr size_t Field<Offset, Width>::offset;
+
+    template <size_t Offset, size_t Width>
+    constexpr size_t Field<Offset, Width>::width;
+
+    template <typename... Fields>
+    inline constexpr size_t detail::layoutBitCount() {
+        const size_t ends[] = { (Fields::offset + Fields::width)... };
+
+        size_t bitCount = 0;
+        for(const size_t end : ends) {
+            bitCount = end > bitCount ? end : bitCount;
+        }
+
+        return bitCount;
+    }
+
+    template <typename... Fields>
+    inline constexpr bool detail::layoutFieldsOverlap() {
+        const size_t offsets[] = { Fields::offset... };
+        const size_t widths[] = { Fields::width... };
+
+        for(size_t i = 0; i < sizeof...(Fields); ++i) {
+            for(size_t j = i + 1; j < sizeof...(Fields); ++j) {
+                if(offsets[i] < offsets[j] + widths[j] && offsets[j] < offsets[i] + widths[i]) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    inline constexpr uint64_t detail::fieldBitsInWord(const size_t offset, const size_t width, const size_t word) {
+        const size_t begin = offset > word * 64 ? offset : word * 64;
+        const size_t end = offset + width < (word + 1) * 64 ? offset + width : (word + 1) * 64;
+
+        return begin < end ? lowBitMask(end - begin) << (begin - (word * 64)) : 0;
+    }
+
+    template <BitOrder Order, typename FieldType, bool SpansWords>
+    inline uint64_t detail::LayoutField<Order, FieldType, SpansWords>::extract(const uint64_t* const words) {
+        constexpr size_t word = FieldType::offset / 64;
+        constexpr size_t shift = FieldType::offset % 64;
+
+        if(Order == BitOrder::MsbFirst) {
+            return (words[word] << shift) >> (64 - FieldType::width);
+        }
+
+        return (words[word] >> shift) & lowBitMask(FieldType::width);
+    }
+
+    template <BitOrder Order, typename FieldType, bool SpansWords>
+    inline void detail::LayoutField<Order, FieldType, SpansWords>::insert(uint64_t* const words, uint64_t value) {
+        constexpr size_t word = FieldType::offset / 64;
+        constexpr size_t shift = FieldType::offset % 64;
+
+        value &= lowBitMask(FieldType::width);
+
+        if(Order == BitOrder::MsbFirst) {
+            words[word] |= (value << (64 - FieldType::width)) >> shift;
+        } else {
+            words[word] |= value << shift;
+        }
+    }
+
+    template <BitOrder Order, typename FieldType>
+    inline uint64_t detail::LayoutField<Order, FieldType, true>::extract(const uint64_t* const words) {
+        // a field spanning two words never starts at bit 0 of one, so none of these shifts are by 64
+        constexpr size_t word = FieldType::offset / 64;
+        constexpr size_t shift = FieldType::offset % 64;
+
+        if(Order == BitOrder::MsbFirst) {
+            return ((words[word] << shift) | (words[word + 1] >> (64 - shift))) >> (64 - FieldType::width);
+        }
+
+        return ((words[word] >> shift) | (words[word + 1] << (64 - shift))) & lowBitMask(FieldType::width);
+    }
+
+    template <BitOrder Order, typename FieldType>
+    inline void detail::LayoutField<Order, FieldType, true>::insert(uint64_t* const words, uint64_t value) {
+        constexpr size_t word = FieldType::offset / 64;
+        constexpr size_t shift = FieldType::offset % 64;
+
+        value &= lowBitMask(FieldType::width);
+
+        if(Order == BitOrder::MsbFirst) {
+            const uint64_t aligned = value << (64 - FieldType::width);
+
+            words[word] |= aligned >> shift;
+            words[word + 1] |= aligned << (64 - shift);
+        } else {
+            words[word] |= value << shift;
+            words[word + 1] |= value >> (64 - shift);
+        }
+    }
+
+    template <BitOrder Order, typename... Fields>
+    constexpr size_t BasicLayout<Order, Fields...>::fieldCount;
+
+    template <BitOrder Order, typename... Fields>
+    constexpr size_t BasicLayout<Order, Fields...>::bitCount;
+
+    template <BitOrder Order, typename... Fields>
+    constexpr size_t BasicLayout<Order, Fields...>::byteCount;
+
+    template <BitOrder Order, typename... Fields>
+    constexpr size_t BasicLayout<Order, Fields...>::wordCount;
+
+    template <BitOrder Order, typename... Fields>
+    template <typename T>
+    inline typename BasicLayout<Order, Fields...>::Values BasicLayout<Order, Fields...>::decode(const T* const source) {
+        uint64_t words[wordCount];
+        loadWords(detail::asBytes(source), words, std::make_index_sequence<wordCount>());
+
+        Values values;
+        extractFields(words, values, std::index_sequence_for<Fields...>());
+        return values;
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <typename T>
+    inline void BasicLayout<Order, Fields...>::encode(T* const target, const Values& values) {
+        uint8_t* const bytes = detail::asBytes(target);
+
+        uint64_t words[wordCount];
+        loadUncoveredWords(bytes, words, std::make_index_sequence<wordCount>());
+        insertFields(words, values, std::index_sequence_for<Fields...>());
+        storeWords(bytes, words, std::make_index_sequence<wordCount>());
+    }
+
+    template <BitOrder Order, typename... Fields>
+    inline constexpr size_t BasicLayout<Order, Fields...>::bytesInWord(const size_t word) {
+        return byteCount - (word * 8) < 8 ? byteCount - (word * 8) : 8;
+    }
+
+    template <BitOrder Order, typename... Fields>
+    inline constexpr uint64_t BasicLayout<Order, Fields...>::fieldBits(const size_t word) {
+        uint64_t bits = 0;
+
+        const uint64_t masks[] = { detail::fieldBitsInWord(Fields::offset, Fields::width, word)... };
+        for(const uint64_t mask : masks) {
+            bits |= mask;
+        }
+
+        if(Order == BitOrder::MsbFirst) {
+            // bit i of the record is bit (63 - i) of an MSB-first word
+            uint64_t reversed = 0;
+
+            for(size_t bitNumber = 0; bitNumber < 64; ++bitNumber) {
+                reversed |= ((bits >> bitNumber) & 1) << (63 - bitNumber);
+            }
+
+            return reversed;
+        }
+
+        return bits;
+    }
+
+    template <BitOrder Order, typename... Fields>
+    inline constexpr bool BasicLayout<Order, Fields...>::isCovered(const size_t word) {
+        // bits past the last field in its last byte are not in any field, so a partial word is never covered
+        return bytesInWord(word) == 8 && fieldBits(word) == ~uint64_t(0);
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t Word>
+    inline uint64_t BasicLayout<Order, Fields...>::loadWord(const uint8_t* const source) {
+        constexpr size_t bytes = bytesInWord(Word);
+
+        if(bytes == 8) {
+            return Order == BitOrder::MsbFirst ? detail::loadBigEndian64(source + (Word * 8)) : detail::loadLittleEndian64(source + (Word * 8));
+        }
+
+        // the last word is read a byte range at a time so nothing past the record is touched
+        const uint64_t word = getBits<Order>(source, Word * 64, bytes * 8);
+        return Order == BitOrder::MsbFirst ? word << (64 - (bytes * 8)) : word;
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t Word>
+    inline void BasicLayout<Order, Fields...>::storeWord(uint8_t* const target, const uint64_t word) {
+        constexpr size_t bytes = bytesInWord(Word);
+
+        if(bytes == 8) {
+            if(Order == BitOrder::MsbFirst) {
+                detail::storeBigEndian64(target + (Word * 8), word);
+            } else {
+                detail::storeLittleEndian64(target + (Word * 8), word);
+            }
+
+            return;
+        }
+
+        setBits<Order>(target, Word * 64, bytes * 8, Order == BitOrder::MsbFirst ? word >> (64 - (bytes * 8)) : word);
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t... Words>
+    inline void BasicLayout<Order, Fields...>::loadWords(const uint8_t* const source, uint64_t* const words, std::index_sequence<Words...>) {
+        (void) std::initializer_list<int> { (words[Words] = loadWord<Words>(source), 0)... };
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t... Words>
+    inline void BasicLayout<Order, Fields...>::loadUncoveredWords(const uint8_t* const source, uint64_t* const words, std::index_sequence<Words...>) {
+        (void) std::initializer_list<int> { (words[Words] = isCovered(Words) ? 0 : loadWord<Words>(source) & ~fieldBits(Words), 0)... };
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t... Words>
+    inline void BasicLayout<Order, Fields...>::storeWords(uint8_t* const target, const uint64_t* const words, std::index_sequence<Words...>) {
+        (void) std::initializer_list<int> { (storeWord<Words>(target, words[Words]), 0)... };
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t... Indices>
+    inline void BasicLayout<Order, Fields...>::extractFields(const uint64_t* const words, Values& values, std::index_sequence<Indices...>) {
+        (void) std::initializer_list<int> { (values[Indices] = detail::LayoutField<Order, Fields>::extract(words), 0)... };
+    }
+
+    template <BitOrder Order, typename... Fields>
+    template <size_t... Indices>
+    inline void BasicLayout<Order, Fields...>::insertFields(uint64_t* const words, const Values& values, std::index_sequence<Indices...>) {
+        (void) std::initializer_list<int> { (detail::LayoutField<Order, Fields>::insert(words, values[Indices]), 0)... };
+    }
+}
@@ -0,0 +1,531 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_bit.hpp>
+#include <bitter_count.hpp>
+#include <bitter_find.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  A bitmap backed by a memory-mapped file, read and written in place without loading it first
+    //!
+    //! \par Example
+    //! \code
+    //!     MappedBitmap bitmap;
+    //!     bitmap.create("bits.bin", 1000000);
+    //!     bitmap.setBit(12345, Bit::One);
+    //!     bitmap.flush();
+    //!
+    //!     MappedBitmap reopened;
+    //!     reopened.open("bits.bin", MappedBitmap::Mode::ReadOnly);
+    //!     const auto x = reopened.findFirstSet(); // returns 12345
+    //! \endcode
+    //!
+    //! \note  opening a file costs a single mmap, the pages are read by the
+    //!        operating system when they are first touched, so large files open instantly
+    //!
+    //! \note  bits are numbered the same way as #getBit numbers them,
+    //!        and the bitmap holds eight bits per byte of the file
+    //!
+    //! \note  there are no exceptions, functions that can fail return false instead
+    //!
+    class MappedBitmap {
+    public:
+        //!
+        //! \brief  How a file is opened
+        //!
+        enum class Mode {
+            ReadOnly,
+            ReadWrite
+        };
+
+        //!
+        //! \brief  How the bits are going to be accessed, so the operating system can read ahead or not
+        //!
+        enum class Access {
+            Normal,
+            Sequential,
+            Random,
+            WillNeed
+        };
+
+        //!
+        //! \brief  Creates a MappedBitmap without a file, use create() or open() to map one
+        //!
+        MappedBitmap() = default;
+
+        MappedBitmap(const MappedBitmap&) = delete;
+        MappedBitmap& operator=(const MappedBitmap&) = delete;
+
+        MappedBitmap(MappedBitmap&& other);
+        MappedBitmap& operator=(MappedBitmap&& other);
+
+        //!
+        //! \brief  Unmaps the file, changes reach the file eventually even without flush()
+        //!
+        ~MappedBitmap();
+
+        //!
+        //! \brief  Creates (or truncates) a file with all bits clear and maps it for reading and writing
+        //!
+        //! \param[in]  path      the file to create
+        //! \param[in]  bitCount  how many bits the file should hold, rounded up to whole bytes
+        //!
+        //! \returns  true if the file has been created and mapped, false otherwise
+        //!
+        bool create(const char* path, size_t bitCount);
+
+        //!
+        //! \brief  Maps an existing file
+        //!
+        //! \param[in]  path  the file to map
+        //! \param[in]  mode  whether the bits may be changed
+        //!
+        //! \returns  true if the file has been mapped, false otherwise
+        //!
+        bool open(const char* path, Mode mode);
+
+        //!
+        //! \brief  Unmaps the file, if there is one
+        //!
+        void close();
+
+        //!
+        //! \returns  true if a file is mapped, false otherwise
+        //!
+        bool isOpen() const;
+
+        //!
+        //! \returns  true if a file is mapped for reading and writing, false otherwise
+        //!
+        bool isWritable() const;
+
+        //!
+        //! \brief  Tells the operating system how the whole file is going to be accessed
+        //!
+        //! \returns  true if the hint has been accepted, false otherwise
+        //!
+        //! \note  hints are only a matter of speed, on Windows they are accepted and ignored
+        //!
+        bool advise(Access access);
+
+        //!
+        //! \brief  Tells the operating system how a range of bits is going to be accessed
+        //!
+        //! \param[in]  access     the expected access pattern
+        //! \param[in]  bitOffset  the first bit of the range (zero-indexed)
+        //! \param[in]  bitCount   how many bits the range holds
+        //!
+        //! \returns  true if the hint has been accepted, false otherwise
+        //!
+        //! \note  the range is widened to whole pages
+        //!
+        bool advise(Access access, size_t bitOffset, size_t bitCount);
+
+        //!
+        //! \brief  Writes changed pages back to the file and waits until they are written
+        //!
+        //! \returns  true if the changes are in the file (or there are none to write), false otherwise
+        //!
+        bool flush();
+
+        //!
+        //! \returns  how many bits the file holds
+        //!
+        size_t size() const;
+
+        //!
+        //! \returns  how many bytes the file holds
+        //!
+        size_t sizeInBytes() const;
+
+        //!
+        //! \returns  the mapped bytes, or nullptr if no (or an empty) file is mapped
+        //!
+        //! \warning  writing through the pointer of a file opened with Mode::ReadOnly crashes
+        //!
+        uint8_t* data();
+        const uint8_t* data() const;
+
+        //!
+        //! \see  #getBit
+        //!
+        Bit getBit(size_t bitNumber) const;
+
+        //!
+        //! \see  #getBits
+        //!
+        uint64_t getBits(size_t bitOffset, size_t bitCount) const;
+
+        //!
+        //! \warning  the file must be writable
+        //!
+        //! \see  #setBit
+        //!
+        void setBit(size_t bitNumber, Bit bitValue);
+
+        //!
+        //! \warning  the file must be writable
+        //!
+        //! \see  #setBits
+        //!
+        void setBits(size_t bitOffset, size_t bitCount, uint64_t value);
+
+        //!
+        //! \returns  how many bits of the file are #Bit::One
+        //!
+        size_t countOnes() const;
+
+        //!
+        //! \see  #countOnes
+        //!
+        size_t countOnes(size_t bitOffset, size_t bitCount) const;
+
+        //!
+        //! \see  #findFirstSet
+        //! \see  #findNextSet
+        //! \see  #findFirstClear
+        //! \see  #findNextClear
+        //!
+        size_t findFirstSet() const;
+        size_t findNextSet(size_t from) const;
+        size_t findFirstClear() const;
+        size_t findNextClear(size_t from) const;
+
+        //!
+        //! \see  #findLastSet
+        //! \see  #findPreviousSet
+        //! \see  #findLastClear
+        //! \see  #findPreviousClear
+        //!
+        size_t findLastSet() const;
+        size_t findPreviousSet(size_t from) const;
+        size_t findLastClear() const;
+        size_t findPreviousClear(size_t from) const;
+
+    private:
+        bool map(const char* path, Mode mode, bool truncate, size_t sizeInBytes);
+
+        uint8_t* m_data = nullptr;
+        size_t m_sizeInBytes = 0;
+        bool m_open = false;
+        bool m_writable = false;
+    };
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    inline MappedBitmap::MappedBitmap(MappedBitmap&& other)
+    : m_data(other.m_data),
+      m_sizeInBytes(other.m_sizeInBytes),
+      m_open(other.m_open),
+      m_writable(other.m_writable) {
+        other.m_data = nullptr;
+        other.m_sizeInBytes = 0;
+        other.m_open = false;
+        other.m_writable = false;
+    }
+
+    inline MappedBitmap& MappedBitmap::operator=(MappedBitmap&& other) {
+        if(this != &other) {
+            close();
+
+            m_data = other.m_data;
+            m_sizeInBytes = other.m_sizeInBytes;
+            m_open = other.m_open;
+            m_writable = other.m_writable;
+
+            other.m_data = nullptr;
+            other.m_sizeInBytes = 0;
+            other.m_open = false;
+            other.m_writable = false;
+        }
+
+        return *this;
+    }
+
+    inline MappedBitmap::~MappedBitmap() {
+        close();
+    }
+
+    inline bool MappedBitmap::create(const char* const path, const size_t bitCount) {
+        return map(path, Mode::ReadWrite, true, (bitCount + 7) / 8);
+    }
+
+    inline bool MappedBitmap::open(const char* const path, const Mode mode) {
+        return map(path, mode, false, 0);
+    }
+
+    inline void MappedBitmap::close() {
+        if(m_data != nullptr) {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            munmap(m_data, m_sizeInBytes);
+#endif
+        }
+
+        m_data = nullptr;
+        m_sizeInBytes = 0;
+        m_open = false;
+        m_writable = false;
+    }
+
+    inline bool MappedBitmap::isOpen() const {
+        return m_open;
+    }
+
+    inline bool MappedBitmap::isWritable() const {
+        return m_writable;
+    }
+
+    inline bool MappedBitmap::advise(const Access access) {
+        return advise(access, 0, size());
+    }
+
+    inline bool MappedBitmap::advise(const Access access, const size_t bitOffset, const size_t bitCount) {
+        if(m_data == nullptr || bitCount == 0) {
+            return m_open;
+        }
+
+#if defined(_WIN32)
+        (void)access;
+        (void)bitOffset;
+        return true;
+#else
+        // madvise wants a page-aligned start
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t firstByte = ((bitOffset / 8) / pageSize) * pageSize;
+        const size_t endByte = (bitOffset + bitCount + 7) / 8;
+
+        int advice = MADV_NORMAL;
+        switch(access) {
+            case Access::Normal:     advice = MADV_NORMAL;     break;
+            case Access::Sequential: advice = MADV_SEQUENTIAL; break;
+            case Access::Random:     advice = MADV_RANDOM;     break;
+            case Access::WillNeed:   advice = MADV_WILLNEED;   break;
+        }
+
+        return madvise(m_data + firstByte, endByte - firstByte, advice) == 0;
+#endif
+    }
+
+    inline bool MappedBitmap::flush() {
+        if(! m_writable || m_data == nullptr) {
+            return m_open;
+        }
+
+#if defined(_WIN32)
+        return FlushViewOfFile(m_data, m_sizeInBytes) != 0;
+#else
+        return msync(m_data, m_sizeInBytes, MS_SYNC) == 0;
+#endif
+    }
+
+    inline size_t MappedBitmap::size() const {
+        return m_sizeInBytes * 8;
+    }
+
+    inline size_t MappedBitmap::sizeInBytes() const {
+        return m_sizeInBytes;
+    }
+
+    inline uint8_t* MappedBitmap::data() {
+        return m_data;
+    }
+
+    inline const uint8_t* MappedBitmap::data() const {
+        return m_data;
+    }
+
+    inline Bit MappedBitmap::getBit(const size_t bitNumber) const {
+        return bitter::getBit(m_data, bitNumber);
+    }
+
+    inline uint64_t MappedBitmap::getBits(const size_t bitOffset, const size_t bitCount) const {
+        return bitter::getBits(m_data, bitOffset, bitCount);
+    }
+
+    inline void MappedBitmap::setBit(const size_t bitNumber, const Bit bitValue) {
+        bitter::setBit(m_data, bitNumber, bitValue);
+    }
+
+    inline void MappedBitmap::setBits(const size_t bitOffset, const size_t bitCount, const uint64_t value) {
+        bitter::setBits(m_data, bitOffset, bitCount, value);
+    }
+
+    inline size_t MappedBitmap::countOnes() const {
+        return bitter::countOnes(m_data, 0, size());
+    }
+
+    inline size_t MappedBitmap::countOnes(const size_t bitOffset, const size_t bitCount) const {
+        return bitter::countOnes(m_data, bitOffset, bitCount);
+    }
+
+    inline size_t MappedBitmap::findFirstSet() const {
+        return bitter::findFirstSet(m_data, size());
+    }
+
+    inline size_t MappedBitmap::findNextSet(const size_t from) const {
+        return bitter::findNextSet(m_data, size(), from);
+    }
+
+    inline size_t MappedBitmap::findFirstClear() const {
+        return bitter::findFirstClear(m_data, size());
+    }
+
+    inline size_t MappedBitmap::findNextClear(const size_t from) const {
+        return bitter::findNextClear(m_data, size(), from);
+    }
+
+    inline size_t MappedBitmap::findLastSet() const {
+        return bitter::findLastSet(m_data, size());
+    }
+
+    inline size_t MappedBitmap::findPreviousSet(const size_t from) const {
+        return bitter::findPreviousSet(m_data, size(), from);
+    }
+
+    inline size_t MappedBitmap::findLastClear() const {
+        return bitter::findLastClear(m_data, size());
+    }
+
+    inline size_t MappedBitmap::findPreviousClear(const size_t from) const {
+        return bitter::findPreviousClear(m_data, size(), from);
+    }
+
+    inline bool MappedBitmap::map(const char* const path, const Mode mode, const bool truncate, size_t sizeInBytes) {
+        close();
+
+        const bool writable = mode == Mode::ReadWrite;
+
+#if defined(_WIN32)
+        const HANDLE file = CreateFileA(path,
+                                        writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                                        FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                        nullptr,
+                                        truncate ? CREATE_ALWAYS : OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL,
+                                        nullptr);
+
+        if(file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        fileSize.QuadPart = static_cast<LONGLONG>(sizeInBytes);
+
+        if(truncate) {
+            if(! SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) || ! SetEndOfFile(file)) {
+                CloseHandle(file);
+                return false;
+            }
+        } else if(GetFileSizeEx(file, &fileSize)) {
+            sizeInBytes = static_cast<size_t>(fileSize.QuadPart);
+        } else {
+            CloseHandle(file);
+            return false;
+        }
+
+        // an empty file cannot be mapped, but it is a valid empty bitmap
+        if(sizeInBytes != 0) {
+            const HANDLE mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+
+            if(mapping != nullptr) {
+                m_data = static_cast<uint8_t*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, sizeInBytes));
+                CloseHandle(mapping);
+            }
+
+            if(m_data == nullptr) {
+                CloseHandle(file);
+                return false;
+            }
+        }
+
+        // the view keeps the file open
+        CloseHandle(file);
+#else
+        const int flags = writable ? (O_RDWR | (truncate ? (O_CREAT | O_TRUNC) : 0)) : O_RDONLY;
+        const int file = ::open(path, flags, 0644);
+
+        if(file < 0) {
+            return false;
+        }
+
+        struct stat status;
+
+        if(truncate) {
+            if(ftruncate(file, static_cast<off_t>(sizeInBytes)) != 0) {
+                ::close(file);
+                return false;
+            }
+        } else if(fstat(file, &status) == 0) {
+            sizeInBytes = static_cast<size_t>(status.st_size);
+        } else {
+            ::close(file);
+            return false;
+        }
+
+        // an empty file cannot be mapped, but it is a valid empty bitmap
+        if(sizeInBytes != 0) {
+            void* const mapping = mmap(nullptr, sizeInBytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file, 0);
+
+            if(mapping == MAP_FAILED) {
+                ::close(file);
+                return false;
+            }
+
+            m_data = static_cast<uint8_t*>(mapping);
+        }
+
+        // the mapping keeps the file open
+        ::close(file);
+#endif
+
+        m_sizeInBytes = sizeInBytes;
+        m_open = true;
+        m_writable = writable;
+
+        return true;
+    }
+}
@@ -0,0 +1,326 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_extract_deposit.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    namespace detail {
+        //!
+        //! \brief  The Morton code types for each coordinate type, left undefined for unsupported types
+        //!
+        template <typename T>
+        struct MortonCode;
+
+        template <>
+        struct MortonCode<uint8_t> {
+            using Code2 = uint16_t;
+            using Code3 = uint32_t;
+        };
+
+        template <>
+        struct MortonCode<uint16_t> {
+            using Code2 = uint32_t;
+            using Code3 = uint64_t;
+        };
+
+        template <>
+        struct MortonCode<uint32_t> {
+            using Code2 = uint64_t;
+            using Code3 = uint64_t;
+        };
+    }
+
+    //!
+    //! \brief  Interleaves the bits of two coordinates into a Morton (Z-order) code
+    //!
+    //! \tparam  T  the coordinate type, uint8_t, uint16_t or uint32_t for 16, 32 or 64-bit codes,
+    //!             should be inferred from the parameters,
+    //!             do not set this explicitly
+    //!
+    //! \param[in]  x  becomes the even bits of the code
+    //! \param[in]  y  becomes the odd bits of the code
+    //!
+    //! \returns  the code, a type twice as wide as \p T
+    //!
+    //! \par Example
+    //! \code
+    //!     const auto x = interleave2<uint8_t>(0b11, 0b01); // returns 0b0111
+    //! \endcode
+    //!
+    //! \note  uses a single PDEP per coordinate when the CPU has a fast one (see #depositBits),
+    //!        and five shift-and-mask steps per coordinate otherwise
+    //!
+    template <typename T>
+    inline typename detail::MortonCode<T>::Code2 interleave2(T x, T y);
+
+    //!
+    //! \brief  Interleaves the bits of many pairs of coordinates
+    //!
+    //! \param[in]   x       the first coordinates
+    //! \param[in]   y       the second coordinates
+    //! \param[out]  target  where to store the codes
+    //! \param[in]   count   how many codes to compute
+    //!
+    //! \see  #interleave2
+    //!
+    template <typename T>
+    inline void interleave2(const T* x, const T* y, typename detail::MortonCode<T>::Code2* target, size_t count);
+
+    //!
+    //! \brief  Splits a Morton code back into the two coordinates it was made from
+    //!
+    //! \param[in]   code  the code
+    //! \param[out]  x     receives the even bits of the code
+    //! \param[out]  y     receives the odd bits of the code
+    //!
+    //! \see  #interleave2
+    //!
+    template <typename T>
+    inline void deinterleave2(typename detail::MortonCode<T>::Code2 code, T& x, T& y);
+
+    //!
+    //! \brief  Splits many Morton codes into pairs of coordinates
+    //!
+    //! \see  #deinterleave2
+    //!
+    template <typename T>
+    inline void deinterleave2(const typename detail::MortonCode<T>::Code2* source, T* x, T* y, size_t count);
+
+    //!
+    //! \brief  Interleaves the bits of three coordinates into a Morton (Z-order) code
+    //!
+    //! \tparam  T  the coordinate type, uint8_t, uint16_t or uint32_t,
+    //!             should be inferred from the parameters,
+    //!             do not set this explicitly
+    //!
+    //! \param[in]  x  becomes bits 0, 3, 6... of the code
+    //! \param[in]  y  becomes bits 1, 4, 7... of the code
+    //! \param[in]  z  becomes bits 2, 5, 8... of the code
+    //!
+    //! \returns  the code, a uint32_t for uint8_t coordinates and a uint64_t otherwise
+    //!
+    //! \par Example
+    //! \code
+    //!     const auto x = interleave3<uint8_t>(0b1, 0b0, 0b1); // returns 0b101
+    //! \endcode
+    //!
+    //! \note  a uint64_t holds 21 bits of each of three uint32_t coordinates,
+    //!        the bits above those are ignored
+    //!
+    template <typename T>
+    inline typename detail::MortonCode<T>::Code3 interleave3(T x, T y, T z);
+
+    //!
+    //! \brief  Interleaves the bits of many triples of coordinates
+    //!
+    //! \see  #interleave3
+    //!
+    template <typename T>
+    inline void interleave3(const T* x, const T* y, const T* z, typename detail::MortonCode<T>::Code3* target, size_t count);
+
+    //!
+    //! \brief  Splits a Morton code back into the three coordinates it was made from
+    //!
+    //! \see  #interleave3
+    //!
+    template <typename T>
+    inline void deinterleave3(typename detail::MortonCode<T>::Code3 code, T& x, T& y, T& z);
+
+    //!
+    //! \brief  Splits many Morton codes into triples of coordinates
+    //!
+    //! \see  #deinterleave3
+    //!
+    template <typename T>
+    inline void deinterleave3(const typename detail::MortonCode<T>::Code3* source, T* x, T* y, T* z, size_t count);
+
+    namespace detail {
+        //!
+        //! \brief  Moves bit i of the low 32 bits to bit 2i
+        //!
+        inline uint64_t spreadBits2(uint64_t value);
+
+        //!
+        //! \brief  Moves bit 2i to bit i, the reverse of #spreadBits2
+        //!
+        inline uint64_t compactBits2(uint64_t value);
+
+        //!
+        //! \brief  Moves bit i of the low 21 bits to bit 3i
+        //!
+        inline uint64_t spreadBits3(uint64_t value);
+
+        //!
+        //! \brief  Moves bit 3i to bit i, the reverse of #spreadBits3
+        //!
+        inline uint64_t compactBits3(uint64_t value);
+
+        //!
+        //! \brief  #spreadBits2 and friends without PDEP and PEXT, five or six shift-and-mask steps each
+        //!
+        inline uint64_t spreadBits2Portable(uint64_t value);
+        inline uint64_t compactBits2Portable(uint64_t value);
+        inline uint64_t spreadBits3Portable(uint64_t value);
+        inline uint64_t compactBits3Portable(uint64_t value);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <typename T>
+inline typename bitter::detail::MortonCode<T>::Code2 bitter::interleave2(const T x, const T y) {
+    using Code = typename detail::MortonCode<T>::Code2;
+    return static_cast<Code>(detail::spreadBits2(x) | (detail::spreadBits2(y) << 1));
+}
+
+template <typename T>
+inline void bitter::interleave2(const T* const x, const T* const y, typename detail::MortonCode<T>::Code2* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = interleave2(x[i], y[i]);
+    }
+}
+
+template <typename T>
+inline void bitter::deinterleave2(const typename detail::MortonCode<T>::Code2 code, T& x, T& y) {
+    x = static_cast<T>(detail::compactBits2(code));
+    y = static_cast<T>(detail::compactBits2(code >> 1));
+}
+
+template <typename T>
+inline void bitter::deinterleave2(const typename detail::MortonCode<T>::Code2* const source, T* const x, T* const y, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        deinterleave2(source[i], x[i], y[i]);
+    }
+}
+
+template <typename T>
+inline typename bitter::detail::MortonCode<T>::Code3 bitter::interleave3(const T x, const T y, const T z) {
+    using Code = typename detail::MortonCode<T>::Code3;
+    return static_cast<Code>(detail::spreadBits3(x) | (detail::spreadBits3(y) << 1) | (detail::spreadBits3(z) << 2));
+}
+
+template <typename T>
+inline void bitter::interleave3(const T* const x, const T* const y, const T* const z, typename detail::MortonCode<T>::Code3* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = interleave3(x[i], y[i], z[i]);
+    }
+}
+
+template <typename T>
+inline void bitter::deinterleave3(const typename detail::MortonCode<T>::Code3 code, T& x, T& y, T& z) {
+    x = static_cast<T>(detail::compactBits3(code));
+    y = static_cast<T>(detail::compactBits3(code >> 1));
+    z = static_cast<T>(detail::compactBits3(code >> 2));
+}
+
+template <typename T>
+inline void bitter::deinterleave3(const typename detail::MortonCode<T>::Code3* const source, T* const x, T* const y, T* const z, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        deinterleave3(source[i], x[i], y[i], z[i]);
+    }
+}
+
+inline uint64_t bitter::detail::spreadBits2(uint64_t value) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(hasFastBmi2()) {
+        return depositBitsWithBmi2(value, uint64_t(0x5555555555555555));
+    }
+#endif
+
+    return spreadBits2Portable(value);
+}
+
+inline uint64_t bitter::detail::compactBits2(uint64_t value) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(hasFastBmi2()) {
+        return extractBitsWithBmi2(value, uint64_t(0x5555555555555555));
+    }
+#endif
+
+    return compactBits2Portable(value);
+}
+
+inline uint64_t bitter::detail::spreadBits3(uint64_t value) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(hasFastBmi2()) {
+        return depositBitsWithBmi2(value, uint64_t(0x1249249249249249));
+    }
+#endif
+
+    return spreadBits3Portable(value);
+}
+
+inline uint64_t bitter::detail::compactBits3(uint64_t value) {
+#if defined(BITTER_RUNTIME_BMI2)
+    if(hasFastBmi2()) {
+        return extractBitsWithBmi2(value, uint64_t(0x1249249249249249));
+    }
+#endif
+
+    return compactBits3Portable(value);
+}
+
+inline uint64_t bitter::detail::spreadBits2Portable(uint64_t value) {
+    value &= 0x00000000FFFFFFFF;
+    value = (value | (value << 16)) & 0x0000FFFF0000FFFF;
+    value = (value | (value << 8)) & 0x00FF00FF00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F0F0F0F0F;
+    value = (value | (value << 2)) & 0x3333333333333333;
+    value = (value | (value << 1)) & 0x5555555555555555;
+    return value;
+}
+
+inline uint64_t bitter::detail::compactBits2Portable(uint64_t value) {
+    value &= 0x5555555555555555;
+    value = (value | (value >> 1)) & 0x3333333333333333;
+    value = (value | (value >> 2)) & 0x0F0F0F0F0F0F0F0F;
+    value = (value | (value >> 4)) & 0x00FF00FF00FF00FF;
+    value = (value | (value >> 8)) & 0x0000FFFF0000FFFF;
+    value = (value | (value >> 16)) & 0x00000000FFFFFFFF;
+    return value;
+}
+
+inline uint64_t bitter::detail::spreadBits3Portable(uint64_t value) {
+    value &= 0x00000000001FFFFF;
+    value = (value | (value << 32)) & 0x001F00000000FFFF;
+    value = (value | (value << 16)) & 0x001F0000FF0000FF;
+    value = (value | (value << 8)) & 0x100F00F00F00F00F;
+    value = (value | (value << 4)) & 0x10C30C30C30C30C3;
+    value = (value | (value << 2)) & 0x1249249249249249;
+    return value;
+}
+
+inline uint64_t bitter::detail::compactBits3Portable(uint64_t value) {
+    value &= 0x1249249249249249;
+    value = (value | (value >> 2)) & 0x10C30C30C30C30C3;
+    value = (value | (value >> 4)) & 0x100F00F00F00F00F;
+    value = (value | (value >> 8)) & 0x001F0000FF0000FF;
+    value = (value | (value >> 16)) & 0x001F00000000FFFF;
+    value = (value | (value >> 32)) & 0x00000000001FFFFF;
+    return value;
+}
@@ -0,0 +1,438 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <bitter_word.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  An array of unsigned integers that each take up a fixed number of bits
+    //!
+    //! \tparam  Width  how many bits each element takes up, in the range [1, 64],
+    //!                 or 0 to choose the width at runtime
+    //!
+    //! \par Example
+    //! \code
+    //!     PackedArray<13> compileTimeWidth(1000);
+    //!     PackedArray<> runtimeWidth(1000, 13);
+    //!
+    //!     compileTimeWidth.set(42, 8191);
+    //!     const auto x = compileTimeWidth.get(42); // returns 8191
+    //! \endcode
+    //!
+    //! \note  element i occupies bits [i * width(), (i + 1) * width()) of the storage
+    //!
+    template <size_t Width = 0>
+    class PackedArray {
+        static_assert(Width <= 64, "elements can be at most 64 bits wide");
+
+    public:
+        //!
+        //! \brief  Creates a PackedArray with a compile-time width, with all elements zero
+        //!
+        //! \param[in]  size  how many elements to hold
+        //!
+        explicit PackedArray(size_t size);
+
+        //!
+        //! \brief  Creates a PackedArray with a runtime width, with all elements zero
+        //!
+        //! \param[in]  size   how many elements to hold
+        //! \param[in]  width  how many bits each element takes up, in the range [1, 64]
+        //!
+        //! \note  only available when Width is 0; a \p width outside [1, 64] is rejected
+        //!        by creating an empty array, whose size() and width() are 0
+        //!
+        PackedArray(size_t size, size_t width);
+
+        //!
+        //! \brief  Retrieves an element
+        //!
+        //! \param[in]  index  which element to retrieve (zero-indexed)
+        //!
+        //! \returns  the element's value
+        //!
+        uint64_t get(size_t index) const;
+
+        //!
+        //! \brief  Changes an element
+        //!
+        //! \param[in]  index  which element to change (zero-indexed)
+        //! \param[in]  value  the new value, bits above width() are ignored
+        //!
+        void set(size_t index, uint64_t value);
+
+        //!
+        //! \brief  Retrieves a run of elements
+        //!
+        //! \param[in]   begin  the first element to retrieve (zero-indexed)
+        //! \param[in]   end    one past the last element to retrieve
+        //! \param[out]  out    where to write the values to
+        //!
+        //! \returns  \p out, advanced past the last value written
+        //!
+        //! \note  runs a loop specialised for the width; unpacking into uint32_t
+        //!        with AVX2 available and a width of up to 25 bits decodes 8 elements per step
+        //!
+        template <typename OutputIt>
+        OutputIt unpack(size_t begin, size_t end, OutputIt out) const;
+
+        //!
+        //! \brief  Changes a run of elements, starting at the first
+        //!
+        //! \param[in]  in     where to read the values from, bits above width() are ignored
+        //! \param[in]  count  how many elements to change, at most size()
+        //!
+        //! \returns  \p in, advanced past the last value read
+        //!
+        //! \note  runs a loop specialised for the width that stores each word once
+        //!
+        template <typename InputIt>
+        InputIt pack(InputIt in, size_t count);
+
+        //!
+        //! \returns  how many elements there are
+        //!
+        size_t size() const;
+
+        //!
+        //! \returns  how many bits each element takes up
+        //!
+        size_t width() const;
+
+        //!
+        //! \returns  the words the elements are stored in
+        //!
+        const uint64_t* data() const;
+
+    private:
+        // how many words to allocate, including the padding m_words needs
+        static size_t wordCountFor(size_t size, size_t width);
+
+        static bool isValidWidth(size_t width);
+
+        size_t m_size;
+        size_t m_width;
+
+        // padded so a pair of words, or a 16 byte vector, can be loaded for any element
+        std::vector<uint64_t> m_words;
+    };
+
+    namespace detail {
+        //!
+        //! \brief  Calls a function with std::integral_constant<size_t, Width>,
+        //!         or with the runtime width turned into one if Width is 0
+        //!
+        template <size_t Width>
+        struct WidthDispatcher {
+            template <typename Function>
+            static void call(size_t width, Function&& function);
+        };
+
+        template <size_t Width, typename OutputIt>
+        inline OutputIt unpackWidth(const uint64_t* words, size_t begin, size_t count, OutputIt out);
+
+        template <size_t Width, typename InputIt>
+        inline InputIt packWidth(uint64_t* words, size_t count, InputIt in);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    namespace detail {
+        // tries each width from MaxWidth down to 1, the compiler turns the chain into a jump table
+        template <size_t MaxWidth>
+        struct RuntimeWidthDispatcher {
+            template <typename Function>
+            static void call(const size_t width, Function&& function) {
+                if(width == MaxWidth) {
+                    function(std::integral_constant<size_t, MaxWidth>());
+                } else {
+                    RuntimeWidthDispatcher<MaxWidth - 1>::call(width, function);
+                }
+            }
+        };
+
+        template <>
+        struct RuntimeWidthDispatcher<0> {
+            template <typename Function>
+            static void call(size_t, Function&&) {
+
+            }
+        };
+
+        template <size_t Width>
+        template <typename Function>
+        inline void WidthDispatcher<Width>::call(size_t, Function&& function) {
+            function(std::integral_constant<size_t, Width>());
+        }
+
+        template <>
+        struct WidthDispatcher<0> {
+            template <typename Function>
+            static void call(const size_t width, Function&& function) {
+                RuntimeWidthDispatcher<64>::call(width, function);
+            }
+        };
+
+        template <size_t Width>
+        inline uint64_t unpackOne(const uint64_t* const word, const size_t shift) {
+            // the second word's contribution is shifted in two steps so a shift of 0 doesn't become a shift by 64
+            return ((word[0] >> shift) | ((word[1] << 1) << (63 - shift))) & lowBitMask(Width);
+        }
+
+        template <size_t Width, typename OutputIt>
+        inline OutputIt unpackScalar(const uint64_t* words, const size_t begin, size_t count, OutputIt out) {
+            const size_t firstBit = begin * Width;
+            const uint64_t* word = words + (firstBit / 64);
+            size_t shift = firstBit % 64;
+
+            for(; count > 0; --count) {
+                *out = unpackOne<Width>(word, shift);
+                ++out;
+
+                shift += Width;
+                word += shift / 64;
+                shift %= 64;
+            }
+
+            return out;
+        }
+
+#if defined(__AVX2__) && ! defined(BITTER_BIG_ENDIAN)
+        // Every group of 8 elements starts on a byte boundary (8 * Width bits),
+        // so the byte offsets and shifts of the elements within a group only depend on Width.
+        // Each 128 bit lane loads 16 bytes covering 4 elements, shuffles 4 bytes per element into place,
+        // then the per-element shifts and the mask are applied to all 8 at once.
+        template <size_t Width>
+        inline uint32_t* unpackAvx2(const uint64_t* const words, size_t begin, size_t count, uint32_t* out) {
+            static_assert(Width <= 25, "an element plus its shift must fit in 32 bits");
+
+            const size_t headCount = std::min<size_t>((8 - (begin % 8)) % 8, count);
+            out = unpackScalar<Width>(words, begin, headCount, out);
+            begin += headCount;
+            count -= headCount;
+
+            const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(words);
+
+            constexpr size_t laneOffset = (4 * Width) / 8;
+
+            const __m256i shuffle = _mm256_setr_epi8(
+                ((0 * Width) / 8) + 0, ((0 * Width) / 8) + 1, ((0 * Width) / 8) + 2, ((0 * Width) / 8) + 3,
+                ((1 * Width) / 8) + 0, ((1 * Width) / 8) + 1, ((1 * Width) / 8) + 2, ((1 * Width) / 8) + 3,
+                ((2 * Width) / 8) + 0, ((2 * Width) / 8) + 1, ((2 * Width) / 8) + 2, ((2 * Width) / 8) + 3,
+                ((3 * Width) / 8) + 0, ((3 * Width) / 8) + 1, ((3 * Width) / 8) + 2, ((3 * Width) / 8) + 3,
+                ((4 * Width) / 8) - laneOffset + 0, ((4 * Width) / 8) - laneOffset + 1, ((4 * Width) / 8) - laneOffset + 2, ((4 * Width) / 8) - laneOffset + 3,
+                ((5 * Width) / 8) - laneOffset + 0, ((5 * Width) / 8) - laneOffset + 1, ((5 * Width) / 8) - laneOffset + 2, ((5 * Width) / 8) - laneOffset + 3,
+                ((6 * Width) / 8) - laneOffset + 0, ((6 * Width) / 8) - laneOffset + 1, ((6 * Width) / 8) - laneOffset + 2, ((6 * Width) / 8) - laneOffset + 3,
+                ((7 * Width) / 8) - laneOffset + 0, ((7 * Width) / 8) - laneOffset + 1, ((7 * Width) / 8) - laneOffset + 2, ((7 * Width) / 8) - laneOffset + 3
+            );
+
+            const __m256i shifts = _mm256_setr_epi32(
+                (0 * Width) % 8, (1 * Width) % 8, (2 * Width) % 8, (3 * Width) % 8,
+                (4 * Width) % 8, (5 * Width) % 8, (6 * Width) % 8, (7 * Width) % 8
+            );
+
+            const __m256i mask = _mm256_set1_epi32(static_cast<int>(lowBitMask(Width)));
+
+            for(; count >= 8; count -= 8, begin += 8, out += 8) {
+                const uint8_t* const group = bytes + ((begin * Width) / 8);
+
+                const __m256i raw = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + laneOffset)),
+                    1
+                );
+
+                const __m256i values = _mm256_and_si256(_mm256_srlv_epi32(_mm256_shuffle_epi8(raw, shuffle), shifts), mask);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), values);
+            }
+
+            return unpackScalar<Width>(words, begin, count, out);
+        }
+
+        template <size_t Width, bool UseAvx2 = (Width <= 25)>
+        struct Unpacker {
+            template <typename OutputIt>
+            static OutputIt run(const uint64_t* words, size_t begin, size_t count, OutputIt out) {
+                return unpackScalar<Width>(words, begin, count, out);
+            }
+
+            static uint32_t* run(const uint64_t* words, size_t begin, size_t count, uint32_t* out) {
+                return unpackAvx2<Width>(words, begin, count, out);
+            }
+        };
+
+        template <size_t Width>
+        struct Unpacker<Width, false> {
+            template <typename OutputIt>
+            static OutputIt run(const uint64_t* words, size_t begin, size_t count, OutputIt out) {
+                return unpackScalar<Width>(words, begin, count, out);
+            }
+        };
+#else
+        template <size_t Width>
+        struct Unpacker {
+            template <typename OutputIt>
+            static OutputIt run(const uint64_t* words, size_t begin, size_t count, OutputIt out) {
+                return unpackScalar<Width>(words, begin, count, out);
+            }
+        };
+#endif
+
+        template <size_t Width, typename OutputIt>
+        inline OutputIt unpackWidth(const uint64_t* const words, const size_t begin, const size_t count, const OutputIt out) {
+            return Unpacker<Width>::run(words, begin, count, out);
+        }
+
+        template <size_t Width, typename InputIt>
+        inline InputIt packWidth(uint64_t* word, size_t count, InputIt in) {
+            // Elements are merged into a register that is stored once it fills up,
+            // only the last, partially filled word needs to keep bits that were already there.
+            uint64_t bits = 0;
+            size_t shift = 0;
+
+            for(; count > 0; --count) {
+                const uint64_t value = static_cast<uint64_t>(*in) & lowBitMask(Width);
+                ++in;
+
+                bits |= value << shift;
+                shift += Width;
+
+                if(shift >= 64) {
+                    *word = bits;
+                    ++word;
+
+                    shift -= 64;
+                    bits = shift != 0 ? (value >> (Width - shift)) : 0;
+                }
+            }
+
+            if(shift != 0) {
+                *word = bits | (*word & ~lowBitMask(shift));
+            }
+
+            return in;
+        }
+    }
+
+    template <size_t Width>
+    inline PackedArray<Width>::PackedArray(const size_t size)
+    : m_size(size),
+      m_width(Width),
+      m_words(wordCountFor(size, Width), 0) {
+        static_assert(Width != 0, "a PackedArray with a runtime width needs to be given the width");
+    }
+
+    template <size_t Width>
+    inline PackedArray<Width>::PackedArray(const size_t size, const size_t width)
+    : m_size(isValidWidth(width) ? size : 0),
+      m_width(isValidWidth(width) ? width : 0),
+      m_words(wordCountFor(m_size, m_width), 0) {
+        static_assert(Width == 0, "a PackedArray with a compile-time width can not be given another width");
+    }
+
+    template <size_t Width>
+    inline size_t PackedArray<Width>::wordCountFor(const size_t size, const size_t width) {
+        return (((size * width) + 63) / 64) + 4;
+    }
+
+    template <size_t Width>
+    inline bool PackedArray<Width>::isValidWidth(const size_t width) {
+        return width >= 1 && width <= 64;
+    }
+
+    template <size_t Width>
+    inline uint64_t PackedArray<Width>::get(const size_t index) const {
+        const size_t bitNumber = index * width();
+        const size_t shift = bitNumber % 64;
+        const uint64_t* const word = m_words.data() + (bitNumber / 64);
+
+        return ((word[0] >> shift) | ((word[1] << 1) << (63 - shift))) & detail::lowBitMask(width());
+    }
+
+    template <size_t Width>
+    inline void PackedArray<Width>::set(const size_t index, uint64_t value) {
+        const size_t bitNumber = index * width();
+        const size_t shift = bitNumber % 64;
+        uint64_t* const word = m_words.data() + (bitNumber / 64);
+
+        const uint64_t mask = detail::lowBitMask(width());
+        value &= mask;
+
+        word[0] = (word[0] & ~(mask << shift)) | (value << shift);
+
+        // the element spills over into the next word
+        if(shift + width() > 64) {
+            const size_t spilledShift = 64 - shift;
+            word[1] = (word[1] & ~(mask >> spilledShift)) | (value >> spilledShift);
+        }
+    }
+
+    template <size_t Width>
+    template <typename OutputIt>
+    inline OutputIt PackedArray<Width>::unpack(const size_t begin, const size_t end, OutputIt out) const {
+        detail::WidthDispatcher<Width>::call(m_width, [&](auto width) {
+            out = detail::unpackWidth<decltype(width)::value>(m_words.data(), begin, end - begin, out);
+        });
+
+        return out;
+    }
+
+    template <size_t Width>
+    template <typename InputIt>
+    inline InputIt PackedArray<Width>::pack(InputIt in, const size_t count) {
+        detail::WidthDispatcher<Width>::call(m_width, [&](auto width) {
+            in = detail::packWidth<decltype(width)::value>(m_words.data(), count, in);
+        });
+
+        return in;
+    }
+
+    template <size_t Width>
+    inline size_t PackedArray<Width>::size() const {
+        return m_size;
+    }
+
+    template <size_t Width>
+    inline size_t PackedArray<Width>::width() const {
+        return Width != 0 ? Width : m_width;
+    }
+
+    template <size_t Width>
+    inline const uint64_t* PackedArray<Width>::data() const {
+        return m_words.data();
+    }
+}
@@ -0,0 +1,448 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bitter_extract_deposit.hpp>
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Answers rank and select queries over a read-only buffer in constant time
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0b10100110 };
+    //!     RankSelectIndex index(data, 8);
+    //!     const auto x = index.rank1(3);   // returns 2, bits 1 and 2 are set
+    //!     const auto y = index.select1(2); // returns 5, the third set bit
+    //! \endcode
+    //!
+    //! \note  The index takes about 3.2% of the size of the buffer.
+    //!        Every 2048 bit block gets one 64-bit entry holding the number of set bits
+    //!        before the block and the counts of its first three 512 bit (cache line) sub-blocks,
+    //!        so a rank query touches the entry and a single cache line of the buffer.
+    //!        The entries are aligned to 64 bytes, so every eight neighbouring blocks share one cache line.
+    //!
+    //! \note  Select samples every 8192nd set bit. Where those 8192 set bits span fewer than 2^17 bits,
+    //!        at most 65 entries are searched; where they span fewer than 2^24 bits,
+    //!        every 256th set bit is sampled too, leaving at most 8193 entries (13 steps);
+    //!        and where they are sparser still, their positions are stored directly.
+    //!        A select query therefore takes a bounded number of steps whatever the size of the buffer,
+    //!        at the cost of up to 3.2% more index in sparse regions.
+    //!
+    //! \note  bits are numbered the same way as #getBit numbers them
+    //!
+    //! \warning  the index does not copy the buffer,
+    //!           so make sure it outlives the index and does not change!
+    //!
+    class RankSelectIndex {
+    public:
+        //!
+        //! \brief  Builds the index in a single pass over the buffer
+        //!
+        //! \tparam  T  the type the source pointer points to,
+        //!             should be inferred from the parameter,
+        //!             do not set this explicitly
+        //!
+        //! \param[in]  source    the buffer to index
+        //! \param[in]  bitCount  how many bits \p source holds
+        //!
+        template <typename T>
+        RankSelectIndex(const T* source, size_t bitCount);
+
+        RankSelectIndex(const RankSelectIndex&) = delete;
+        RankSelectIndex& operator=(const RankSelectIndex&) = delete;
+
+        RankSelectIndex(RankSelectIndex&&) = default;
+        RankSelectIndex& operator=(RankSelectIndex&&) = default;
+
+        //!
+        //! \brief  Counts the set bits before a given bit
+        //!
+        //! \param[in]  bitNumber  where to stop counting (exclusive), in the range [0, size()]
+        //!
+        //! \returns  how many bits in [0, \p bitNumber) are #Bit::One
+        //!
+        size_t rank1(size_t bitNumber) const;
+
+        //!
+        //! \brief  Counts the clear bits before a given bit
+        //!
+        //! \param[in]  bitNumber  where to stop counting (exclusive), in the range [0, size()]
+        //!
+        //! \returns  how many bits in [0, \p bitNumber) are #Bit::Zero
+        //!
+        size_t rank0(size_t bitNumber) const;
+
+        //!
+        //! \brief  Finds a set bit by its rank
+        //!
+        //! \param[in]  rank  how many set bits come before the one wanted (zero-indexed)
+        //!
+        //! \returns  the index of the set bit, such that rank1(result) == \p rank,
+        //!           or size() if there are not that many set bits
+        //!
+        size_t select1(size_t rank) const;
+
+        //!
+        //! \returns  how many bits the buffer holds
+        //!
+        size_t size() const;
+
+        //!
+        //! \returns  how many bits of the buffer are #Bit::One
+        //!
+        size_t countOnes() const;
+
+        //!
+        //! \returns  how many bytes the index itself occupies
+        //!
+        size_t indexSizeInBytes() const;
+
+    private:
+        static constexpr size_t wordsPerBlock = 32;
+        static constexpr size_t wordsPerSubBlock = 8;
+        static constexpr size_t blockBits = wordsPerBlock * 64;
+        static constexpr size_t subBlockBits = wordsPerSubBlock * 64;
+        static constexpr size_t superBlockShift = 32;
+        static constexpr size_t onesPerSample = 8192;
+        static constexpr size_t onesPerSubSample = 256;
+        static constexpr size_t subSamplesPerSample = onesPerSample / onesPerSubSample;
+        static constexpr size_t narrowSampleBlocks = 64;
+        static constexpr uint64_t sparseSampleBits = uint64_t(1) << 24;
+        static constexpr uint64_t mediumSample = uint64_t(1) << 62;
+        static constexpr uint64_t sparseSample = uint64_t(1) << 63;
+
+        void buildSelect();
+        uint64_t loadWord(size_t wordNumber) const;
+        size_t onesBeforeBlock(size_t blockNumber) const;
+        size_t subSampleOffset(size_t dataIndex, size_t subSampleNumber) const;
+        static size_t subBlockCount(uint64_t entry, size_t subBlockNumber);
+        static size_t selectInWord(uint64_t word, size_t rank);
+
+        const uint8_t* m_source;
+        size_t m_bitCount;
+        size_t m_ones = 0;
+
+        // set bits before each 2^32 bit super block
+        std::vector<uint64_t> m_superBlocks;
+
+        // per block: bits 0-31 are the set bits before the block (relative to its super block),
+        // bits 32-41, 42-51 and 52-61 are the set bits in sub-blocks 0, 1 and 2;
+        // padded so the entries can start at a 64-byte boundary
+        size_t m_blockCount;
+        std::vector<uint64_t> m_blockStorage;
+        uint64_t* m_blocks;
+
+        // per sample of onesPerSample set bits, one of
+        //   the block holding its first set bit, if its set bits span fewer than narrowSampleBlocks blocks,
+        //   mediumSample | where in m_selectData that block is stored, followed by the block of every
+        //                  onesPerSubSample-th set bit and of the next sample's first, relative to it,
+        //                  16 bits each and four to a word, if they span fewer than sparseSampleBits bits,
+        //   sparseSample | where in m_selectData the position of each of its set bits is stored, otherwise
+        std::vector<uint64_t> m_samples;
+        std::vector<uint64_t> m_selectData;
+    };
+}
+
+///
+/// IMPLEMENTATION
+///
+
+namespace bitter {
+    template <typename T>
+    inline RankSelectIndex::RankSelectIndex(const T* const source, const size_t bitCount)
+    : m_source(detail::asBytes(source)),
+      m_bitCount(bitCount),
+      // one extra entry each so that rank1(size()) needs no special casing
+      m_blockCount(((((bitCount + 63) / 64) + wordsPerBlock - 1) / wordsPerBlock) + 1),
+      m_blockStorage(m_blockCount + 7, 0) {
+        const size_t wordCount = (bitCount + 63) / 64;
+
+        const uintptr_t address = reinterpret_cast<uintptr_t>(m_blockStorage.data());
+        m_blocks = m_blockStorage.data() + (((64 - (address % 64)) % 64) / sizeof(uint64_t));
+
+        m_superBlocks.reserve((bitCount >> superBlockShift) + 1);
+
+        size_t ones = 0;
+
+        for(size_t block = 0; block < m_blockCount; ++block) {
+            if(((block * blockBits) & ((uint64_t(1) << superBlockShift) - 1)) == 0) {
+                m_superBlocks.push_back(ones);
+            }
+
+            uint64_t entry = ones - m_superBlocks.back();
+
+            for(size_t word = block * wordsPerBlock; word < (block + 1) * wordsPerBlock && word < wordCount; ++word) {
+                const size_t wordOnes = detail::popCount(loadWord(word));
+
+                const size_t subBlock = (word % wordsPerBlock) / wordsPerSubBlock;
+                if(subBlock < 3) {
+                    entry += uint64_t(wordOnes) << (32 + (10 * subBlock));
+                }
+
+                ones += wordOnes;
+            }
+
+            m_blocks[block] = entry;
+        }
+
+        m_ones = ones;
+
+        buildSelect();
+    }
+
+    inline size_t RankSelectIndex::rank1(const size_t bitNumber) const {
+        const size_t block = bitNumber / blockBits;
+        const uint64_t entry = m_blocks[block];
+
+        size_t rank = onesBeforeBlock(block);
+
+        const size_t subBlock = (bitNumber % blockBits) / subBlockBits;
+        for(size_t i = 0; i < subBlock; ++i) {
+            rank += subBlockCount(entry, i);
+        }
+
+        const size_t lastWord = bitNumber / 64;
+        for(size_t word = (block * wordsPerBlock) + (subBlock * wordsPerSubBlock); word < lastWord; ++word) {
+            rank += detail::popCount(loadWord(word));
+        }
+
+        if(bitNumber % 64 != 0) {
+            rank += detail::popCount(loadWord(lastWord) & detail::lowBitMask(bitNumber % 64));
+        }
+
+        return rank;
+    }
+
+    inline size_t RankSelectIndex::rank0(const size_t bitNumber) const {
+        return bitNumber - rank1(bitNumber);
+    }
+
+    inline size_t RankSelectIndex::select1(size_t rank) const {
+        if(rank >= m_ones) {
+            return m_bitCount;
+        }
+
+        const uint64_t sample = m_samples[rank / onesPerSample];
+        const size_t rankInSample = rank % onesPerSample;
+
+        if((sample & sparseSample) != 0) {
+            return static_cast<size_t>(m_selectData[static_cast<size_t>(sample & ~sparseSample) + rankInSample]);
+        }
+
+        // the samples bound which blocks can hold the wanted bit, binary search between them
+        size_t low = static_cast<size_t>(sample);
+        size_t high = low + narrowSampleBlocks + 1;
+
+        if((sample & mediumSample) != 0) {
+            const size_t dataIndex = static_cast<size_t>(sample & ~mediumSample);
+            const size_t subSample = rankInSample / onesPerSubSample;
+
+            low = static_cast<size_t>(m_selectData[dataIndex]) + subSampleOffset(dataIndex, subSample);
+            high = static_cast<size_t>(m_selectData[dataIndex]) + subSampleOffset(dataIndex, subSample + 1) + 1;
+        }
+
+        high = std::min(high, m_blockCount);
+
+        while(high - low > 1) {
+            const size_t middle = low + ((high - low) / 2);
+
+            if(onesBeforeBlock(middle) <= rank) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+
+        const size_t block = low;
+        const uint64_t entry = m_blocks[block];
+        rank -= onesBeforeBlock(block);
+
+        size_t subBlock = 0;
+        for(; subBlock < 3; ++subBlock) {
+            const size_t count = subBlockCount(entry, subBlock);
+
+            if(rank < count) {
+                break;
+            }
+
+            rank -= count;
+        }
+
+        for(size_t word = (block * wordsPerBlock) + (subBlock * wordsPerSubBlock); ; ++word) {
+            const uint64_t bits = loadWord(word);
+            const size_t count = detail::popCount(bits);
+
+            if(rank < count) {
+                return (word * 64) + selectInWord(bits, rank);
+            }
+
+            rank -= count;
+        }
+    }
+
+    inline size_t RankSelectIndex::size() const {
+        return m_bitCount;
+    }
+
+    inline size_t RankSelectIndex::countOnes() const {
+        return m_ones;
+    }
+
+    inline size_t RankSelectIndex::indexSizeInBytes() const {
+        return (m_superBlocks.size() * sizeof(uint64_t))
+             + (m_blockStorage.size() * sizeof(uint64_t))
+             + (m_samples.size() * sizeof(uint64_t))
+             + (m_selectData.size() * sizeof(uint64_t));
+    }
+
+    inline void RankSelectIndex::buildSelect() {
+        const size_t wordCount = (m_bitCount + 63) / 64;
+
+        // the position of every onesPerSubSample-th set bit, followed by that of the last one
+        std::vector<uint64_t> marks;
+        marks.reserve((m_ones / onesPerSubSample) + 2);
+
+        size_t ones = 0;
+        size_t lastWord = 0;
+
+        for(size_t word = 0; word < wordCount; ++word) {
+            const uint64_t bits = loadWord(word);
+            const size_t wordOnes = detail::popCount(bits);
+
+            while(marks.size() * onesPerSubSample < ones + wordOnes) {
+                marks.push_back((uint64_t(word) * 64) + selectInWord(bits, (marks.size() * onesPerSubSample) - ones));
+            }
+
+            if(wordOnes != 0) {
+                lastWord = word;
+            }
+
+            ones += wordOnes;
+        }
+
+        if(m_ones == 0) {
+            return;
+        }
+
+        const size_t markCount = marks.size();
+        const uint64_t lastBits = loadWord(lastWord);
+        marks.push_back((uint64_t(lastWord) * 64) + selectInWord(lastBits, detail::popCount(lastBits) - 1));
+
+        for(size_t sample = 0; sample * onesPerSample < m_ones; ++sample) {
+            const size_t firstMark = sample * subSamplesPerSample;
+            const size_t endMark = std::min(firstMark + subSamplesPerSample, markCount);
+            const uint64_t first = marks[firstMark];
+            const uint64_t span = marks[endMark] - first;
+            const size_t firstBlock = static_cast<size_t>(first / blockBits);
+
+            if(span < narrowSampleBlocks * blockBits) {
+                m_samples.push_back(firstBlock);
+            } else if(span < sparseSampleBits) {
+                m_samples.push_back(mediumSample | m_selectData.size());
+                m_selectData.push_back(firstBlock);
+
+                const size_t offsetIndex = m_selectData.size();
+                m_selectData.resize(offsetIndex + ((subSamplesPerSample + 4) / 4), 0);
+
+                // the last offset is the block of the next sample's first set bit, bounding the search of the last sub-sample
+                for(size_t i = 0; i <= subSamplesPerSample; ++i) {
+                    const uint64_t offset = (marks[std::min(firstMark + i, endMark)] / blockBits) - firstBlock;
+                    m_selectData[offsetIndex + (i / 4)] |= offset << (16 * (i % 4));
+                }
+            } else {
+                m_samples.push_back(sparseSample | m_selectData.size());
+
+                size_t remaining = std::min(size_t(onesPerSample), m_ones - (sample * onesPerSample));
+                for(size_t word = static_cast<size_t>(first / 64); remaining > 0; ++word) {
+                    uint64_t bits = loadWord(word) & ~detail::lowBitMask(word == first / 64 ? first % 64 : 0);
+
+                    for(; bits != 0 && remaining > 0; bits &= bits - 1, --remaining) {
+                        m_selectData.push_back((uint64_t(word) * 64) + detail::countTrailingZeros(bits));
+                    }
+                }
+            }
+        }
+    }
+
+    inline uint64_t RankSelectIndex::loadWord(const size_t wordNumber) const {
+        const size_t bitNumber = wordNumber * 64;
+
+        if(bitNumber + 64 <= m_bitCount) {
+            return detail::loadLittleEndian64(m_source + (wordNumber * 8));
+        }
+
+        return bitNumber < m_bitCount ? getBits(m_source, bitNumber, m_bitCount - bitNumber) : 0;
+    }
+
+    inline size_t RankSelectIndex::onesBeforeBlock(const size_t blockNumber) const {
+        const size_t superBlock = (blockNumber * blockBits) >> superBlockShift;
+        return static_cast<size_t>(m_superBlocks[superBlock] + (m_blocks[blockNumber] & 0xFFFFFFFF));
+    }
+
+    inline size_t RankSelectIndex::subSampleOffset(const size_t dataIndex, const size_t subSampleNumber) const {
+        return static_cast<size_t>((m_selectData[dataIndex + 1 + (subSampleNumber / 4)] >> (16 * (subSampleNumber % 4))) & 0xFFFF);
+    }
+
+    inline size_t RankSelectIndex::subBlockCount(const uint64_t entry, const size_t subBlockNumber) {
+        return static_cast<size_t>((entry >> (32 + (10 * subBlockNumber))) & 0x3FF);
+    }
+
+    inline size_t RankSelectIndex::selectInWord(uint64_t word, size_t rank) {
+#if defined(BITTER_RUNTIME_BMI2)
+        // deposit a single bit at the position of the wanted set bit
+        if(detail::hasFastBmi2()) {
+            return detail::countTrailingZeros(detail::depositBitsWithBmi2(uint64_t(1) << rank, word));
+        }
+#endif
+
+        // find the byte holding the wanted bit using running per-byte counts...
+        uint64_t counts = word - ((word >> 1) & 0x5555555555555555);
+        counts = (counts & 0x3333333333333333) + ((counts >> 2) & 0x3333333333333333);
+        counts = (counts + (counts >> 4)) & 0x0F0F0F0F0F0F0F0F;
+        counts *= 0x0101010101010101;
+
+        size_t byte = 0;
+        while(((counts >> (byte * 8)) & 0xFF) <= rank) {
+            ++byte;
+        }
+
+        if(byte > 0) {
+            rank -= (counts >> ((byte - 1) * 8)) & 0xFF;
+        }
+
+        // ...then drop the lower set bits of that byte
+        uint64_t bits = (word >> (byte * 8)) & 0xFF;
+        for(; rank > 0; --rank) {
+            bits &= bits - 1;
+        }
+
+        return (byte * 8) + detail::countTrailingZeros(bits);
+    }
+}
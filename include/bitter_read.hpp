@@ -17,7 +17,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include <bitter_bit.hpp>
+#include <bitter_word.hpp>
 
 ///
 /// INTERFACE
@@ -27,6 +31,8 @@ namespace bitter {
     //!
     //! \brief  Retrieves the state of a bit
     //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
     //! \tparam  T  the type the source pointer points to,
     //!             should be inferred from the parameter,
     //!             do not set this explicitly
@@ -50,22 +56,173 @@ namespace bitter {
     //!
     //! \see  #setBit
     //! \see  #Bit
+    //! \see  #BitOrder
     //!
-    template <typename T>
+    template <BitOrder Order = BitOrder::LsbFirst, typename T>
     inline constexpr Bit getBit(const T* source, size_t bitNumber);
+
+    //!
+    //! \brief  Retrieves the state of a range of bits as a single value
+    //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
+    //! \tparam  T  the type the source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[in]  source     where to read from
+    //! \param[in]  bitOffset  the first bit to retrieve (zero-indexed)
+    //! \param[in]  bitCount   how many bits to retrieve, in the range [0, 64]
+    //!
+    //! \returns  the bits, where bit \p bitOffset of \p source
+    //!           becomes bit 0 of the result for BitOrder::LsbFirst,
+    //!           or bit (\p bitCount - 1) for BitOrder::MsbFirst;
+    //!           all bits above \p bitCount are zero
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0xF0, 0x0F };
+    //!     const auto x = getBits(data, 4, 8);                      // returns 0xFF
+    //!     const auto y = getBits(data, 0, 16);                     // returns 0x0FF0
+    //!     const auto z = getBits<BitOrder::MsbFirst>(data, 0, 12); // returns 0xF00
+    //! \endcode
+    //!
+    //! \note  only the bytes that contain the requested bits are read,
+    //!        so it is safe to read a field that ends on the last byte
+    //!        of a buffer; fields spanning 8 bytes or more are read with
+    //!        a single unaligned word load, byte-swapped for BitOrder::MsbFirst
+    //!
+    //! \note  when \p source points to uint8_t this can be
+    //!        used in constant expressions
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #getBit
+    //! \see  #setBits
+    //!
+    template <BitOrder Order = BitOrder::LsbFirst, typename T>
+    inline constexpr uint64_t getBits(const T* source, size_t bitOffset, size_t bitCount);
+
+    namespace detail {
+        //!
+        //! \brief  The BitOrder::MsbFirst half of #getBits
+        //!
+        inline constexpr uint64_t getBitsMsbFirst(const uint8_t* source, size_t bitOffset, size_t bitCount);
+    }
 }
 
 ///
 /// IMPLEMENTATION
 ///
 
-template <typename T>
+template <bitter::BitOrder Order, typename T>
 inline constexpr bitter::Bit bitter::getBit(const T* const source, size_t bitNumber) {
     const char* const castSource = reinterpret_cast<const char* const>(source);
 
     const size_t byteNumber = bitNumber / 8;
-    bitNumber %= 8;
+    bitNumber = Order == BitOrder::MsbFirst ? 7 - (bitNumber % 8) : bitNumber % 8;
 
     return (*(castSource + byteNumber) & (1 << bitNumber)) ? Bit::One : Bit::Zero;
 }
 
+
+template <bitter::BitOrder Order, typename T>
+inline constexpr uint64_t bitter::getBits(const T* const source, const size_t bitOffset, const size_t bitCount) {
+    if(Order == BitOrder::MsbFirst) {
+        return detail::getBitsMsbFirst(detail::asBytes(source), bitOffset, bitCount);
+    }
+
+    if(bitCount == 0) {
+        return 0;
+    }
+
+    const uint8_t* const bytes = detail::asBytes(source) + (bitOffset / 8);
+
+    const size_t shift = bitOffset % 8;
+    const size_t byteCount = (shift + bitCount + 7) / 8;
+
+    uint64_t value = 0;
+
+    if(BITTER_IS_CONSTANT_EVALUATED()) {
+        for(size_t i = 0; i < byteCount && i < 8; ++i) {
+            value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+        }
+    } else if(byteCount >= 8) {
+        value = detail::loadLittleEndian64(bytes);
+    } else {
+        // fewer than 8 bytes hold the field, so only those are touched:
+        // at most one 4, one 2 and one 1 byte load, selected by the bits of byteCount
+        size_t loaded = 0;
+
+        if(byteCount & 4) {
+            value = detail::loadLittleEndian32(bytes);
+            loaded = 4;
+        }
+
+        if(byteCount & 2) {
+            value |= static_cast<uint64_t>(detail::loadLittleEndian16(bytes + loaded)) << (loaded * 8);
+            loaded += 2;
+        }
+
+        if(byteCount & 1) {
+            value |= static_cast<uint64_t>(bytes[loaded]) << (loaded * 8);
+        }
+    }
+
+    value >>= shift;
+
+    // a 64-bit field that doesn't start on a byte boundary spills into a ninth byte
+    if(byteCount > 8) {
+        value |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+    }
+
+    return value & detail::lowBitMask(bitCount);
+}
+
+inline constexpr uint64_t bitter::detail::getBitsMsbFirst(const uint8_t* const source, const size_t bitOffset, const size_t bitCount) {
+    if(bitCount == 0) {
+        return 0;
+    }
+
+    const uint8_t* const bytes = source + (bitOffset / 8);
+
+    const size_t shift = bitOffset % 8;
+    const size_t byteCount = (shift + bitCount + 7) / 8;
+
+    // the first byte ends up in the top 8 bits, so the field is left-aligned before shifting it down
+    uint64_t value = 0;
+
+    if(BITTER_IS_CONSTANT_EVALUATED()) {
+        for(size_t i = 0; i < byteCount && i < 8; ++i) {
+            value |= static_cast<uint64_t>(bytes[i]) << (56 - (i * 8));
+        }
+    } else if(byteCount >= 8) {
+        value = loadBigEndian64(bytes);
+    } else {
+        size_t loaded = 0;
+
+        if(byteCount & 4) {
+            value = static_cast<uint64_t>(loadBigEndian32(bytes)) << 32;
+            loaded = 4;
+        }
+
+        if(byteCount & 2) {
+            value |= static_cast<uint64_t>(loadBigEndian16(bytes + loaded)) << (48 - (loaded * 8));
+            loaded += 2;
+        }
+
+        if(byteCount & 1) {
+            value |= static_cast<uint64_t>(bytes[loaded]) << (56 - (loaded * 8));
+        }
+    }
+
+    value <<= shift;
+
+    if(byteCount > 8) {
+        value |= static_cast<uint64_t>(bytes[8]) >> (8 - shift);
+    }
+
+    return value >> (64 - bitCount);
+}
@@ -0,0 +1,215 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bitter_bit.hpp>
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Encodes a buffer as the lengths of its runs of equal bits
+    //!
+    //! \tparam  T  the type the source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[in]  source    where to read from
+    //! \param[in]  bitCount  how many bits to encode
+    //!
+    //! \returns  a byte holding the first bit (0 or 1), followed by the length of each run as a
+    //!           LEB128 varint, runs alternating between the two bit values; empty if \p bitCount is zero
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0xF0, 0xFF };
+    //!     const auto x = encodeRuns(data, 16); // returns { 0, 4, 12 }
+    //! \endcode
+    //!
+    //! \note  Run boundaries are found a word at a time: XORing a word with itself shifted by
+    //!        one bit leaves a set bit where each run starts, and those are visited with a count
+    //!        trailing zeros instruction, so words within a long run cost a single compare.
+    //!
+    //! \note  bits are numbered the same way as #getBit numbers them
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p source pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #decodeRuns
+    //!
+    template <typename T>
+    inline std::vector<uint8_t> encodeRuns(const T* source, size_t bitCount);
+
+    //!
+    //! \brief  Decodes runs encoded by #encodeRuns into a buffer
+    //!
+    //! \tparam  T  the type the target pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[out]  target      where to write to
+    //! \param[in]   bitCount    how many bits were encoded
+    //! \param[in]   source      the encoded runs
+    //! \param[in]   sourceSize  how many bytes \p source holds
+    //!
+    //! \returns  true if the runs were well formed and added up to \p bitCount, false otherwise
+    //!
+    //! \note  long runs are written with #fillBits, a memset at a time
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target and \p source pointers, so make sure they
+    //!           point to valid memory!
+    //!
+    template <typename T>
+    inline bool decodeRuns(T* target, size_t bitCount, const uint8_t* source, size_t sourceSize);
+
+    namespace detail {
+        //!
+        //! \brief  Appends a LEB128 varint, 7 bits per byte with the high bit set on all but the last
+        //!
+        inline void appendLeb128(std::vector<uint8_t>& target, uint64_t value);
+
+        //!
+        //! \brief  Reads a LEB128 varint and moves past it
+        //!
+        //! \returns  false if the varint runs past the end of the source or does not fit in 64 bits
+        //!
+        inline bool readLeb128(const uint8_t* source, size_t sourceSize, size_t& position, uint64_t& value);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <typename T>
+inline std::vector<uint8_t> bitter::encodeRuns(const T* const source, const size_t bitCount) {
+    std::vector<uint8_t> encoded;
+
+    if(bitCount == 0) {
+        return encoded;
+    }
+
+    const uint8_t* const bytes = detail::asBytes(source);
+
+    // pretending the bit before the first one equals it stops a run starting at bit 0
+    uint64_t previousBit = static_cast<uint64_t>(getBit(bytes, 0));
+    encoded.push_back(static_cast<uint8_t>(previousBit));
+
+    size_t runStart = 0;
+
+    for(size_t wordStart = 0; wordStart < bitCount; wordStart += 64) {
+        const size_t wordBits = std::min<size_t>(64, bitCount - wordStart);
+        const uint64_t word = wordBits == 64 ? detail::loadLittleEndian64(bytes + (wordStart / 8)) : getBits(bytes, wordStart, wordBits);
+
+        // bit i is set where bit i differs from the bit before it
+        uint64_t runStarts = (word ^ ((word << 1) | previousBit)) & detail::lowBitMask(wordBits);
+        previousBit = (word >> (wordBits - 1)) & 1;
+
+        for(; runStarts != 0; runStarts &= runStarts - 1) {
+            const size_t nextRunStart = wordStart + static_cast<size_t>(detail::countTrailingZeros(runStarts));
+
+            detail::appendLeb128(encoded, nextRunStart - runStart);
+            runStart = nextRunStart;
+        }
+    }
+
+    detail::appendLeb128(encoded, bitCount - runStart);
+    return encoded;
+}
+
+template <typename T>
+inline bool bitter::decodeRuns(T* const target, const size_t bitCount, const uint8_t* const source, const size_t sourceSize) {
+    if(bitCount == 0 || sourceSize == 0) {
+        return bitCount == 0 && sourceSize == 0;
+    }
+
+    if(source[0] > 1) {
+        return false;
+    }
+
+    uint8_t* const bytes = detail::asBytes(target);
+
+    Bit bitValue = source[0] != 0 ? Bit::One : Bit::Zero;
+    size_t bitNumber = 0;
+    size_t position = 1;
+
+    while(position < sourceSize) {
+        uint64_t runLength = 0;
+
+        if(! detail::readLeb128(source, sourceSize, position, runLength) || runLength == 0 || runLength > bitCount - bitNumber) {
+            return false;
+        }
+
+        if(runLength <= 64) {
+            setBits(bytes, bitNumber, static_cast<size_t>(runLength), bitValue == Bit::One ? ~uint64_t(0) : 0);
+        } else {
+            fillBits(bytes, bitNumber, static_cast<size_t>(runLength), bitValue);
+        }
+
+        bitNumber += static_cast<size_t>(runLength);
+        bitValue = bitValue == Bit::One ? Bit::Zero : Bit::One;
+    }
+
+    return bitNumber == bitCount;
+}
+
+inline void bitter::detail::appendLeb128(std::vector<uint8_t>& target, uint64_t value) {
+    for(; value >= 0x80; value >>= 7) {
+        target.push_back(static_cast<uint8_t>(value | 0x80));
+    }
+
+    target.push_back(static_cast<uint8_t>(value));
+}
+
+inline bool bitter::detail::readLeb128(const uint8_t* const source, const size_t sourceSize, size_t& position, uint64_t& value) {
+    value = 0;
+
+    for(size_t shift = 0; shift < 64; shift += 7) {
+        if(position >= sourceSize) {
+            return false;
+        }
+
+        const uint8_t byte = source[position++];
+        const uint64_t bits = byte & 0x7F;
+
+        // the tenth byte only has room for the top bit
+        if(shift == 63 && bits > 1) {
+            return false;
+        }
+
+        value |= bits << shift;
+
+        if((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,213 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_read.hpp>
+#include <bitter_word.hpp>
+#include <bitter_write.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Transposes an 8x8 bit matrix held in a word
+    //!
+    //! \param[in]  matrix  byte r is row r, bit c of a byte is column c
+    //!
+    //! \returns  the transposed matrix, bit c of byte r moves to bit r of byte c
+    //!
+    //! \par Example
+    //! \code
+    //!     const auto x = transpose8x8(0x00000000000000FF); // returns 0x0101010101010101
+    //! \endcode
+    //!
+    //! \note  swaps 4x4, 2x2 and 1x1 blocks with three shift-and-mask steps
+    //!
+    inline uint64_t transpose8x8(uint64_t matrix);
+
+    //!
+    //! \brief  Transposes a 64x64 bit matrix in place
+    //!
+    //! \param[in,out]  matrix  64 words, word r is row r, bit c of a word is column c
+    //!
+    //! \note  swaps 32x32, 16x16 and so on down to 1x1 blocks,
+    //!        six passes of 32 word pairs each without any per-bit work
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p matrix pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    inline void transpose64x64(uint64_t* matrix);
+
+    //!
+    //! \brief  Transposes a bit matrix of any size stored row after row in a buffer
+    //!
+    //! \tparam  T  the type the target pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \tparam  U  the type the source pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[out]  target   where to write the \p columns x \p rows result, must not overlap \p source
+    //! \param[in]   source   the matrix, the bit in row r and column c is bit (r * \p columns + c)
+    //! \param[in]   rows     how many rows \p source has
+    //! \param[in]   columns  how many columns \p source has
+    //!
+    //! \note  bits are numbered the same way as #getBit numbers them
+    //!
+    //! \note  the matrix is processed in 64x64 tiles so each tile's rows stay in cache,
+    //!        and every tile is transposed with #transpose64x64. When the compiler targets
+    //!        SSE2 and rows start at byte boundaries, 16x8 tiles are transposed with byte
+    //!        gathers and eight movemasks instead.
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target and \p source pointers, so make sure they
+    //!           point to valid memory!
+    //!
+    template <typename T, typename U>
+    inline void transposeBits(T* target, const U* source, size_t rows, size_t columns);
+
+    namespace detail {
+        //!
+        //! \brief  Transposes any matrix a 64x64 tile at a time
+        //!
+        inline void transposeBitsByTiles(uint8_t* target, const uint8_t* source, size_t rows, size_t columns);
+
+#if defined(__SSE2__)
+        //!
+        //! \brief  Transposes a matrix whose rows and columns are multiples of 16 and 8 a 16x8 tile at a time
+        //!
+        inline void transposeBitsWithMovemask(uint8_t* target, const uint8_t* source, size_t rows, size_t columns);
+#endif
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+inline uint64_t bitter::transpose8x8(uint64_t matrix) {
+    uint64_t swapped = (matrix ^ (matrix >> 7)) & 0x00AA00AA00AA00AA;
+    matrix ^= swapped ^ (swapped << 7);
+
+    swapped = (matrix ^ (matrix >> 14)) & 0x0000CCCC0000CCCC;
+    matrix ^= swapped ^ (swapped << 14);
+
+    swapped = (matrix ^ (matrix >> 28)) & 0x00000000F0F0F0F0;
+    matrix ^= swapped ^ (swapped << 28);
+
+    return matrix;
+}
+
+inline void bitter::transpose64x64(uint64_t* const matrix) {
+    uint64_t mask = 0x00000000FFFFFFFF;
+
+    for(size_t width = 32; width != 0; width >>= 1, mask ^= mask << width) {
+        // the high columns of row k swap places with the low columns of row k + width
+        for(size_t row = 0; row < 64; row = ((row | width) + 1) & ~width) {
+            const uint64_t swapped = ((matrix[row] >> width) ^ matrix[row | width]) & mask;
+
+            matrix[row] ^= swapped << width;
+            matrix[row | width] ^= swapped;
+        }
+    }
+}
+
+template <typename T, typename U>
+inline void bitter::transposeBits(T* const target, const U* const source, const size_t rows, const size_t columns) {
+#if defined(__SSE2__)
+    if(rows % 16 == 0 && columns % 8 == 0) {
+        detail::transposeBitsWithMovemask(detail::asBytes(target), detail::asBytes(source), rows, columns);
+        return;
+    }
+#endif
+
+    detail::transposeBitsByTiles(detail::asBytes(target), detail::asBytes(source), rows, columns);
+}
+
+inline void bitter::detail::transposeBitsByTiles(uint8_t* const target, const uint8_t* const source, const size_t rows, const size_t columns) {
+    uint64_t tile[64];
+
+    for(size_t firstRow = 0; firstRow < rows; firstRow += 64) {
+        const size_t height = std::min<size_t>(64, rows - firstRow);
+
+        for(size_t firstColumn = 0; firstColumn < columns; firstColumn += 64) {
+            const size_t width = std::min<size_t>(64, columns - firstColumn);
+
+            for(size_t row = 0; row < 64; ++row) {
+                tile[row] = row < height ? getBits(source, ((firstRow + row) * columns) + firstColumn, width) : 0;
+            }
+
+            transpose64x64(tile);
+
+            for(size_t column = 0; column < width; ++column) {
+                setBits(target, ((firstColumn + column) * rows) + firstRow, height, tile[column]);
+            }
+        }
+    }
+}
+
+#if defined(__SSE2__)
+inline void bitter::detail::transposeBitsWithMovemask(uint8_t* const target, const uint8_t* const source, const size_t rows, const size_t columns) {
+    const size_t rowBytes = columns / 8;
+    const size_t columnBytes = rows / 8;
+
+    // the 16x8 tiles are visited a 64x64 block at a time, so the rows of both matrices stay in cache
+    for(size_t firstRow = 0; firstRow < rows; firstRow += 64) {
+        const size_t lastRow = std::min<size_t>(rows, firstRow + 64);
+
+        for(size_t firstByte = 0; firstByte < rowBytes; firstByte += 8) {
+            const size_t lastByte = std::min<size_t>(rowBytes, firstByte + 8);
+
+            for(size_t row = firstRow; row < lastRow; row += 16) {
+                for(size_t byte = firstByte; byte < lastByte; ++byte) {
+                    const uint8_t* const column = source + (row * rowBytes) + byte;
+
+                    // byte i of the vector is row (row + i), so bit 7 of each byte is column 7 of the tile
+                    __m128i bits = _mm_setr_epi8(
+                        static_cast<char>(column[0 * rowBytes]), static_cast<char>(column[1 * rowBytes]),
+                        static_cast<char>(column[2 * rowBytes]), static_cast<char>(column[3 * rowBytes]),
+                        static_cast<char>(column[4 * rowBytes]), static_cast<char>(column[5 * rowBytes]),
+                        static_cast<char>(column[6 * rowBytes]), static_cast<char>(column[7 * rowBytes]),
+                        static_cast<char>(column[8 * rowBytes]), static_cast<char>(column[9 * rowBytes]),
+                        static_cast<char>(column[10 * rowBytes]), static_cast<char>(column[11 * rowBytes]),
+                        static_cast<char>(column[12 * rowBytes]), static_cast<char>(column[13 * rowBytes]),
+                        static_cast<char>(column[14 * rowBytes]), static_cast<char>(column[15 * rowBytes]));
+
+                    for(size_t bit = 8; bit-- > 0; bits = _mm_slli_epi64(bits, 1)) {
+                        const uint16_t transposed = static_cast<uint16_t>(_mm_movemask_epi8(bits));
+                        storeLittleEndian16(target + ((((byte * 8) + bit) * columnBytes) + (row / 8)), transposed);
+                    }
+                }
+            }
+        }
+    }
+}
+#endif
@@ -0,0 +1,433 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bitter_bit.hpp>
+#include <bitter_bit_reader.hpp>
+#include <bitter_bit_writer.hpp>
+#include <bitter_word.hpp>
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    //!
+    //! \brief  Reads an unsigned Exp-Golomb code, ue(v) in H.264 and HEVC
+    //!
+    //! \tparam  Order  the bit order of the reader,
+    //!                 should be inferred from the parameter,
+    //!                 do not set this explicitly
+    //!
+    //! \param[in,out]  reader  where to read from
+    //!
+    //! \returns  the value, or UINT64_MAX if the code is malformed (a prefix of 64 or more zero bits)
+    //!
+    //! \par Example
+    //! \code
+    //!     constexpr uint8_t data[] = { 0b01001100 };
+    //!     MsbBitReader reader(data, sizeof(data));
+    //!     const auto x = readExpGolomb(reader); // returns 1, the code is 010
+    //!     const auto y = readExpGolomb(reader); // returns 2, the code is 011
+    //! \endcode
+    //!
+    //! \note  the info bits following the prefix are read with a single BasicBitReader::read,
+    //!        so with BitOrder::LsbFirst the first of them is the least significant
+    //!
+    template <BitOrder Order>
+    inline uint64_t readExpGolomb(BasicBitReader<Order>& reader);
+
+    //!
+    //! \brief  Reads \p count unsigned Exp-Golomb codes
+    //!
+    //! \see  #readExpGolomb
+    //!
+    template <BitOrder Order>
+    inline void readExpGolomb(BasicBitReader<Order>& reader, uint64_t* target, size_t count);
+
+    //!
+    //! \brief  Writes an unsigned Exp-Golomb code
+    //!
+    //! \param[in,out]  writer  where to write to
+    //! \param[in]      value   the value to write, must be less than UINT64_MAX
+    //!
+    template <BitOrder Order>
+    inline void writeExpGolomb(BasicBitWriter<Order>& writer, uint64_t value);
+
+    //!
+    //! \brief  Writes \p count unsigned Exp-Golomb codes
+    //!
+    //! \see  #writeExpGolomb
+    //!
+    template <BitOrder Order>
+    inline void writeExpGolomb(BasicBitWriter<Order>& writer, const uint64_t* source, size_t count);
+
+    //!
+    //! \brief  Reads a signed Exp-Golomb code, se(v) in H.264 and HEVC
+    //!
+    //! \returns  the value, positive values having odd code numbers (1 is coded as 1, -1 as 2, 2 as 3...),
+    //!           or INT64_MIN if the code is malformed
+    //!
+    //! \see  #readExpGolomb
+    //!
+    template <BitOrder Order>
+    inline int64_t readSignedExpGolomb(BasicBitReader<Order>& reader);
+
+    //!
+    //! \brief  Reads \p count signed Exp-Golomb codes
+    //!
+    //! \see  #readSignedExpGolomb
+    //!
+    template <BitOrder Order>
+    inline void readSignedExpGolomb(BasicBitReader<Order>& reader, int64_t* target, size_t count);
+
+    //!
+    //! \brief  Writes a signed Exp-Golomb code
+    //!
+    //! \param[in,out]  writer  where to write to
+    //! \param[in]      value   the value to write, must not be INT64_MIN
+    //!
+    template <BitOrder Order>
+    inline void writeSignedExpGolomb(BasicBitWriter<Order>& writer, int64_t value);
+
+    //!
+    //! \brief  Writes \p count signed Exp-Golomb codes
+    //!
+    //! \see  #writeSignedExpGolomb
+    //!
+    template <BitOrder Order>
+    inline void writeSignedExpGolomb(BasicBitWriter<Order>& writer, const int64_t* source, size_t count);
+
+    //!
+    //! \brief  Reads an Elias gamma code: N zero bits, then the N + 1 significant bits of the value
+    //!
+    //! \returns  the value, which is at least 1, or 0 if the code is malformed
+    //!
+    //! \note  a gamma code of x is the Exp-Golomb code of x - 1
+    //!
+    template <BitOrder Order>
+    inline uint64_t readEliasGamma(BasicBitReader<Order>& reader);
+
+    //!
+    //! \brief  Reads \p count Elias gamma codes
+    //!
+    //! \see  #readEliasGamma
+    //!
+    template <BitOrder Order>
+    inline void readEliasGamma(BasicBitReader<Order>& reader, uint64_t* target, size_t count);
+
+    //!
+    //! \brief  Writes an Elias gamma code
+    //!
+    //! \param[in,out]  writer  where to write to
+    //! \param[in]      value   the value to write, must not be zero
+    //!
+    template <BitOrder Order>
+    inline void writeEliasGamma(BasicBitWriter<Order>& writer, uint64_t value);
+
+    //!
+    //! \brief  Writes \p count Elias gamma codes
+    //!
+    //! \see  #writeEliasGamma
+    //!
+    template <BitOrder Order>
+    inline void writeEliasGamma(BasicBitWriter<Order>& writer, const uint64_t* source, size_t count);
+
+    //!
+    //! \brief  Reads an Elias delta code: the bit length of the value as a gamma code,
+    //!         then the bits of the value below its highest set bit
+    //!
+    //! \returns  the value, which is at least 1, or 0 if the code is malformed
+    //!
+    template <BitOrder Order>
+    inline uint64_t readEliasDelta(BasicBitReader<Order>& reader);
+
+    //!
+    //! \brief  Reads \p count Elias delta codes
+    //!
+    //! \see  #readEliasDelta
+    //!
+    template <BitOrder Order>
+    inline void readEliasDelta(BasicBitReader<Order>& reader, uint64_t* target, size_t count);
+
+    //!
+    //! \brief  Writes an Elias delta code
+    //!
+    //! \param[in,out]  writer  where to write to
+    //! \param[in]      value   the value to write, must not be zero
+    //!
+    template <BitOrder Order>
+    inline void writeEliasDelta(BasicBitWriter<Order>& writer, uint64_t value);
+
+    //!
+    //! \brief  Writes \p count Elias delta codes
+    //!
+    //! \see  #writeEliasDelta
+    //!
+    template <BitOrder Order>
+    inline void writeEliasDelta(BasicBitWriter<Order>& writer, const uint64_t* source, size_t count);
+
+    //!
+    //! \brief  Reads a Golomb-Rice code: the quotient (value >> \p parameter) as that many zero bits
+    //!         followed by a set bit, then the low \p parameter bits of the value
+    //!
+    //! \param[in,out]  reader     where to read from
+    //! \param[in]      parameter  how many low bits are stored verbatim, in the range [0, 63]
+    //!
+    //! \returns  the value
+    //!
+    //! \warning  the quotient must fit in (64 - \p parameter) bits,
+    //!           a larger one (only possible for a malformed code) yields an unspecified value
+    //!
+    template <BitOrder Order>
+    inline uint64_t readRice(BasicBitReader<Order>& reader, size_t parameter);
+
+    //!
+    //! \brief  Reads \p count Golomb-Rice codes sharing the same parameter
+    //!
+    //! \see  #readRice
+    //!
+    template <BitOrder Order>
+    inline void readRice(BasicBitReader<Order>& reader, size_t parameter, uint64_t* target, size_t count);
+
+    //!
+    //! \brief  Writes a Golomb-Rice code
+    //!
+    //! \param[in,out]  writer     where to write to
+    //! \param[in]      value      the value to write
+    //! \param[in]      parameter  how many low bits are stored verbatim, in the range [0, 63]
+    //!
+    //! \note  the code is (value >> \p parameter) + 1 + \p parameter bits long,
+    //!        so \p parameter should be chosen close to the typical bit length of the values
+    //!
+    template <BitOrder Order>
+    inline void writeRice(BasicBitWriter<Order>& writer, uint64_t value, size_t parameter);
+
+    //!
+    //! \brief  Writes \p count Golomb-Rice codes sharing the same parameter
+    //!
+    //! \see  #writeRice
+    //!
+    template <BitOrder Order>
+    inline void writeRice(BasicBitWriter<Order>& writer, const uint64_t* source, size_t count, size_t parameter);
+
+    namespace detail {
+        //!
+        //! \brief  Writes \p zeros zero bits, a set bit, and then the low \p bitCount bits of \p bits
+        //!
+        //! \note  codes up to 64 bits long, which is nearly all of them, are written in one go
+        //!
+        template <BitOrder Order>
+        inline void writeUnaryAndBits(BasicBitWriter<Order>& writer, size_t zeros, uint64_t bits, size_t bitCount);
+
+        //!
+        //! \returns  the position of the highest set bit of \p value, which must not be zero
+        //!
+        inline size_t highestBitNumber(uint64_t value);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <bitter::BitOrder Order>
+inline uint64_t bitter::readExpGolomb(BasicBitReader<Order>& reader) {
+    const size_t zeros = reader.readUnary();
+
+    if(zeros >= 64) {
+        return ~uint64_t(0);
+    }
+
+    // 2^zeros - 1 codes are shorter than this one
+    return detail::lowBitMask(zeros) + reader.read(zeros);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::readExpGolomb(BasicBitReader<Order>& reader, uint64_t* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = readExpGolomb(reader);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeExpGolomb(BasicBitWriter<Order>& writer, const uint64_t value) {
+    const size_t zeros = detail::highestBitNumber(value + 1);
+    detail::writeUnaryAndBits(writer, zeros, value + 1, zeros);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeExpGolomb(BasicBitWriter<Order>& writer, const uint64_t* const source, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        writeExpGolomb(writer, source[i]);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline int64_t bitter::readSignedExpGolomb(BasicBitReader<Order>& reader) {
+    const uint64_t codeNumber = readExpGolomb(reader);
+
+    if(codeNumber == ~uint64_t(0)) {
+        return INT64_MIN;
+    }
+
+    const int64_t magnitude = static_cast<int64_t>((codeNumber >> 1) + (codeNumber & 1));
+    return (codeNumber & 1) ? magnitude : -magnitude;
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::readSignedExpGolomb(BasicBitReader<Order>& reader, int64_t* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = readSignedExpGolomb(reader);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeSignedExpGolomb(BasicBitWriter<Order>& writer, const int64_t value) {
+    // computed on the unsigned value so INT64_MAX does not overflow
+    const uint64_t magnitude = value > 0 ? static_cast<uint64_t>(value) : uint64_t(0) - static_cast<uint64_t>(value);
+    writeExpGolomb(writer, value > 0 ? (magnitude * 2) - 1 : magnitude * 2);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeSignedExpGolomb(BasicBitWriter<Order>& writer, const int64_t* const source, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        writeSignedExpGolomb(writer, source[i]);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline uint64_t bitter::readEliasGamma(BasicBitReader<Order>& reader) {
+    const size_t zeros = reader.readUnary();
+
+    if(zeros >= 64) {
+        return 0;
+    }
+
+    return (uint64_t(1) << zeros) | reader.read(zeros);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::readEliasGamma(BasicBitReader<Order>& reader, uint64_t* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = readEliasGamma(reader);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeEliasGamma(BasicBitWriter<Order>& writer, const uint64_t value) {
+    const size_t zeros = detail::highestBitNumber(value);
+    detail::writeUnaryAndBits(writer, zeros, value, zeros);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeEliasGamma(BasicBitWriter<Order>& writer, const uint64_t* const source, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        writeEliasGamma(writer, source[i]);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline uint64_t bitter::readEliasDelta(BasicBitReader<Order>& reader) {
+    const uint64_t bitLength = readEliasGamma(reader);
+
+    if(bitLength == 0 || bitLength > 64) {
+        return 0;
+    }
+
+    return (uint64_t(1) << (bitLength - 1)) | reader.read(bitLength - 1);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::readEliasDelta(BasicBitReader<Order>& reader, uint64_t* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = readEliasDelta(reader);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeEliasDelta(BasicBitWriter<Order>& writer, const uint64_t value) {
+    const size_t lowBits = detail::highestBitNumber(value);
+
+    writeEliasGamma(writer, lowBits + 1);
+    writer.write(value, lowBits);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeEliasDelta(BasicBitWriter<Order>& writer, const uint64_t* const source, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        writeEliasDelta(writer, source[i]);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline uint64_t bitter::readRice(BasicBitReader<Order>& reader, const size_t parameter) {
+    const uint64_t quotient = reader.readUnary();
+    return (quotient << parameter) | reader.read(parameter);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::readRice(BasicBitReader<Order>& reader, const size_t parameter, uint64_t* const target, const size_t count) {
+    for(size_t i = 0; i < count; ++i) {
+        target[i] = readRice(reader, parameter);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeRice(BasicBitWriter<Order>& writer, const uint64_t value, const size_t parameter) {
+    detail::writeUnaryAndBits(writer, static_cast<size_t>(value >> parameter), value, parameter);
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::writeRice(BasicBitWriter<Order>& writer, const uint64_t* const source, const size_t count, const size_t parameter) {
+    for(size_t i = 0; i < count; ++i) {
+        writeRice(writer, source[i], parameter);
+    }
+}
+
+template <bitter::BitOrder Order>
+inline void bitter::detail::writeUnaryAndBits(BasicBitWriter<Order>& writer, size_t zeros, const uint64_t bits, const size_t bitCount) {
+    const size_t totalBits = zeros + 1 + bitCount;
+
+    if(totalBits <= 64) {
+        const uint64_t lowBits = bits & lowBitMask(bitCount);
+
+        if(Order == BitOrder::MsbFirst) {
+            writer.write((uint64_t(1) << bitCount) | lowBits, totalBits);
+        } else {
+            writer.write(((lowBits << 1) | 1) << zeros, totalBits);
+        }
+
+        return;
+    }
+
+    for(; zeros > 64; zeros -= 64) {
+        writer.write(0, 64);
+    }
+
+    writer.write(0, zeros);
+    writer.writeBit(Bit::One);
+    writer.write(bits, bitCount);
+}
+
+inline size_t bitter::detail::highestBitNumber(const uint64_t value) {
+    return static_cast<size_t>(63 - countLeadingZeros(value));
+}
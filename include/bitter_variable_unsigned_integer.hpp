@@ -27,6 +27,7 @@
 #include <cctype>
 #include <string>
 
+#include <bitter_extract_deposit.hpp>
 #include <bitter_read.hpp>
 #include <bitter_write.hpp>
 
@@ -975,6 +976,52 @@ namespace bitter {
     //!
     inline VariableUnsignedInteger operator~(VariableUnsignedInteger value);
 
+    //!
+    //! \brief  Gathers the bits of a VariableUnsignedInteger selected by a mask into the low bits of the result
+    //!
+    //! \param[in]  value  where to take the bits from
+    //! \param[in]  mask   which bits of \p value to take
+    //!
+    //! \returns  a VariableUnsignedInteger whose bit i is the bit of \p value under the i-th set bit of \p mask,
+    //!           whose maxValue() >= max(value.maxValue(), mask.maxValue())
+    //!
+    //! \par Example
+    //! \code
+    //!     // given two VariableUnsignedIntegers called x and y
+    //!     x = 0xB2;
+    //!     y = 0xF0;
+    //!     const VariableUnsignedInteger extracted = extractBits(x, y); // return value == 0xB
+    //! \endcode
+    //!
+    //! \note  works 64 bits at a time with the uint64_t #extractBits
+    //!
+    //! \relates  VariableUnsignedInteger
+    //!
+    inline VariableUnsignedInteger extractBits(const VariableUnsignedInteger& value, const VariableUnsignedInteger& mask);
+
+    //!
+    //! \brief  Scatters the low bits of a VariableUnsignedInteger to the positions of the set bits of a mask
+    //!
+    //! \param[in]  value  where to take the bits from, starting at the least significant bit
+    //! \param[in]  mask   where to put the bits
+    //!
+    //! \returns  a VariableUnsignedInteger whose bit under the i-th set bit of \p mask is bit i of \p value,
+    //!           whose maxValue() >= max(value.maxValue(), mask.maxValue())
+    //!
+    //! \par Example
+    //! \code
+    //!     // given two VariableUnsignedIntegers called x and y
+    //!     x = 0xB;
+    //!     y = 0xF0;
+    //!     const VariableUnsignedInteger deposited = depositBits(x, y); // return value == 0xB0
+    //! \endcode
+    //!
+    //! \note  works 64 bits at a time with the uint64_t #depositBits
+    //!
+    //! \relates  VariableUnsignedInteger
+    //!
+    inline VariableUnsignedInteger depositBits(const VariableUnsignedInteger& value, const VariableUnsignedInteger& mask);
+
     class VariableUnsignedInteger {
     public:
         //!
@@ -1204,6 +1251,8 @@ namespace bitter {
         friend VariableUnsignedInteger operator<<(VariableUnsignedInteger, VariableUnsignedInteger);
         friend VariableUnsignedInteger operator>>(VariableUnsignedInteger, VariableUnsignedInteger);
         friend VariableUnsignedInteger operator~(VariableUnsignedInteger);
+        friend VariableUnsignedInteger extractBits(const VariableUnsignedInteger&, const VariableUnsignedInteger&);
+        friend VariableUnsignedInteger depositBits(const VariableUnsignedInteger&, const VariableUnsignedInteger&);
 
         template <template<typename> class Operation>
         friend VariableUnsignedInteger applyBinaryOperationBetweenChunks(const VariableUnsignedInteger&, const VariableUnsignedInteger&);
@@ -1935,6 +1984,62 @@ namespace bitter {
         return value;
     }
 
+    ///////////////////////////
+    // bit extract / deposit //
+    ///////////////////////////
+
+    inline VariableUnsignedInteger extractBits(const VariableUnsignedInteger& value, const VariableUnsignedInteger& mask) {
+        VariableUnsignedInteger result(std::max(value.m_data.size(), mask.m_data.size()));
+        result = 0;
+
+        const size_t maskBits = mask.m_data.size() * 8;
+        const size_t valueBits = value.m_data.size() * 8;
+        size_t resultBit = 0;
+
+        for(size_t bitNumber = 0; bitNumber < maskBits; bitNumber += 64) {
+            const size_t bitCount = std::min<size_t>(64, maskBits - bitNumber);
+            const uint64_t maskWord = getBits(mask.m_data.data(), bitNumber, bitCount);
+
+            if(maskWord == 0) {
+                continue;
+            }
+
+            const uint64_t valueWord = bitNumber < valueBits ? getBits(value.m_data.data(), bitNumber, std::min<size_t>(bitCount, valueBits - bitNumber)) : 0;
+            const size_t extractedBits = static_cast<size_t>(detail::popCount(maskWord));
+
+            setBits(result.m_data.data(), resultBit, extractedBits, extractBits(valueWord, maskWord));
+            resultBit += extractedBits;
+        }
+
+        return result;
+    }
+
+    inline VariableUnsignedInteger depositBits(const VariableUnsignedInteger& value, const VariableUnsignedInteger& mask) {
+        VariableUnsignedInteger result(std::max(value.m_data.size(), mask.m_data.size()));
+        result = 0;
+
+        const size_t maskBits = mask.m_data.size() * 8;
+        const size_t valueBits = value.m_data.size() * 8;
+        size_t valueBit = 0;
+
+        for(size_t bitNumber = 0; bitNumber < maskBits && valueBit < valueBits; bitNumber += 64) {
+            const size_t bitCount = std::min<size_t>(64, maskBits - bitNumber);
+            const uint64_t maskWord = getBits(mask.m_data.data(), bitNumber, bitCount);
+
+            if(maskWord == 0) {
+                continue;
+            }
+
+            const size_t depositedBits = static_cast<size_t>(detail::popCount(maskWord));
+            const uint64_t valueWord = getBits(value.m_data.data(), valueBit, std::min<size_t>(depositedBits, valueBits - valueBit));
+
+            setBits(result.m_data.data(), bitNumber, bitCount, depositBits(valueWord, maskWord));
+            valueBit += depositedBits;
+        }
+
+        return result;
+    }
+
     //////////////////////
     // stream operators //
     //////////////////////
@@ -0,0 +1,337 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <stdlib.h>
+#endif
+
+// Bits are numbered from the lowest address upwards, least significant bit first,
+// which is exactly the little-endian interpretation of the bytes.
+// Big-endian hosts therefore need to swap bytes after every word load / before every word store.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define BITTER_BIG_ENDIAN 1
+#endif
+
+// Lets constexpr functions pick a constant-evaluation friendly path
+// without giving up memcpy based word loads at runtime.
+#if (defined(__GNUC__) && ! defined(__clang__) && __GNUC__ >= 9) \
+ || (defined(__clang__) && __clang_major__ >= 9) \
+ || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define BITTER_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define BITTER_IS_CONSTANT_EVALUATED() false
+#endif
+
+///
+/// INTERFACE
+///
+
+namespace bitter {
+    namespace detail {
+        //!
+        //! \brief  Views any pointer as a pointer to its bytes
+        //!
+        //! \note  the uint8_t overload involves no cast,
+        //!        so it can be used during constant evaluation
+        //!
+        template <typename T>
+        inline const uint8_t* asBytes(const T* source);
+
+        inline constexpr const uint8_t* asBytes(const uint8_t* source);
+
+        template <typename T>
+        inline uint8_t* asBytes(T* target);
+
+        inline constexpr uint8_t* asBytes(uint8_t* target);
+
+        //!
+        //! \brief  Creates a mask with the lowest \p bitCount bits set
+        //!
+        //! \param[in]  bitCount  how many bits to set, in the range [0, 64]
+        //!
+        inline constexpr uint64_t lowBitMask(size_t bitCount);
+
+        //!
+        //! \brief  Counts how many bits are set in a word
+        //!
+        inline int popCount(uint64_t value);
+
+        //!
+        //! \brief  Counts the zero bits below the lowest set bit of a word
+        //!
+        //! \warning  \p value must not be zero
+        //!
+        inline int countTrailingZeros(uint64_t value);
+
+        //!
+        //! \brief  Counts the zero bits above the highest set bit of a word
+        //!
+        //! \warning  \p value must not be zero
+        //!
+        inline int countLeadingZeros(uint64_t value);
+
+        //!
+        //! \brief  Reverses the order of the bytes in a word
+        //!
+        inline uint64_t byteSwap(uint64_t value);
+
+        //!
+        //! \brief  Loads 8 / 4 / 2 bytes as a little-endian word, no alignment required
+        //!
+        inline uint64_t loadLittleEndian64(const uint8_t* source);
+        inline uint32_t loadLittleEndian32(const uint8_t* source);
+        inline uint16_t loadLittleEndian16(const uint8_t* source);
+
+        //!
+        //! \brief  Stores a word as 8 / 4 / 2 little-endian bytes, no alignment required
+        //!
+        inline void storeLittleEndian64(uint8_t* target, uint64_t value);
+        inline void storeLittleEndian32(uint8_t* target, uint32_t value);
+        inline void storeLittleEndian16(uint8_t* target, uint16_t value);
+
+        //!
+        //! \brief  Loads 8 / 4 / 2 bytes as a big-endian word, no alignment required
+        //!
+        inline uint64_t loadBigEndian64(const uint8_t* source);
+        inline uint32_t loadBigEndian32(const uint8_t* source);
+        inline uint16_t loadBigEndian16(const uint8_t* source);
+
+        //!
+        //! \brief  Stores a word as 8 / 4 / 2 big-endian bytes, no alignment required
+        //!
+        inline void storeBigEndian64(uint8_t* target, uint64_t value);
+        inline void storeBigEndian32(uint8_t* target, uint32_t value);
+        inline void storeBigEndian16(uint8_t* target, uint16_t value);
+    }
+}
+
+///
+/// IMPLEMENTATION
+///
+
+template <typename T>
+inline const uint8_t* bitter::detail::asBytes(const T* const source) {
+    return reinterpret_cast<const uint8_t*>(source);
+}
+
+inline constexpr const uint8_t* bitter::detail::asBytes(const uint8_t* const source) {
+    return source;
+}
+
+template <typename T>
+inline uint8_t* bitter::detail::asBytes(T* const target) {
+    return reinterpret_cast<uint8_t*>(target);
+}
+
+inline constexpr uint8_t* bitter::detail::asBytes(uint8_t* const target) {
+    return target;
+}
+
+inline constexpr uint64_t bitter::detail::lowBitMask(const size_t bitCount) {
+    // shifting a 64-bit value by 64 is undefined, so that case is handled separately
+    return bitCount >= 64 ? ~uint64_t(0) : ((uint64_t(1) << bitCount) - 1);
+}
+
+inline int bitter::detail::popCount(const uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+    // POPCNT is only guaranteed to exist alongside AVX
+    return static_cast<int>(__popcnt64(value));
+#else
+    uint64_t count = value - ((value >> 1) & 0x5555555555555555);
+    count = (count & 0x3333333333333333) + ((count >> 2) & 0x3333333333333333);
+    count = (count + (count >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return static_cast<int>((count * 0x0101010101010101) >> 56);
+#endif
+}
+
+inline int bitter::detail::countTrailingZeros(const uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    int count = 0;
+
+    for(uint64_t remaining = value; (remaining & 1) == 0; remaining >>= 1) {
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+inline int bitter::detail::countLeadingZeros(const uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<int>(index);
+#else
+    int count = 0;
+
+    for(uint64_t remaining = value; (remaining & (uint64_t(1) << 63)) == 0; remaining <<= 1) {
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+inline uint64_t bitter::detail::byteSwap(const uint64_t value) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(value);
+#else
+    uint64_t result = 0;
+
+    for(size_t i = 0; i < 8; ++i) {
+        result |= ((value >> (i * 8)) & 0xFF) << ((7 - i) * 8);
+    }
+
+    return result;
+#endif
+}
+
+inline uint64_t bitter::detail::loadLittleEndian64(const uint8_t* const source) {
+    uint64_t value;
+    std::memcpy(&value, source, sizeof(value));
+
+#if defined(BITTER_BIG_ENDIAN)
+    value = byteSwap(value);
+#endif
+
+    return value;
+}
+
+inline uint32_t bitter::detail::loadLittleEndian32(const uint8_t* const source) {
+#if defined(BITTER_BIG_ENDIAN)
+    return static_cast<uint32_t>(source[0])
+         | (static_cast<uint32_t>(source[1]) << 8)
+         | (static_cast<uint32_t>(source[2]) << 16)
+         | (static_cast<uint32_t>(source[3]) << 24);
+#else
+    uint32_t value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+#endif
+}
+
+inline uint16_t bitter::detail::loadLittleEndian16(const uint8_t* const source) {
+#if defined(BITTER_BIG_ENDIAN)
+    return static_cast<uint16_t>(source[0] | (source[1] << 8));
+#else
+    uint16_t value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+#endif
+}
+
+inline void bitter::detail::storeLittleEndian64(uint8_t* const target, uint64_t value) {
+#if defined(BITTER_BIG_ENDIAN)
+    value = byteSwap(value);
+#endif
+
+    std::memcpy(target, &value, sizeof(value));
+}
+
+inline void bitter::detail::storeLittleEndian32(uint8_t* const target, const uint32_t value) {
+#if defined(BITTER_BIG_ENDIAN)
+    target[0] = static_cast<uint8_t>(value);
+    target[1] = static_cast<uint8_t>(value >> 8);
+    target[2] = static_cast<uint8_t>(value >> 16);
+    target[3] = static_cast<uint8_t>(value >> 24);
+#else
+    std::memcpy(target, &value, sizeof(value));
+#endif
+}
+
+inline void bitter::detail::storeLittleEndian16(uint8_t* const target, const uint16_t value) {
+#if defined(BITTER_BIG_ENDIAN)
+    target[0] = static_cast<uint8_t>(value);
+    target[1] = static_cast<uint8_t>(value >> 8);
+#else
+    std::memcpy(target, &value, sizeof(value));
+#endif
+}
+
+inline uint64_t bitter::detail::loadBigEndian64(const uint8_t* const source) {
+    uint64_t value;
+    std::memcpy(&value, source, sizeof(value));
+
+#if ! defined(BITTER_BIG_ENDIAN)
+    value = byteSwap(value);
+#endif
+
+    return value;
+}
+
+inline uint32_t bitter::detail::loadBigEndian32(const uint8_t* const source) {
+#if defined(BITTER_BIG_ENDIAN)
+    uint32_t value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+#else
+    return static_cast<uint32_t>(byteSwap(loadLittleEndian32(source)) >> 32);
+#endif
+}
+
+inline uint16_t bitter::detail::loadBigEndian16(const uint8_t* const source) {
+#if defined(BITTER_BIG_ENDIAN)
+    uint16_t value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+#else
+    return static_cast<uint16_t>(byteSwap(loadLittleEndian16(source)) >> 48);
+#endif
+}
+
+inline void bitter::detail::storeBigEndian64(uint8_t* const target, uint64_t value) {
+#if ! defined(BITTER_BIG_ENDIAN)
+    value = byteSwap(value);
+#endif
+
+    std::memcpy(target, &value, sizeof(value));
+}
+
+inline void bitter::detail::storeBigEndian32(uint8_t* const target, const uint32_t value) {
+#if defined(BITTER_BIG_ENDIAN)
+    std::memcpy(target, &value, sizeof(value));
+#else
+    storeLittleEndian32(target, static_cast<uint32_t>(byteSwap(value) >> 32));
+#endif
+}
+
+inline void bitter::detail::storeBigEndian16(uint8_t* const target, const uint16_t value) {
+#if defined(BITTER_BIG_ENDIAN)
+    std::memcpy(target, &value, sizeof(value));
+#else
+    storeLittleEndian16(target, static_cast<uint16_t>(byteSwap(value) >> 48));
+#endif
+}
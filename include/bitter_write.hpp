@@ -17,7 +17,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 #include <bitter_bit.hpp>
+#include <bitter_word.hpp>
 
 ///
 /// INTERFACE
@@ -27,6 +33,8 @@ namespace bitter {
     //!
     //! \brief  Sets the state of a bit
     //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
     //! \tparam  T  the type the target pointer points to,
     //!             should be inferred from the parameter,
     //!             do not set this explicitly
@@ -48,21 +56,103 @@ namespace bitter {
     //!
     //! \see  #getBit
     //! \see  #Bit
+    //! \see  #BitOrder
     //!
-    template <typename T>
+    template <BitOrder Order = BitOrder::LsbFirst, typename T>
     inline constexpr void setBit(T* target, size_t bitNumber, Bit bitValue);
+
+    //!
+    //! \brief  Sets the state of a range of bits from a single value
+    //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
+    //! \tparam  T  the type the target pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[out]  target     where to write to
+    //! \param[in]   bitOffset  the first bit to set (zero-indexed)
+    //! \param[in]   bitCount   how many bits to set, in the range [0, 64]
+    //! \param[in]   value      what to set the bits to, where bit 0 of \p value
+    //!                         (BitOrder::LsbFirst) or bit (\p bitCount - 1) of \p value
+    //!                         (BitOrder::MsbFirst) goes to bit \p bitOffset of \p target;
+    //!                         bits of \p value above \p bitCount are ignored
+    //!
+    //! \par Example
+    //! \code
+    //!     uint8_t data[] = { 0, 0 };
+    //!     setBits(data, 4, 8, 0xFF);                     // data is now { 0xF0, 0x0F }
+    //!     setBits<BitOrder::MsbFirst>(data, 0, 12, 0x5); // data is now { 0x00, 0x5F }
+    //! \endcode
+    //!
+    //! \note  only the bytes that contain the requested bits are touched,
+    //!        and bits outside of the range keep their values;
+    //!        fields spanning 8 bytes or more are merged with a single
+    //!        unaligned word read-modify-write, byte-swapped for BitOrder::MsbFirst
+    //!
+    //! \note  when \p target points to uint8_t this can be
+    //!        used in constant expressions
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #setBit
+    //! \see  #getBits
+    //!
+    template <BitOrder Order = BitOrder::LsbFirst, typename T>
+    inline constexpr void setBits(T* target, size_t bitOffset, size_t bitCount, uint64_t value);
+
+    //!
+    //! \brief  Sets every bit of a range to the same state
+    //!
+    //! \tparam  Order  how the bits within each byte are numbered
+    //!
+    //! \tparam  T  the type the target pointer points to,
+    //!             should be inferred from the parameter,
+    //!             do not set this explicitly
+    //!
+    //! \param[out]  target     where to write to
+    //! \param[in]   bitOffset  the first bit to set (zero-indexed)
+    //! \param[in]   bitCount   how many bits to set, there is no upper limit
+    //! \param[in]   bitValue   what to set the bits to
+    //!
+    //! \par Example
+    //! \code
+    //!     uint8_t data[] = { 0, 0, 0 };
+    //!     fillBits(data, 4, 16, Bit::One); // data is now { 0xF0, 0xFF, 0x0F }
+    //! \endcode
+    //!
+    //! \note  the bits before the first and after the last whole byte are set with #setBits,
+    //!        the whole bytes in between with a single memset
+    //!
+    //! \warning  this function necessarily dereferences
+    //!           the \p target pointer, so make sure it
+    //!           points to valid memory!
+    //!
+    //! \see  #setBits
+    //!
+    template <BitOrder Order = BitOrder::LsbFirst, typename T>
+    inline void fillBits(T* target, size_t bitOffset, size_t bitCount, Bit bitValue);
+
+    namespace detail {
+        //!
+        //! \brief  The BitOrder::MsbFirst half of #setBits
+        //!
+        inline constexpr void setBitsMsbFirst(uint8_t* target, size_t bitOffset, size_t bitCount, uint64_t value);
+    }
 }
 
 ///
 /// IMPLEMENTATION
 ///
 
-template <typename T>
+template <bitter::BitOrder Order, typename T>
 inline constexpr void bitter::setBit(T* const target, size_t bitNumber, const bitter::Bit bitValue) {
     char* const castTarget = reinterpret_cast<char* const>(target);
 
     const size_t byteNumber = bitNumber / 8;
-    bitNumber %= 8;
+    bitNumber = Order == BitOrder::MsbFirst ? 7 - (bitNumber % 8) : bitNumber % 8;
 
     char* const targetByte = (castTarget + byteNumber);
 
@@ -71,3 +161,137 @@ inline constexpr void bitter::setBit(T* const target, size_t bitNumber, const bi
     *targetByte = (*targetByte & ~(1 << bitNumber)) | (static_cast<int>(bitValue) << bitNumber);
 }
 
+
+template <bitter::BitOrder Order, typename T>
+inline constexpr void bitter::setBits(T* const target, const size_t bitOffset, const size_t bitCount, uint64_t value) {
+    if(Order == BitOrder::MsbFirst) {
+        detail::setBitsMsbFirst(detail::asBytes(target), bitOffset, bitCount, value);
+        return;
+    }
+
+    if(bitCount == 0) {
+        return;
+    }
+
+    uint8_t* const bytes = detail::asBytes(target) + (bitOffset / 8);
+
+    const size_t shift = bitOffset % 8;
+    const size_t byteCount = (shift + bitCount + 7) / 8;
+
+    const uint64_t mask = detail::lowBitMask(bitCount);
+    value &= mask;
+
+    // the part of the field that lives in the first 8 bytes
+    const uint64_t lowMask = mask << shift;
+    const uint64_t lowValue = value << shift;
+
+    if(BITTER_IS_CONSTANT_EVALUATED()) {
+        for(size_t i = 0; i < byteCount && i < 8; ++i) {
+            const uint8_t byteMask = static_cast<uint8_t>(lowMask >> (i * 8));
+            bytes[i] = static_cast<uint8_t>((bytes[i] & ~byteMask) | (lowValue >> (i * 8)));
+        }
+    } else if(byteCount >= 8) {
+        const uint64_t word = detail::loadLittleEndian64(bytes);
+        detail::storeLittleEndian64(bytes, (word & ~lowMask) | lowValue);
+    } else {
+        // fewer than 8 bytes hold the field, so only those are touched:
+        // at most one 4, one 2 and one 1 byte read-modify-write, selected by the bits of byteCount
+        size_t merged = 0;
+
+        if(byteCount & 4) {
+            const uint32_t word = detail::loadLittleEndian32(bytes);
+            const uint32_t wordMask = static_cast<uint32_t>(lowMask);
+            detail::storeLittleEndian32(bytes, (word & ~wordMask) | static_cast<uint32_t>(lowValue));
+            merged = 4;
+        }
+
+        if(byteCount & 2) {
+            const uint16_t word = detail::loadLittleEndian16(bytes + merged);
+            const uint16_t wordMask = static_cast<uint16_t>(lowMask >> (merged * 8));
+            detail::storeLittleEndian16(bytes + merged, static_cast<uint16_t>((word & ~wordMask) | (lowValue >> (merged * 8))));
+            merged += 2;
+        }
+
+        if(byteCount & 1) {
+            const uint8_t byteMask = static_cast<uint8_t>(lowMask >> (merged * 8));
+            bytes[merged] = static_cast<uint8_t>((bytes[merged] & ~byteMask) | (lowValue >> (merged * 8)));
+        }
+    }
+
+    // a 64-bit field that doesn't start on a byte boundary spills into a ninth byte
+    if(byteCount > 8) {
+        const uint8_t byteMask = static_cast<uint8_t>(mask >> (64 - shift));
+        bytes[8] = static_cast<uint8_t>((bytes[8] & ~byteMask) | (value >> (64 - shift)));
+    }
+}
+
+template <bitter::BitOrder Order, typename T>
+inline void bitter::fillBits(T* const target, size_t bitOffset, size_t bitCount, const bitter::Bit bitValue) {
+    uint8_t* const bytes = detail::asBytes(target);
+    const uint64_t value = bitValue == Bit::One ? ~uint64_t(0) : 0;
+
+    const size_t headBits = std::min<size_t>((8 - (bitOffset % 8)) % 8, bitCount);
+    setBits<Order>(bytes, bitOffset, headBits, value);
+
+    bitOffset += headBits;
+    bitCount -= headBits;
+
+    std::memset(bytes + (bitOffset / 8), static_cast<int>(value & 0xFF), bitCount / 8);
+    setBits<Order>(bytes, bitOffset + ((bitCount / 8) * 8), bitCount % 8, value);
+}
+
+inline constexpr void bitter::detail::setBitsMsbFirst(uint8_t* const target, const size_t bitOffset, const size_t bitCount, const uint64_t value) {
+    if(bitCount == 0) {
+        return;
+    }
+
+    uint8_t* const bytes = target + (bitOffset / 8);
+
+    const size_t shift = bitOffset % 8;
+    const size_t byteCount = (shift + bitCount + 7) / 8;
+
+    // the field left-aligned, so its first bit is the top bit of the word
+    const uint64_t alignedMask = lowBitMask(bitCount) << (64 - bitCount);
+    const uint64_t alignedValue = value << (64 - bitCount);
+
+    // the part of the field that lives in the first 8 bytes, with the first byte in the top 8 bits
+    const uint64_t highMask = alignedMask >> shift;
+    const uint64_t highValue = (alignedValue & alignedMask) >> shift;
+
+    if(BITTER_IS_CONSTANT_EVALUATED()) {
+        for(size_t i = 0; i < byteCount && i < 8; ++i) {
+            const uint8_t byteMask = static_cast<uint8_t>(highMask >> (56 - (i * 8)));
+            bytes[i] = static_cast<uint8_t>((bytes[i] & ~byteMask) | (highValue >> (56 - (i * 8))));
+        }
+    } else if(byteCount >= 8) {
+        const uint64_t word = loadBigEndian64(bytes);
+        storeBigEndian64(bytes, (word & ~highMask) | highValue);
+    } else {
+        size_t merged = 0;
+
+        if(byteCount & 4) {
+            const uint32_t word = loadBigEndian32(bytes);
+            const uint32_t wordMask = static_cast<uint32_t>(highMask >> 32);
+            storeBigEndian32(bytes, (word & ~wordMask) | static_cast<uint32_t>(highValue >> 32));
+            merged = 4;
+        }
+
+        if(byteCount & 2) {
+            const uint16_t word = loadBigEndian16(bytes + merged);
+            const uint16_t wordMask = static_cast<uint16_t>(highMask >> (48 - (merged * 8)));
+            storeBigEndian16(bytes + merged, static_cast<uint16_t>((word & ~wordMask) | (highValue >> (48 - (merged * 8)))));
+            merged += 2;
+        }
+
+        if(byteCount & 1) {
+            const uint8_t byteMask = static_cast<uint8_t>(highMask >> (56 - (merged * 8)));
+            bytes[merged] = static_cast<uint8_t>((bytes[merged] & ~byteMask) | (highValue >> (56 - (merged * 8))));
+        }
+    }
+
+    // a field that doesn't fit in 8 bytes leaves its last bits at the top of a ninth byte
+    if(byteCount > 8) {
+        const uint8_t byteMask = static_cast<uint8_t>(alignedMask << (8 - shift));
+        bytes[8] = static_cast<uint8_t>((bytes[8] & ~byteMask) | (alignedValue << (8 - shift)));
+    }
+}
@@ -0,0 +1,91 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <bitter_atomic.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bits can be changed atomically") {
+            GIVEN("an array of atomic words") {
+                std::atomic<uint64_t> words[4];
+                for(auto& word : words) {
+                    word = 0;
+                }
+
+                WHEN("bits are set, cleared and flipped") {
+                    atomicSetBit(words, 70);
+                    const Bit firstTest = atomicTestAndSetBit(words, 70);
+                    const Bit secondTest = atomicTestAndSetBit(words, 3, std::memory_order_relaxed);
+                    const Bit flipped = atomicFlipBit(words, 255);
+                    atomicClearBit(words, 3, std::memory_order_release);
+                    const Bit cleared = atomicTestAndClearBit(words, 70, std::memory_order_acq_rel);
+
+                    THEN("the words reflect the changes and the previous states are returned") {
+                        REQUIRE(firstTest == Bit::One);
+                        REQUIRE(secondTest == Bit::Zero);
+                        REQUIRE(flipped == Bit::Zero);
+                        REQUIRE(cleared == Bit::One);
+
+                        REQUIRE(words[0] == 0);
+                        REQUIRE(words[1] == 0);
+                        REQUIRE(words[3] == (uint64_t(1) << 63));
+                        REQUIRE(atomicGetBit(words, 255) == Bit::One);
+                        REQUIRE(atomicGetBit(words, 254, std::memory_order_acquire) == Bit::Zero);
+                    }
+                }
+
+                WHEN("several threads race to set every bit") {
+                    const size_t threadCount = 8;
+                    std::atomic<size_t> winners(0);
+                    std::vector<std::thread> threads;
+
+                    for(size_t t = 0; t < threadCount; ++t) {
+                        threads.emplace_back([&words, &winners, t]() {
+                            // every thread visits every bit, in a different order
+                            for(size_t i = 0; i < 256; ++i) {
+                                const size_t bitNumber = (i * 37 + t * 11) % 256;
+
+                                if(atomicTestAndSetBit(words, bitNumber, std::memory_order_relaxed) == Bit::Zero) {
+                                    ++winners;
+                                }
+                            }
+                        });
+                    }
+
+                    for(auto& thread : threads) {
+                        thread.join();
+                    }
+
+                    THEN("no update is lost and each bit is won exactly once") {
+                        REQUIRE(winners == 256);
+
+                        for(const auto& word : words) {
+                            REQUIRE(word == ~uint64_t(0));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,184 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <bitter_bit_pack.hpp>
+
+namespace bitter {
+    namespace test {
+        //!
+        //! \brief  Packs and unpacks blocks at every width, checking the scalar kernels give the same bytes
+        //!
+        template <size_t BlockSize>
+        void checkEveryWidth() {
+            using Scalar = detail::BitPackScalar<BlockSize / 32>;
+
+            std::mt19937 random(0x9E3779B9);
+
+            for(size_t width = 0; width <= 32; ++width) {
+                const uint32_t reference = static_cast<uint32_t>(random());
+
+                std::vector<uint32_t> values(BlockSize);
+                for(uint32_t& value : values) {
+                    value = reference + static_cast<uint32_t>(random() & detail::lowBitMask(width));
+                }
+
+                REQUIRE(BitPack<BlockSize>::bitWidth(values.data(), reference) <= width);
+
+                std::vector<uint8_t> packed(BitPack<BlockSize>::packedBytes(width));
+                std::vector<uint8_t> scalarPacked(packed.size());
+
+                BitPack<BlockSize>::pack(values.data(), width, packed.data(), reference);
+                detail::bitPack<Scalar>(values.data(), width, scalarPacked.data(), reference, std::make_index_sequence<33>());
+
+                REQUIRE(packed == scalarPacked);
+
+                std::vector<uint32_t> unpacked(BlockSize);
+                std::vector<uint32_t> scalarUnpacked(BlockSize);
+
+                BitPack<BlockSize>::unpack(packed.data(), width, unpacked.data(), reference);
+                detail::bitUnpack<Scalar>(packed.data(), width, scalarUnpacked.data(), reference, std::make_index_sequence<33>());
+
+                REQUIRE(unpacked == values);
+                REQUIRE(scalarUnpacked == values);
+            }
+        }
+
+        SCENARIO("blocks of integers can be bit-packed") {
+            GIVEN("a block with a single set bit") {
+                // value 5 is in lane 1 at position 1, so at width 1 it is bit 1 of the second packed word
+                std::vector<uint32_t> values(128, 0);
+                values[5] = 1;
+
+                WHEN("it is packed one bit per value") {
+                    uint8_t packed[BitPack<128>::packedBytes(1)] = { };
+                    BitPack<128>::pack(values.data(), 1, packed);
+
+                    THEN("the values are laid out vertically across the lanes") {
+                        REQUIRE(sizeof(packed) == 16);
+                        REQUIRE(BitPack<128>::bitWidth(values.data()) == 1);
+
+                        for(size_t i = 0; i < sizeof(packed); ++i) {
+                            REQUIRE(packed[i] == (i == 4 ? 0x02 : 0x00));
+                        }
+                    }
+                }
+            }
+
+            GIVEN("blocks of random values of every width") {
+                THEN("they unpack to the packed values, with the same bytes as the scalar kernels") {
+                    checkEveryWidth<128>();
+                    checkEveryWidth<256>();
+                }
+            }
+        }
+
+        SCENARIO("columns of integers can be encoded with patched frame of reference") {
+            GIVEN("a block of small values with a few large outliers") {
+                std::mt19937 random(42);
+
+                std::vector<uint32_t> values(256);
+                for(uint32_t& value : values) {
+                    value = 1000000 + static_cast<uint32_t>(random() % 16);
+                }
+
+                values[3] = 0xFFFFFFFF;
+                values[100] = 1u << 30;
+                values[255] = 5000000;
+
+                WHEN("it is encoded") {
+                    std::vector<uint8_t> encoded;
+                    const size_t blockBytes = BitPack<256>::encodeBlock(values.data(), encoded);
+
+                    THEN("the outliers are exceptions and the block decodes to the values") {
+                        REQUIRE(blockBytes == encoded.size());
+                        REQUIRE(encoded[4] == 4);
+                        REQUIRE(encoded[5] == 3);
+                        REQUIRE(blockBytes < BitPack<256>::packedBytes(8));
+
+                        std::vector<uint32_t> decoded(256);
+                        REQUIRE(BitPack<256>::decodeBlock(encoded.data(), encoded.size(), decoded.data()) == blockBytes);
+                        REQUIRE(decoded == values);
+
+                        REQUIRE(BitPack<256>::decodeBlock(encoded.data(), encoded.size() - 1, decoded.data()) == 0);
+                    }
+                }
+            }
+
+            GIVEN("columns of different lengths and distributions") {
+                THEN("they decode to the encoded values") {
+                    std::mt19937 random(7);
+
+                    for(const size_t count : { 0, 1, 127, 128, 129, 1000, 4096 }) {
+                        for(const uint32_t range : { 1u, 2u, 1000u, 0xFFFFFFFFu }) {
+                            std::vector<uint32_t> values(count);
+                            for(uint32_t& value : values) {
+                                value = 123 + static_cast<uint32_t>(random() % range);
+
+                                // one value in a hundred is an outlier
+                                if(random() % 100 == 0) {
+                                    value = static_cast<uint32_t>(random());
+                                }
+                            }
+
+                            const std::vector<uint8_t> encoded128 = BitPack<128>::encode(values.data(), count);
+                            const std::vector<uint8_t> encoded256 = BitPack<256>::encode(values.data(), count);
+
+                            std::vector<uint32_t> decoded(count + 1, 0xABCD);
+
+                            REQUIRE(BitPack<128>::decode(encoded128.data(), encoded128.size(), decoded.data(), count));
+                            REQUIRE(std::vector<uint32_t>(decoded.begin(), decoded.begin() + count) == values);
+                            REQUIRE(decoded[count] == 0xABCD);
+
+                            REQUIRE(BitPack<256>::decode(encoded256.data(), encoded256.size(), decoded.data(), count));
+                            REQUIRE(std::vector<uint32_t>(decoded.begin(), decoded.begin() + count) == values);
+                            REQUIRE(decoded[count] == 0xABCD);
+
+                            if(count > 0) {
+                                REQUIRE_FALSE(BitPack<128>::decode(encoded128.data(), encoded128.size() - 1, decoded.data(), count));
+                            }
+                        }
+                    }
+                }
+            }
+
+            GIVEN("malformed blocks") {
+                std::vector<uint8_t> tooWide = { 0, 0, 0, 0, 33, 0, 0 };
+                std::vector<uint8_t> badPosition = { 0, 0, 0, 0, 0, 1, 1, 200, 1 };
+                std::vector<uint8_t> valid = { 0, 0, 0, 0, 0, 1, 1, 100, 1 };
+
+                uint32_t decoded[128];
+
+                THEN("decoding them fails") {
+                    REQUIRE(BitPack<128>::decodeBlock(tooWide.data(), tooWide.size(), decoded) == 0);
+                    REQUIRE(BitPack<128>::decodeBlock(badPosition.data(), badPosition.size(), decoded) == 0);
+                    REQUIRE(BitPack<128>::decodeBlock(valid.data(), 3, decoded) == 0);
+
+                    REQUIRE(BitPack<128>::decodeBlock(valid.data(), valid.size(), decoded) == valid.size());
+                    REQUIRE(decoded[100] == 1);
+                    REQUIRE(decoded[99] == 0);
+                }
+            }
+        }
+    }
+}
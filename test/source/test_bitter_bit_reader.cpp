@@ -0,0 +1,208 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_bit_reader.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bits can be read from a buffer one field after another") {
+            GIVEN("multiple bytes") {
+                constexpr uint8_t bytes[] = { 0b01010101, 0b10101010, 0b11110000, 0b00001111 };
+                BitReader reader(bytes, sizeof(bytes));
+
+                WHEN("fields of different sizes are read") {
+                    THEN("the correct values should be returned") {
+                        REQUIRE(reader.read(4) == 0b0101);
+                        REQUIRE(reader.readBit() == Bit::One);
+                        REQUIRE(reader.read(3) == 0b010);
+                        REQUIRE(reader.position() == 8);
+                        REQUIRE(reader.read(12) == 0b000010101010);
+                        REQUIRE(reader.bitsRemaining() == 12);
+                    }
+                }
+
+                WHEN("bits are peeked") {
+                    THEN("the reader does not move") {
+                        REQUIRE(reader.peek(8) == 0b01010101);
+                        REQUIRE(reader.peek(8) == 0b01010101);
+                        REQUIRE(reader.position() == 0);
+                    }
+                }
+
+                WHEN("bits are skipped and the reader is aligned") {
+                    reader.skip(3);
+                    reader.alignToByte();
+
+                    THEN("the reader moves to the start of the next byte") {
+                        REQUIRE(reader.position() == 8);
+                        REQUIRE(reader.read(8) == 0b10101010);
+
+                        reader.alignToByte();
+                        REQUIRE(reader.position() == 16);
+                    }
+                }
+
+                WHEN("more bits are read than the buffer holds") {
+                    reader.skip(28);
+
+                    THEN("the missing bits are zero") {
+                        REQUIRE(reader.read(8) == 0b0000);
+                        REQUIRE(reader.bitsRemaining() == 0);
+                        REQUIRE(reader.position() == 36);
+                    }
+                }
+            }
+
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> bytes(101);
+
+                std::mt19937 random(777);
+                for(auto& byte : bytes) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                const size_t totalBits = bytes.size() * 8;
+
+                WHEN("it is read in fields of every size from 0 to 64") {
+                    THEN("each field matches getBits") {
+                        for(size_t start = 0; start < 64; start += 7) {
+                            BitReader reader(bytes.data(), bytes.size());
+                            reader.seek(start);
+
+                            size_t bitNumber = start;
+                            size_t bitCount = start % 65;
+
+                            while(bitNumber + bitCount <= totalBits) {
+                                REQUIRE(reader.position() == bitNumber);
+                                REQUIRE(reader.read(bitCount) == bitter::getBits(bytes.data(), bitNumber, bitCount));
+
+                                bitNumber += bitCount;
+                                bitCount = (bitCount + 13) % 65;
+                            }
+                        }
+                    }
+                }
+
+                WHEN("large distances are skipped") {
+                    BitReader reader(bytes.data(), bytes.size());
+                    reader.read(5);
+                    reader.skip(300);
+
+                    THEN("reading continues from the right place") {
+                        REQUIRE(reader.position() == 305);
+                        REQUIRE(reader.read(64) == bitter::getBits(bytes.data(), 305, 64));
+                    }
+                }
+            }
+        }
+
+        SCENARIO("bits can be read from a big-endian bitstream") {
+            GIVEN("multiple bytes") {
+                constexpr uint8_t bytes[] = { 0b01010101, 0b10101010, 0b11110000, 0b00001111 };
+                MsbBitReader reader(bytes, sizeof(bytes));
+
+                WHEN("fields of different sizes are read") {
+                    THEN("the first bit of each field is its most significant") {
+                        REQUIRE(reader.read(4) == 0b0101);
+                        REQUIRE(reader.readBit() == Bit::Zero);
+                        REQUIRE(reader.read(3) == 0b101);
+                        REQUIRE(reader.read(12) == 0b101010101111);
+                        REQUIRE(reader.peek(4) == 0b0000);
+                        REQUIRE(reader.read(16) == 0b0000000011110000);
+                        REQUIRE(reader.bitsRemaining() == 0);
+                    }
+                }
+            }
+
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> bytes(101);
+
+                std::mt19937 random(888);
+                for(auto& byte : bytes) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                const size_t totalBits = bytes.size() * 8;
+
+                WHEN("it is read in fields of every size from 0 to 64") {
+                    THEN("each field matches getBits") {
+                        for(size_t start = 0; start < 64; start += 7) {
+                            MsbBitReader reader(bytes.data(), bytes.size());
+                            reader.seek(start);
+
+                            size_t bitNumber = start;
+                            size_t bitCount = start % 65;
+
+                            while(bitNumber + bitCount <= totalBits) {
+                                REQUIRE(reader.position() == bitNumber);
+                                REQUIRE(reader.read(bitCount) == bitter::getBits<BitOrder::MsbFirst>(bytes.data(), bitNumber, bitCount));
+
+                                bitNumber += bitCount;
+                                bitCount = (bitCount + 13) % 65;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        SCENARIO("runs of zero bits can be counted") {
+            GIVEN("a buffer with sparse set bits") {
+                std::vector<uint8_t> bytes(40, 0);
+                const std::vector<size_t> setBits = { 0, 1, 5, 70, 71, 200, 319 };
+
+                for(const size_t bitNumber : setBits) {
+                    bitter::setBit(bytes.data(), bitNumber, Bit::One);
+                }
+
+                WHEN("unary codes are read in both bit orders") {
+                    THEN("each returns the distance to the next set bit") {
+                        std::vector<uint8_t> msbBytes(bytes.size(), 0);
+                        for(const size_t bitNumber : setBits) {
+                            bitter::setBit<BitOrder::MsbFirst>(msbBytes.data(), bitNumber, Bit::One);
+                        }
+
+                        BitReader reader(bytes.data(), bytes.size());
+                        MsbBitReader msbReader(msbBytes.data(), msbBytes.size());
+
+                        size_t previous = 0;
+                        for(const size_t bitNumber : setBits) {
+                            REQUIRE(reader.readUnary() == bitNumber - previous);
+                            REQUIRE(msbReader.readUnary() == bitNumber - previous);
+                            REQUIRE(reader.position() == bitNumber + 1);
+                            REQUIRE(msbReader.position() == bitNumber + 1);
+
+                            previous = bitNumber + 1;
+                        }
+
+                        REQUIRE(reader.bitsRemaining() == 0);
+                        REQUIRE(reader.readUnary() == 0);
+                        REQUIRE(reader.position() == 321);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,169 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_bit_vector.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bits can be kept in a BitVector") {
+            GIVEN("an empty BitVector") {
+                BitVector bits;
+
+                WHEN("bits are appended and changed") {
+                    bits.push_back(Bit::One);
+                    bits.push_back(Bit::Zero);
+                    bits.resize(100);
+                    bits[70] = Bit::One;
+                    bits[1] = bits[70];
+                    bits[2].flip();
+
+                    THEN("they can be read back") {
+                        REQUIRE(bits.size() == 100);
+                        REQUIRE_FALSE(bits.empty());
+                        REQUIRE(bits.capacity() >= 100);
+
+                        REQUIRE(bits[0] == Bit::One);
+                        REQUIRE(bits[1] == Bit::One);
+                        REQUIRE(bits[2] == Bit::One);
+                        REQUIRE(bits[3] == Bit::Zero);
+                        REQUIRE(bits[70] == Bit::One);
+                        REQUIRE(bits.data()[1] == uint64_t(1) << 6);
+
+                        REQUIRE(std::count(bits.begin(), bits.end(), Bit::One) == 4);
+                        REQUIRE(countOnes(bits.cbegin(), bits.cend()) == 4);
+                        REQUIRE(countOnes(bits.begin() + 1, bits.begin() + 70) == 2);
+                    }
+                }
+
+                WHEN("it is grown with set bits and shrunk again") {
+                    bits.resize(10);
+                    bits.resize(150, Bit::One);
+                    bits.resize(130);
+                    bits.pop_back();
+                    bits.pop_back();
+
+                    THEN("the bits after the end stay clear") {
+                        REQUIRE(bits.size() == 128);
+                        REQUIRE(countOnes(bits.begin(), bits.end()) == 118);
+                        REQUIRE(bits.data()[0] == ~uint64_t(0x3FF));
+                        REQUIRE(bits.data()[1] == ~uint64_t(0));
+
+                        bits.resize(200);
+                        REQUIRE(countOnes(bits.begin(), bits.end()) == 118);
+                        REQUIRE(bits == BitVector(bits));
+
+                        bits.clear();
+                        REQUIRE(bits.empty());
+                        REQUIRE(bits == BitVector());
+                    }
+                }
+            }
+
+            GIVEN("a BitVector with a few set bits") {
+                BitVector bits(1000);
+                const std::vector<size_t> setBits = { 3, 64, 65, 500, 999 };
+
+                for(const size_t bitNumber : setBits) {
+                    bits[bitNumber] = Bit::One;
+                }
+
+                WHEN("ranges of it are searched") {
+                    THEN("the results match searching one bit at a time") {
+                        for(size_t first = 0; first < 1000; first += 37) {
+                            for(size_t last = first; last <= 1000; last += 101) {
+                                const auto begin = bits.cbegin() + first;
+                                const auto end = bits.cbegin() + last;
+
+                                REQUIRE(findFirstSet(begin, end) == std::find(begin, end, Bit::One));
+                                REQUIRE(findFirstClear(begin, end) == std::find(begin, end, Bit::Zero));
+                                REQUIRE(countOnes(begin, end) == static_cast<size_t>(std::count(begin, end, Bit::One)));
+
+                                auto lastSet = end;
+                                auto lastClear = end;
+                                for(auto bit = begin; bit != end; ++bit) {
+                                    (*bit == Bit::One ? lastSet : lastClear) = bit;
+                                }
+
+                                REQUIRE(findLastSet(begin, end) == lastSet);
+                                REQUIRE(findLastClear(begin, end) == lastClear);
+                            }
+                        }
+
+                        BitVector::iterator found = findFirstSet(bits.begin() + 66, bits.end());
+                        *found = Bit::Zero;
+                        REQUIRE(findFirstSet(bits.begin() + 66, bits.end()) == bits.begin() + 999);
+                    }
+                }
+            }
+
+            GIVEN("two BitVectors") {
+                BitVector a;
+                BitVector b;
+
+                std::mt19937 random(21);
+                for(size_t i = 0; i < 777; ++i) {
+                    const uint32_t bits = static_cast<uint32_t>(random());
+                    a.push_back(bits & 1 ? Bit::One : Bit::Zero);
+                    b.push_back(bits & 2 ? Bit::One : Bit::Zero);
+                }
+
+                WHEN("they are combined") {
+                    BitVector andResult;
+                    BitVector orResult(5, Bit::One);
+                    BitVector xorResult(2000, Bit::One);
+                    BitVector andNotResult;
+
+                    bitwiseAnd(andResult, a, b);
+                    bitwiseOr(orResult, a, b);
+                    bitwiseXor(xorResult, a, b);
+                    bitwiseAndNot(andNotResult, a, b);
+
+                    BitVector inPlace = a;
+                    bitwiseXor(inPlace, b);
+                    bitwiseXor(inPlace, b);
+
+                    THEN("every bit is combined and the results are as long as the operands") {
+                        REQUIRE(andResult.size() == 777);
+                        REQUIRE(orResult.size() == 777);
+                        REQUIRE(xorResult.size() == 777);
+                        REQUIRE(andNotResult.size() == 777);
+
+                        for(size_t i = 0; i < 777; ++i) {
+                            const bool x = a[i] == Bit::One;
+                            const bool y = b[i] == Bit::One;
+
+                            REQUIRE((andResult[i] == Bit::One) == (x && y));
+                            REQUIRE((orResult[i] == Bit::One) == (x || y));
+                            REQUIRE((xorResult[i] == Bit::One) == (x != y));
+                            REQUIRE((andNotResult[i] == Bit::One) == (x && ! y));
+                        }
+
+                        REQUIRE(inPlace == a);
+                        REQUIRE(xorResult.data()[777 / 64] >> (777 % 64) == 0);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_bit_reader.hpp>
+#include <bitter_bit_writer.hpp>
+#include <bitter_read.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bits can be written to a buffer one field after another") {
+            GIVEN("a BitWriter with its own buffer") {
+                BitWriter writer;
+
+                WHEN("fields of different sizes are written and finished") {
+                    writer.write(0b0101, 4);
+                    writer.writeBit(Bit::One);
+                    writer.write(0b010, 3);
+                    writer.write(0b000010101010, 12);
+
+                    REQUIRE(writer.position() == 20);
+                    REQUIRE(writer.finish() == 3);
+
+                    THEN("the buffer holds the bits in order") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b01010101, 0b10101010, 0b00000000 }));
+                    }
+                }
+
+                WHEN("the writer is padded to the next byte") {
+                    writer.write(0b111, 3);
+                    writer.padToByte();
+                    writer.padToByte();
+                    writer.write(0xAB, 8);
+                    writer.finish();
+
+                    THEN("the padding is made of zero bits") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b00000111, 0xAB }));
+                    }
+                }
+
+                WHEN("many fields of every size from 0 to 64 are written") {
+                    std::vector<uint64_t> values;
+                    std::vector<size_t> bitCounts;
+
+                    std::mt19937_64 random(99);
+                    size_t bitCount = 0;
+
+                    for(size_t i = 0; i < 500; ++i) {
+                        const uint64_t value = random();
+                        values.push_back(value);
+                        bitCounts.push_back(bitCount);
+
+                        writer.write(value, bitCount);
+                        bitCount = (bitCount + 11) % 65;
+                    }
+
+                    const size_t totalBits = writer.position();
+                    writer.finish();
+
+                    THEN("reading them back returns the same values") {
+                        REQUIRE(writer.buffer().size() == (totalBits + 7) / 8);
+
+                        BitReader reader(writer.buffer().data(), writer.buffer().size());
+
+                        for(size_t i = 0; i < values.size(); ++i) {
+                            REQUIRE(reader.read(bitCounts[i]) == (values[i] & detail::lowBitMask(bitCounts[i])));
+                        }
+                    }
+                }
+            }
+
+            GIVEN("a BitWriter with a caller-provided buffer") {
+                uint8_t bytes[10] = { };
+                BitWriter writer(bytes, sizeof(bytes));
+
+                WHEN("fewer bits are written than the buffer holds") {
+                    writer.write(0xFFFFFFFFFFFFFFFF, 64);
+                    writer.write(0x3, 2);
+
+                    THEN("the bytes are written on finish") {
+                        REQUIRE(writer.finish() == 9);
+                        REQUIRE(! writer.hasOverflowed());
+                        REQUIRE(bytes[7] == 0xFF);
+                        REQUIRE(bytes[8] == 0x03);
+                        REQUIRE(bytes[9] == 0x00);
+                    }
+                }
+
+                WHEN("more bits are written than the buffer holds") {
+                    writer.write(0xFFFFFFFFFFFFFFFF, 64);
+                    writer.write(0xFFFFFFFFFFFFFFFF, 64);
+
+                    THEN("the extra bits are dropped") {
+                        REQUIRE(writer.finish() == 10);
+                        REQUIRE(writer.hasOverflowed());
+                        REQUIRE(bitter::getBits(bytes, 16, 64) == 0xFFFFFFFFFFFFFFFF);
+                    }
+                }
+            }
+        }
+
+        SCENARIO("bits can be written to a big-endian bitstream") {
+            GIVEN("an MsbBitWriter with its own buffer") {
+                MsbBitWriter writer;
+
+                WHEN("fields of different sizes are written and finished") {
+                    writer.write(0b0101, 4);
+                    writer.writeBit(Bit::Zero);
+                    writer.write(0b101, 3);
+                    writer.write(0b101010101111, 12);
+                    writer.finish();
+
+                    THEN("the most significant bit of each field comes first") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b01010101, 0b10101010, 0b11110000 }));
+                    }
+                }
+
+                WHEN("many fields of every size from 0 to 64 are written") {
+                    std::vector<uint64_t> values;
+                    std::vector<size_t> bitCounts;
+
+                    std::mt19937_64 random(98);
+                    size_t bitCount = 0;
+
+                    for(size_t i = 0; i < 500; ++i) {
+                        const uint64_t value = random();
+                        values.push_back(value);
+                        bitCounts.push_back(bitCount);
+
+                        writer.write(value, bitCount);
+                        bitCount = (bitCount + 11) % 65;
+                    }
+
+                    writer.finish();
+
+                    THEN("reading them back returns the same values") {
+                        MsbBitReader reader(writer.buffer().data(), writer.buffer().size());
+
+                        for(size_t i = 0; i < values.size(); ++i) {
+                            REQUIRE(reader.read(bitCounts[i]) == (values[i] & detail::lowBitMask(bitCounts[i])));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
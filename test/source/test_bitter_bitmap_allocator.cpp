@@ -0,0 +1,149 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <bitter_bitmap_allocator.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("slots can be allocated from a bitmap without locking") {
+            GIVEN("an allocator whose capacity is not a multiple of 64") {
+                BitmapAllocator allocator(1000);
+
+                WHEN("every slot is allocated") {
+                    std::vector<size_t> slots;
+                    for(size_t i = 0; i < 1000; ++i) {
+                        slots.push_back(allocator.allocate());
+                    }
+
+                    THEN("each slot is handed out once, then the allocator reports it is full") {
+                        std::sort(slots.begin(), slots.end());
+
+                        for(size_t i = 0; i < 1000; ++i) {
+                            REQUIRE(slots[i] == i);
+                            REQUIRE(allocator.isAllocated(i));
+                        }
+
+                        REQUIRE(allocator.allocate() == allocator.capacity());
+                    }
+
+                    AND_WHEN("some slots are deallocated") {
+                        allocator.deallocate(5);
+                        allocator.deallocate(999);
+
+                        THEN("exactly those slots can be allocated again") {
+                            REQUIRE_FALSE(allocator.isAllocated(5));
+
+                            std::vector<size_t> again = { allocator.allocate(), allocator.allocate() };
+                            std::sort(again.begin(), again.end());
+
+                            REQUIRE(again == std::vector<size_t>({ 5, 999 }));
+                            REQUIRE(allocator.allocate() == 1000);
+                        }
+                    }
+                }
+            }
+
+            GIVEN("two allocators of different sizes used in turn by one thread") {
+                BitmapAllocator large(64 * 300);
+                BitmapAllocator small(70);
+
+                WHEN("allocations alternate between them until both are full") {
+                    std::vector<size_t> largeSlots;
+                    std::vector<size_t> smallSlots;
+
+                    for(size_t i = 0; i < large.capacity(); ++i) {
+                        largeSlots.push_back(large.allocate());
+
+                        if(i < small.capacity()) {
+                            smallSlots.push_back(small.allocate());
+                        }
+                    }
+
+                    THEN("each allocator hands out each of its own slots once") {
+                        std::sort(largeSlots.begin(), largeSlots.end());
+                        std::sort(smallSlots.begin(), smallSlots.end());
+
+                        for(size_t i = 0; i < largeSlots.size(); ++i) {
+                            REQUIRE(largeSlots[i] == i);
+                        }
+
+                        for(size_t i = 0; i < smallSlots.size(); ++i) {
+                            REQUIRE(smallSlots[i] == i);
+                        }
+
+                        REQUIRE(large.allocate() == large.capacity());
+                        REQUIRE(small.allocate() == small.capacity());
+                    }
+                }
+            }
+
+            GIVEN("an allocator shared between many threads") {
+                const size_t threadCount = 32;
+                const size_t slotsPerThread = 2000;
+                BitmapAllocator allocator(threadCount * slotsPerThread);
+
+                WHEN("the threads allocate and free concurrently until the pool is exhausted") {
+                    std::vector<std::vector<size_t>> claimed(threadCount);
+                    std::vector<std::thread> threads;
+
+                    for(size_t t = 0; t < threadCount; ++t) {
+                        threads.emplace_back([&allocator, &claimed, t]() {
+                            // churn a little so deallocations race with allocations
+                            for(size_t i = 0; i < 500; ++i) {
+                                const size_t slot = allocator.allocate();
+
+                                // other threads may already have exhausted the pool
+                                if(slot != allocator.capacity()) {
+                                    allocator.deallocate(slot);
+                                }
+                            }
+
+                            for(size_t slot = allocator.allocate(); slot != allocator.capacity(); slot = allocator.allocate()) {
+                                claimed[t].push_back(slot);
+                            }
+                        });
+                    }
+
+                    for(auto& thread : threads) {
+                        thread.join();
+                    }
+
+                    THEN("every slot was handed out exactly once") {
+                        std::vector<size_t> all;
+                        for(const auto& slots : claimed) {
+                            all.insert(all.end(), slots.begin(), slots.end());
+                        }
+
+                        std::sort(all.begin(), all.end());
+
+                        REQUIRE(all.size() == allocator.capacity());
+                        for(size_t i = 0; i < all.size(); ++i) {
+                            REQUIRE(all[i] == i);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
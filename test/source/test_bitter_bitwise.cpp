@@ -0,0 +1,127 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_bitwise.hpp>
+#include <bitter_count.hpp>
+
+namespace bitter {
+    namespace test {
+        namespace {
+            // the expected result of an operation, computed one byte at a time
+            template <typename Operation>
+            std::vector<uint8_t> expectedResult(const std::vector<uint8_t>& target, const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, const size_t bitCount, const Operation operation) {
+                auto result = target;
+
+                for(size_t i = 0; i < (bitCount + 7) / 8; ++i) {
+                    const uint8_t mask = (i < bitCount / 8) ? 0xFF : static_cast<uint8_t>((1 << (bitCount % 8)) - 1);
+                    result[i] = static_cast<uint8_t>((result[i] & ~mask) | (operation(a[i], b[i]) & mask));
+                }
+
+                return result;
+            }
+        }
+
+        SCENARIO("bitwise operations can be applied to buffers") {
+            GIVEN("a small example") {
+                constexpr uint8_t a[] = { 0x0F, 0xFF };
+                constexpr uint8_t b[] = { 0x3C, 0x00 };
+                uint8_t target[2] = { 0xAA, 0xAA };
+
+                WHEN("they are ANDed") {
+                    const size_t count = bitwiseAndCount(target, a, b, 12);
+
+                    THEN("the target holds the result, leaving bits past the end alone") {
+                        REQUIRE(target[0] == 0x0C);
+                        REQUIRE(target[1] == 0xA0);
+                        REQUIRE(count == 2);
+                    }
+                }
+            }
+
+            GIVEN("large buffers") {
+                const size_t byteCount = 1100;
+                std::vector<uint8_t> a(byteCount);
+                std::vector<uint8_t> b(byteCount);
+                std::vector<uint8_t> original(byteCount);
+
+                std::mt19937 random(1);
+                for(size_t i = 0; i < byteCount; ++i) {
+                    a[i] = static_cast<uint8_t>(random());
+                    b[i] = static_cast<uint8_t>(random());
+                    original[i] = static_cast<uint8_t>(random());
+                }
+
+                WHEN("each operation is applied over different lengths") {
+                    THEN("the results match applying them a byte at a time") {
+                        for(const size_t bitCount : { 0, 5, 8, 64, 255, 256, 1000, 4096, 8195, 8800 }) {
+                            const auto check = [&](const auto operation, const auto apply, const auto applyCount, const auto applyInPlace) {
+                                const auto expected = expectedResult(original, a, b, bitCount, operation);
+
+                                auto target = original;
+                                apply(target.data(), a.data(), b.data(), bitCount);
+                                REQUIRE(target == expected);
+
+                                target = original;
+                                const size_t count = applyCount(target.data(), a.data(), b.data(), bitCount);
+                                REQUIRE(target == expected);
+                                REQUIRE(count == countOnes(expected.data(), 0, bitCount));
+
+                                target = a;
+                                applyInPlace(target.data(), b.data(), bitCount);
+                                REQUIRE(target == expectedResult(a, a, b, bitCount, operation));
+                            };
+
+                            check(
+                                [](uint8_t x, uint8_t y) { return x & y; },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { bitwiseAnd(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { return bitwiseAndCount(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, size_t n) { bitwiseAnd(t, x, n); }
+                            );
+
+                            check(
+                                [](uint8_t x, uint8_t y) { return x | y; },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { bitwiseOr(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { return bitwiseOrCount(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, size_t n) { bitwiseOr(t, x, n); }
+                            );
+
+                            check(
+                                [](uint8_t x, uint8_t y) { return x ^ y; },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { bitwiseXor(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { return bitwiseXorCount(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, size_t n) { bitwiseXor(t, x, n); }
+                            );
+
+                            check(
+                                [](uint8_t x, uint8_t y) { return x & ~y; },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { bitwiseAndNot(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, const uint8_t* y, size_t n) { return bitwiseAndNotCount(t, x, y, n); },
+                                [](uint8_t* t, const uint8_t* x, size_t n) { bitwiseAndNot(t, x, n); }
+                            );
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
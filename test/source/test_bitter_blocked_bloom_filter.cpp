@@ -0,0 +1,128 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <bitter_blocked_bloom_filter.hpp>
+#include <bitter_word.hpp>
+
+namespace bitter {
+    namespace test {
+        //!
+        //! \brief  A well mixed 64-bit hash of a number (the SplitMix64 finaliser)
+        //!
+        inline uint64_t mixHash(uint64_t value) {
+            value += 0x9E3779B97F4A7C15;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+            return value ^ (value >> 31);
+        }
+
+        SCENARIO("keys can be added to a blocked Bloom filter") {
+            GIVEN("a filter with a single block") {
+                BlockedBloomFilter filter(1);
+
+                WHEN("a key is added") {
+                    filter.insert(mixHash(1));
+
+                    THEN("one bit is set in each word of the block") {
+                        REQUIRE(filter.size() == 512);
+                        REQUIRE(reinterpret_cast<uintptr_t>(filter.data()) % 64 == 0);
+
+                        for(size_t word = 0; word < 8; ++word) {
+                            REQUIRE(detail::popCount(filter.data()[word]) == 1);
+                        }
+
+                        REQUIRE(filter.contains(mixHash(1)));
+                    }
+                }
+            }
+
+            GIVEN("false positive rates that can not be reached") {
+                const size_t maxBits = static_cast<size_t>(std::min<uint64_t>(uint64_t(1) << 32, std::numeric_limits<size_t>::max() / 512)) * 512;
+
+                THEN("rates of 1 or above give one block and the others the largest filter") {
+                    REQUIRE(BlockedBloomFilter::bitCountFor(1000000, 1) == 512);
+                    REQUIRE(BlockedBloomFilter::bitCountFor(1000000, 2) == 512);
+                    REQUIRE(BlockedBloomFilter::bitCountFor(1000000, 0) == maxBits);
+                    REQUIRE(BlockedBloomFilter::bitCountFor(1000000, -0.5) == maxBits);
+                    REQUIRE(BlockedBloomFilter::bitCountFor(1000000, std::numeric_limits<double>::quiet_NaN()) == maxBits);
+                    REQUIRE(BlockedBloomFilter::bitCountFor(1000000, 1e-300) == maxBits);
+                    REQUIRE(BlockedBloomFilter::bitCountFor(0, 0.01) == 512);
+                }
+            }
+
+            GIVEN("a filter sized for a false positive rate of 1%") {
+                const size_t keyCount = 20000;
+                const size_t bitCount = BlockedBloomFilter::bitCountFor(keyCount, 0.01);
+                BlockedBloomFilter filter(bitCount);
+
+                std::vector<uint64_t> keys(keyCount);
+                for(size_t i = 0; i < keyCount; ++i) {
+                    keys[i] = mixHash(i);
+                }
+
+                WHEN("the keys are added in a batch") {
+                    filter.insert(keys.data(), keys.size());
+
+                    THEN("every key is found and other keys rarely are") {
+                        REQUIRE(BlockedBloomFilter::expectedFalsePositiveRate(bitCount, keyCount) <= 0.01);
+                        REQUIRE(BlockedBloomFilter::expectedFalsePositiveRate(bitCount - 512, keyCount) > 0.01);
+
+                        // somewhat more than a classic Bloom filter, which needs 9.6 bits per key
+                        REQUIRE(bitCount > keyCount * 9);
+                        REQUIRE(bitCount < keyCount * 14);
+
+                        std::unique_ptr<bool[]> results(new bool[keyCount]);
+                        REQUIRE(filter.contains(keys.data(), results.get(), keyCount) == keyCount);
+
+                        std::vector<uint64_t> otherKeys(100000);
+                        for(size_t i = 0; i < otherKeys.size(); ++i) {
+                            otherKeys[i] = mixHash(keyCount + i);
+                        }
+
+                        std::unique_ptr<bool[]> otherResults(new bool[otherKeys.size()]);
+                        const size_t falsePositives = filter.contains(otherKeys.data(), otherResults.get(), otherKeys.size());
+
+                        REQUIRE(falsePositives < otherKeys.size() / 50);
+
+                        for(size_t i = 0; i < otherKeys.size(); ++i) {
+                            REQUIRE(otherResults[i] == filter.contains(otherKeys[i]));
+                        }
+                    }
+                }
+
+                WHEN("the filter is cleared") {
+                    filter.insert(keys.data(), keys.size());
+                    filter.clear();
+
+                    THEN("no key is found") {
+                        for(const uint64_t key : keys) {
+                            REQUIRE_FALSE(filter.contains(key));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
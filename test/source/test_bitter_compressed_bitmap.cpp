@@ -0,0 +1,197 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <bitter_compressed_bitmap.hpp>
+
+namespace bitter {
+    namespace test {
+        namespace {
+            // a mix of sparse chunks, dense chunks and long runs
+            std::set<uint32_t> randomValues(const uint32_t seed) {
+                std::mt19937 random(seed);
+                std::set<uint32_t> values;
+
+                for(int i = 0; i < 3000; ++i) {
+                    values.insert(static_cast<uint32_t>(random() % 2000000));
+                }
+
+                for(int i = 0; i < 20000; ++i) {
+                    values.insert((3 << 16) | static_cast<uint32_t>(random() % 40000));
+                }
+
+                const uint32_t runStart = (5 << 16) + static_cast<uint32_t>(random() % 1000);
+                for(uint32_t value = runStart; value < runStart + 70000; ++value) {
+                    values.insert(value);
+                }
+
+                values.insert(0xFFFFFFFF);
+
+                return values;
+            }
+
+            CompressedBitmap toBitmap(const std::set<uint32_t>& values) {
+                CompressedBitmap bitmap;
+
+                for(const uint32_t value : values) {
+                    bitmap.add(value);
+                }
+
+                return bitmap;
+            }
+
+            std::vector<uint32_t> toVector(const CompressedBitmap& bitmap) {
+                return std::vector<uint32_t>(bitmap.begin(), bitmap.end());
+            }
+        }
+
+        SCENARIO("sets of 32-bit values can be stored compactly") {
+            GIVEN("an empty bitmap") {
+                CompressedBitmap bitmap;
+
+                WHEN("values are added and removed") {
+                    bitmap.add(7);
+                    bitmap.add(1000000);
+                    bitmap.add(7);
+                    bitmap.add(0xFFFFFFFF);
+                    bitmap.remove(1000000);
+                    bitmap.remove(12345);
+
+                    THEN("membership, cardinality and iteration reflect the changes") {
+                        REQUIRE(bitmap.contains(7));
+                        REQUIRE(bitmap.contains(0xFFFFFFFF));
+                        REQUIRE_FALSE(bitmap.contains(1000000));
+                        REQUIRE_FALSE(bitmap.contains(8));
+
+                        REQUIRE(bitmap.cardinality() == 2);
+                        REQUIRE_FALSE(bitmap.isEmpty());
+                        REQUIRE(toVector(bitmap) == std::vector<uint32_t>({ 7, 0xFFFFFFFF }));
+                    }
+                }
+            }
+
+            GIVEN("bitmaps holding sparse, dense and run-heavy chunks") {
+                const auto aValues = randomValues(1);
+                const auto bValues = randomValues(2);
+
+                CompressedBitmap a = toBitmap(aValues);
+                CompressedBitmap b = toBitmap(bValues);
+
+                WHEN("they are combined, with and without run containers") {
+                    THEN("the results match std::set_union and friends") {
+                        std::vector<uint32_t> expectedUnion;
+                        std::vector<uint32_t> expectedIntersection;
+                        std::vector<uint32_t> expectedDifference;
+
+                        std::set_union(aValues.begin(), aValues.end(), bValues.begin(), bValues.end(), std::back_inserter(expectedUnion));
+                        std::set_intersection(aValues.begin(), aValues.end(), bValues.begin(), bValues.end(), std::back_inserter(expectedIntersection));
+                        std::set_difference(aValues.begin(), aValues.end(), bValues.begin(), bValues.end(), std::back_inserter(expectedDifference));
+
+                        for(int pass = 0; pass < 2; ++pass) {
+                            REQUIRE(a.cardinality() == aValues.size());
+                            REQUIRE(toVector(a) == std::vector<uint32_t>(aValues.begin(), aValues.end()));
+
+                            REQUIRE(toVector(a | b) == expectedUnion);
+                            REQUIRE(toVector(a & b) == expectedIntersection);
+                            REQUIRE(toVector(a - b) == expectedDifference);
+
+                            REQUIRE((a | b).cardinality() == expectedUnion.size());
+                            REQUIRE((a & b).cardinality() == expectedIntersection.size());
+                            REQUIRE((a - b).cardinality() == expectedDifference.size());
+
+                            // with the operands swapped, a is the one read rather than written into
+                            REQUIRE(toVector(b | a) == expectedUnion);
+                            REQUIRE(toVector(b & a) == expectedIntersection);
+                            REQUIRE(toVector(b - (b - a)) == expectedIntersection);
+
+                            // the second pass runs the same checks with run containers in play
+                            a.runOptimize();
+                        }
+
+                        CompressedBitmap c = a;
+                        c -= a;
+                        REQUIRE(c.isEmpty());
+
+                        c |= b;
+                        REQUIRE(c == b);
+                        c &= a;
+                        REQUIRE(toVector(c) == expectedIntersection);
+
+                        // compound assignment with itself
+                        c |= c;
+                        REQUIRE(toVector(c) == expectedIntersection);
+                        c &= c;
+                        REQUIRE(toVector(c) == expectedIntersection);
+                        c -= c;
+                        REQUIRE(c.isEmpty());
+                    }
+                }
+
+                WHEN("a run container is modified") {
+                    a.runOptimize();
+                    const uint32_t inRun = (5 << 16) + 5000;
+                    const uint32_t outsideAnyChunk = (40 << 16) + 1;
+
+                    a.remove(inRun);
+                    a.add(outsideAnyChunk);
+
+                    THEN("only the changed values differ") {
+                        REQUIRE_FALSE(a.contains(inRun));
+                        REQUIRE(a.contains(inRun + 1));
+                        REQUIRE(a.contains(outsideAnyChunk));
+                        REQUIRE(a.cardinality() == aValues.size());
+                    }
+                }
+
+                WHEN("they are serialised and deserialised") {
+                    a.runOptimize();
+                    const auto bytes = a.serialise();
+
+                    CompressedBitmap copy;
+                    const bool success = copy.deserialise(bytes.data(), bytes.size());
+
+                    THEN("the copy holds the same values") {
+                        REQUIRE(success);
+                        REQUIRE(copy == a);
+                        REQUIRE(copy.serialise() == bytes);
+                    }
+
+                    THEN("truncated or corrupted input is rejected") {
+                        REQUIRE_FALSE(copy.deserialise(bytes.data(), bytes.size() - 1));
+                        REQUIRE(copy.isEmpty());
+
+                        auto corrupted = bytes;
+                        corrupted[0] ^= 1;
+                        REQUIRE_FALSE(copy.deserialise(corrupted.data(), corrupted.size()));
+
+                        corrupted = bytes;
+                        corrupted[8 + 2] = 7; // the first container's type
+                        REQUIRE_FALSE(copy.deserialise(corrupted.data(), corrupted.size()));
+                    }
+                }
+            }
+        }
+    }
+}
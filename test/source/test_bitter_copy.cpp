@@ -0,0 +1,117 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_copy.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        namespace {
+            // copies through a temporary, so overlapping ranges behave like memmove
+            void copyBitsOneAtATime(uint8_t* target, size_t targetBitOffset, const uint8_t* source, size_t sourceBitOffset, size_t bitCount) {
+                std::vector<Bit> bits;
+
+                for(size_t i = 0; i < bitCount; ++i) {
+                    bits.push_back(getBit(source, sourceBitOffset + i));
+                }
+
+                for(size_t i = 0; i < bitCount; ++i) {
+                    setBit(target, targetBitOffset + i, bits[i]);
+                }
+            }
+        }
+
+        SCENARIO("ranges of bits can be copied") {
+            GIVEN("a small example") {
+                constexpr uint8_t source[] = { 0xF0 };
+                uint8_t target[] = { 0x00, 0x00 };
+
+                WHEN("bits are copied across a byte boundary") {
+                    copyBits(target, 6, source, 4, 4);
+
+                    THEN("only the target range changes") {
+                        REQUIRE(target[0] == 0xC0);
+                        REQUIRE(target[1] == 0x03);
+                    }
+                }
+            }
+
+            GIVEN("separate buffers") {
+                std::vector<uint8_t> source(64);
+                std::vector<uint8_t> original(64);
+
+                std::mt19937 random(1);
+                for(size_t i = 0; i < 64; ++i) {
+                    source[i] = static_cast<uint8_t>(random());
+                    original[i] = static_cast<uint8_t>(random());
+                }
+
+                WHEN("ranges are copied between every pair of offsets") {
+                    THEN("the result matches copying one bit at a time") {
+                        for(size_t targetBitOffset = 0; targetBitOffset < 16; ++targetBitOffset) {
+                            for(size_t sourceBitOffset = 0; sourceBitOffset < 16; ++sourceBitOffset) {
+                                for(const size_t bitCount : { 0, 1, 7, 8, 9, 63, 64, 65, 200, 480 }) {
+                                    auto actual = original;
+                                    auto expected = original;
+
+                                    copyBits(actual.data(), targetBitOffset, source.data(), sourceBitOffset, bitCount);
+                                    copyBitsOneAtATime(expected.data(), targetBitOffset, source.data(), sourceBitOffset, bitCount);
+
+                                    REQUIRE(actual == expected);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            GIVEN("a single buffer") {
+                std::vector<uint8_t> original(96);
+
+                std::mt19937 random(3);
+                for(auto& byte : original) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                WHEN("overlapping ranges are copied in either direction") {
+                    THEN("the result matches copying through a temporary") {
+                        for(size_t targetBitOffset = 0; targetBitOffset < 140; targetBitOffset += 3) {
+                            for(size_t sourceBitOffset = 0; sourceBitOffset < 140; sourceBitOffset += 5) {
+                                for(const size_t bitCount : { 1, 13, 64, 130, 500 }) {
+                                    auto actual = original;
+                                    auto expected = original;
+
+                                    copyBits(actual.data(), targetBitOffset, actual.data(), sourceBitOffset, bitCount);
+                                    copyBitsOneAtATime(expected.data(), targetBitOffset, expected.data(), sourceBitOffset, bitCount);
+
+                                    REQUIRE(actual == expected);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_count.hpp>
+#include <bitter_read.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("set bits can be counted") {
+            GIVEN("multiple bytes") {
+                constexpr uint8_t bytes[] = { 0b01010101, 0b10101010, 0b11110000, 0b00001111 };
+
+                WHEN("ranges are counted") {
+                    THEN("the correct counts should be returned") {
+                        REQUIRE(bitter::countOnes(bytes, 0, 32) == 16);
+                        REQUIRE(bitter::countOnes(bytes, 0, 0) == 0);
+                        REQUIRE(bitter::countOnes(bytes, 3, 2) == 1);
+                        REQUIRE(bitter::countOnes(bytes, 20, 8) == 8);
+                        REQUIRE(bitter::countOnes(bytes, 17, 14) == 8);
+                    }
+                }
+            }
+
+            GIVEN("a large buffer with a complex bit pattern") {
+                std::vector<uint8_t> bytes(4133);
+
+                std::mt19937 random(4242);
+                for(auto& byte : bytes) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                const size_t totalBits = bytes.size() * 8;
+
+                std::vector<size_t> onesBefore(totalBits + 1, 0);
+                for(size_t i = 0; i < totalBits; ++i) {
+                    onesBefore[i + 1] = onesBefore[i] + (bitter::getBit(bytes.data(), i) == Bit::One ? 1 : 0);
+                }
+
+                WHEN("ranges with all kinds of offsets and lengths are counted") {
+                    THEN("each count matches counting the bits one at a time") {
+                        for(size_t bitOffset = 0; bitOffset < 70; ++bitOffset) {
+                            for(size_t end = totalBits; end > bitOffset && end + 70 > totalBits; --end) {
+                                REQUIRE(bitter::countOnes(bytes.data(), bitOffset, end - bitOffset) == onesBefore[end] - onesBefore[bitOffset]);
+                            }
+
+                            for(size_t bitCount = 0; bitCount < 200; ++bitCount) {
+                                REQUIRE(bitter::countOnes(bytes.data(), bitOffset, bitCount) == onesBefore[bitOffset + bitCount] - onesBefore[bitOffset]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,167 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_extract_deposit.hpp>
+
+namespace bitter {
+    namespace test {
+        //!
+        //! \brief  Extracts bits one at a time
+        //!
+        inline uint64_t referenceExtractBits(const uint64_t value, const uint64_t mask) {
+            uint64_t result = 0;
+            size_t resultBit = 0;
+
+            for(size_t bitNumber = 0; bitNumber < 64; ++bitNumber) {
+                if((mask >> bitNumber) & 1) {
+                    result |= ((value >> bitNumber) & 1) << resultBit++;
+                }
+            }
+
+            return result;
+        }
+
+        //!
+        //! \brief  Deposits bits one at a time
+        //!
+        inline uint64_t referenceDepositBits(const uint64_t value, const uint64_t mask) {
+            uint64_t result = 0;
+            size_t valueBit = 0;
+
+            for(size_t bitNumber = 0; bitNumber < 64; ++bitNumber) {
+                if((mask >> bitNumber) & 1) {
+                    result |= ((value >> valueBit++) & 1) << bitNumber;
+                }
+            }
+
+            return result;
+        }
+
+        //!
+        //! \brief  Masks with few and many runs, sparse and dense, and the edge cases
+        //!
+        inline std::vector<uint64_t> testMasks() {
+            std::vector<uint64_t> masks = {
+                0, ~uint64_t(0), 1, uint64_t(1) << 63, 0x5555555555555555, 0xAAAAAAAAAAAAAAAA,
+                0x00000000FFFFFFFF, 0xFFFFFFFF00000000, 0x0F0F0F0F0F0F0F0F, 0x8000000000000001
+            };
+
+            std::mt19937_64 random(0x9E3779B97F4A7C15);
+
+            for(size_t i = 0; i < 300; ++i) {
+                const uint64_t state = random();
+
+                // ANDing and ORing with a shifted copy gives sparser and denser masks
+                masks.push_back(state);
+                masks.push_back(state & (state >> 5) & (state >> 11));
+                masks.push_back(state | (state << 3) | (state << 9));
+            }
+
+            return masks;
+        }
+
+        SCENARIO("bits can be extracted and deposited under a mask") {
+            GIVEN("the documented examples") {
+                THEN("the documented results are returned") {
+                    REQUIRE(extractBits(uint64_t(0b10110010), uint64_t(0b11110000)) == 0b1011);
+                    REQUIRE(depositBits(uint64_t(0b1011), uint64_t(0b11110000)) == 0b10110000);
+                    REQUIRE(extractBits(uint32_t(0b10110010), uint32_t(0b11110000)) == 0b1011);
+                    REQUIRE(depositBits(uint32_t(0b1011), uint32_t(0b11110000)) == 0b10110000);
+                }
+            }
+
+            GIVEN("many values and masks") {
+                const std::vector<uint64_t> masks = testMasks();
+
+                WHEN("bits are extracted and deposited one word at a time") {
+                    THEN("the results are those of extracting and depositing one bit at a time") {
+                        for(size_t i = 0; i < masks.size(); ++i) {
+                            const uint64_t mask = masks[i];
+                            const uint64_t value = masks[(i * 7 + 3) % masks.size()] ^ 0x0123456789ABCDEF;
+                            const detail::BitMaskPlan plan(mask);
+
+                            REQUIRE(extractBits(value, mask) == referenceExtractBits(value, mask));
+                            REQUIRE(depositBits(value, mask) == referenceDepositBits(value, mask));
+
+                            // both fallbacks are checked whichever one this CPU picks
+                            REQUIRE(detail::extractBitsPortable(value, mask) == referenceExtractBits(value, mask));
+                            REQUIRE(detail::depositBitsPortable(value, mask) == referenceDepositBits(value, mask));
+                            REQUIRE(plan.extract(value) == referenceExtractBits(value, mask));
+                            REQUIRE(plan.deposit(value) == referenceDepositBits(value, mask));
+
+                            const uint32_t value32 = static_cast<uint32_t>(value >> 16);
+                            const uint32_t mask32 = static_cast<uint32_t>(mask);
+
+                            REQUIRE(extractBits(value32, mask32) == referenceExtractBits(value32, mask32));
+                            REQUIRE(depositBits(value32, mask32) == referenceDepositBits(value32, mask32));
+                        }
+                    }
+                }
+
+                WHEN("bits are extracted and deposited a whole array at a time") {
+                    std::vector<uint64_t> values(101);
+                    for(size_t i = 0; i < values.size(); ++i) {
+                        values[i] = masks[(i * 13) % masks.size()] * 0x9E3779B97F4A7C15;
+                    }
+
+                    std::vector<uint32_t> values32(values.size());
+                    for(size_t i = 0; i < values.size(); ++i) {
+                        values32[i] = static_cast<uint32_t>(values[i] >> 32);
+                    }
+
+                    THEN("each result is that of extracting or depositing its value alone") {
+                        for(size_t m = 0; m < masks.size(); m += 5) {
+                            const uint64_t mask = masks[m];
+                            const uint32_t mask32 = static_cast<uint32_t>(mask >> 8);
+
+                            std::vector<uint64_t> extracted(values.size());
+                            std::vector<uint64_t> deposited(values.size());
+                            std::vector<uint32_t> extracted32(values.size());
+                            std::vector<uint32_t> deposited32(values32);
+
+                            extractBits(values.data(), mask, extracted.data(), values.size());
+                            depositBits(values.data(), mask, deposited.data(), values.size());
+                            extractBits(values32.data(), mask32, extracted32.data(), values32.size());
+                            depositBits(deposited32.data(), mask32, deposited32.data(), deposited32.size());
+
+                            for(size_t i = 0; i < values.size(); ++i) {
+                                REQUIRE(extracted[i] == referenceExtractBits(values[i], mask));
+                                REQUIRE(deposited[i] == referenceDepositBits(values[i], mask));
+                                REQUIRE(extracted32[i] == referenceExtractBits(values32[i], mask32));
+                                REQUIRE(deposited32[i] == referenceDepositBits(values32[i], mask32));
+                            }
+
+                            detail::extractBitsPortable(values.data(), mask, extracted.data(), values.size());
+                            detail::depositBitsPortable(values.data(), mask, deposited.data(), values.size());
+
+                            for(size_t i = 0; i < values.size(); ++i) {
+                                REQUIRE(extracted[i] == referenceExtractBits(values[i], mask));
+                                REQUIRE(deposited[i] == referenceDepositBits(values[i], mask));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <bitter_find.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("set and clear bits can be found") {
+            GIVEN("multiple bytes") {
+                constexpr uint8_t bytes[] = { 0b00000000, 0b00010100, 0b11111111, 0b11101111 };
+
+                WHEN("searching forwards") {
+                    THEN("the correct indices should be returned") {
+                        REQUIRE(bitter::findFirstSet(bytes, 32) == 10);
+                        REQUIRE(bitter::findNextSet(bytes, 32, 11) == 12);
+                        REQUIRE(bitter::findNextSet(bytes, 32, 13) == 16);
+                        REQUIRE(bitter::findFirstClear(bytes, 32) == 0);
+                        REQUIRE(bitter::findNextClear(bytes, 32, 16) == 28);
+                        REQUIRE(bitter::findNextClear(bytes, 32, 29) == 32);
+                        REQUIRE(bitter::findFirstSet(bytes, 10) == 10);
+                    }
+                }
+
+                WHEN("searching backwards") {
+                    THEN("the correct indices should be returned") {
+                        REQUIRE(bitter::findLastSet(bytes, 32) == 31);
+                        REQUIRE(bitter::findPreviousSet(bytes, 32, 15) == 12);
+                        REQUIRE(bitter::findPreviousSet(bytes, 32, 9) == 32);
+                        REQUIRE(bitter::findLastClear(bytes, 32) == 28);
+                        REQUIRE(bitter::findPreviousClear(bytes, 32, 27) == 15);
+                        REQUIRE(bitter::findLastSet(bytes, 0) == 0);
+                    }
+                }
+
+                WHEN("the set bits are iterated") {
+                    std::vector<size_t> indices;
+
+                    for(const size_t bitNumber : bitter::eachSetBit(bytes, 20)) {
+                        indices.push_back(bitNumber);
+                    }
+
+                    THEN("each set bit is visited once, in order") {
+                        REQUIRE(indices == std::vector<size_t>({ 10, 12, 16, 17, 18, 19 }));
+                    }
+                }
+            }
+
+            GIVEN("a large sparse buffer") {
+                const size_t totalBits = 5000;
+                std::vector<uint8_t> bytes((totalBits + 7) / 8, 0);
+
+                std::vector<size_t> setBits = { 3, 63, 64, 65, 127, 128, 700, 701, 2048, 4093, 4999 };
+                for(const size_t bitNumber : setBits) {
+                    bitter::setBit(bytes.data(), bitNumber, Bit::One);
+                }
+
+                WHEN("every starting point is searched from") {
+                    THEN("each result matches scanning the bits one at a time") {
+                        for(size_t from = 0; from < totalBits; ++from) {
+                            size_t nextSet = from;
+                            while(nextSet < totalBits && bitter::getBit(bytes.data(), nextSet) == Bit::Zero) {
+                                ++nextSet;
+                            }
+
+                            size_t previousSet = from + 1;
+                            while(previousSet > 0 && bitter::getBit(bytes.data(), previousSet - 1) == Bit::Zero) {
+                                --previousSet;
+                            }
+                            previousSet = previousSet == 0 ? totalBits : previousSet - 1;
+
+                            REQUIRE(bitter::findNextSet(bytes.data(), totalBits, from) == nextSet);
+                            REQUIRE(bitter::findPreviousSet(bytes.data(), totalBits, from) == previousSet);
+                        }
+                    }
+                }
+
+                WHEN("the set bits are iterated") {
+                    std::vector<size_t> indices(bitter::eachSetBit(bytes.data(), totalBits).begin(), bitter::eachSetBit(bytes.data(), totalBits).end());
+
+                    THEN("each set bit is visited once, in order") {
+                        REQUIRE(indices == setBits);
+                    }
+                }
+
+                WHEN("the bits are inverted") {
+                    for(auto& byte : bytes) {
+                        byte = static_cast<uint8_t>(~byte);
+                    }
+
+                    THEN("the clear bits can be found instead") {
+                        REQUIRE(bitter::findFirstClear(bytes.data(), totalBits) == 3);
+                        REQUIRE(bitter::findNextClear(bytes.data(), totalBits, 66) == 127);
+                        REQUIRE(bitter::findNextClear(bytes.data(), totalBits, 2049) == 4093);
+                        REQUIRE(bitter::findLastClear(bytes.data(), totalBits) == 4999);
+                        REQUIRE(bitter::findPreviousClear(bytes.data(), totalBits, 4998) == 4093);
+                        REQUIRE(bitter::findPreviousClear(bytes.data(), totalBits, 2047) == 701);
+                    }
+                }
+            }
+        }
+    }
+}
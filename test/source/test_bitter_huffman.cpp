@@ -0,0 +1,215 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_bit_reader.hpp>
+#include <bitter_bit_writer.hpp>
+#include <bitter_huffman.hpp>
+
+namespace bitter {
+    namespace test {
+        //!
+        //! \brief  Writes symbols with the canonical code for the given code lengths, the way DEFLATE assigns codes
+        //!
+        template <BitOrder Order>
+        std::vector<uint8_t> huffmanEncode(const std::vector<uint8_t>& codeLengths, const std::vector<uint16_t>& symbols) {
+            std::vector<uint32_t> codes(codeLengths.size());
+            uint32_t code = 0;
+
+            for(size_t length = 1; length <= 16; ++length) {
+                code <<= 1;
+
+                for(size_t symbol = 0; symbol < codeLengths.size(); ++symbol) {
+                    if(codeLengths[symbol] == length) {
+                        codes[symbol] = code++;
+                    }
+                }
+            }
+
+            BasicBitWriter<Order> writer;
+
+            for(const uint16_t symbol : symbols) {
+                const size_t length = codeLengths[symbol];
+
+                if(Order == BitOrder::MsbFirst) {
+                    writer.write(codes[symbol], length);
+                } else {
+                    // the first bit of a code is its most significant, so it goes into the lowest bit written
+                    for(size_t i = 0; i < length; ++i) {
+                        writer.write(codes[symbol] >> (length - 1 - i), 1);
+                    }
+                }
+            }
+
+            writer.finish();
+            return writer.buffer();
+        }
+
+        //!
+        //! \brief  Encodes pseudo-random symbols and checks both ways of decoding return them
+        //!
+        template <BitOrder Order>
+        void requireHuffmanRoundTrip(const std::vector<uint8_t>& codeLengths) {
+            std::vector<uint16_t> symbols;
+
+            std::mt19937 random(5);
+            while(symbols.size() < 5000) {
+                // skew towards low symbols, so short and long codes both turn up
+                const size_t skew = random() % 4;
+                const size_t symbol = (random() % codeLengths.size()) >> skew;
+                if(codeLengths[symbol] != 0) {
+                    symbols.push_back(static_cast<uint16_t>(symbol));
+                }
+            }
+
+            const std::vector<uint8_t> bytes = huffmanEncode<Order>(codeLengths, symbols);
+            const BasicHuffmanDecoder<Order> decoder(codeLengths.data(), codeLengths.size());
+
+            REQUIRE(decoder.isValid());
+
+            BasicBitReader<Order> reader(bytes.data(), bytes.size());
+            for(const uint16_t symbol : symbols) {
+                REQUIRE(decoder.decode(reader) == symbol);
+            }
+
+            // odd counts, so pairs get split across calls
+            BasicBitReader<Order> bulkReader(bytes.data(), bytes.size());
+            std::vector<uint16_t> decoded(symbols.size());
+
+            for(size_t start = 0; start < symbols.size(); start += 333) {
+                const size_t count = std::min<size_t>(333, symbols.size() - start);
+                REQUIRE(decoder.decode(bulkReader, decoded.data() + start, count) == count);
+            }
+
+            REQUIRE(decoded == symbols);
+            REQUIRE(bulkReader.position() == reader.position());
+        }
+
+        SCENARIO("canonical Huffman codes can be decoded") {
+            GIVEN("the fixed DEFLATE literal/length code") {
+                std::vector<uint8_t> codeLengths(288, 8);
+                std::fill(codeLengths.begin() + 144, codeLengths.begin() + 256, 9);
+                std::fill(codeLengths.begin() + 256, codeLengths.begin() + 280, 7);
+
+                WHEN("symbols are decoded") {
+                    THEN("they are the symbols that were encoded, in either bit order") {
+                        requireHuffmanRoundTrip<BitOrder::LsbFirst>(codeLengths);
+                        requireHuffmanRoundTrip<BitOrder::MsbFirst>(codeLengths);
+                    }
+                }
+            }
+
+            GIVEN("codes of every length up to the maximum") {
+                // lengths 1 to 15, then two codes of 16 bits, plus unused symbols
+                std::vector<uint8_t> codeLengths = { 0, 3 };
+                for(uint8_t length = 1; length <= 16; ++length) {
+                    codeLengths.push_back(length);
+                }
+
+                codeLengths[1] = 0;
+                codeLengths.push_back(16);
+
+                WHEN("symbols are decoded") {
+                    THEN("those with codes longer than the root table come from sub-tables") {
+                        requireHuffmanRoundTrip<BitOrder::LsbFirst>(codeLengths);
+                        requireHuffmanRoundTrip<BitOrder::MsbFirst>(codeLengths);
+                    }
+                }
+            }
+
+            GIVEN("a code with many short codes") {
+                std::vector<uint8_t> codeLengths(4, 3);
+                codeLengths.push_back(2);
+                codeLengths.push_back(2);
+
+                WHEN("symbols are decoded") {
+                    THEN("several codes fit in a root table index") {
+                        requireHuffmanRoundTrip<BitOrder::LsbFirst>(codeLengths);
+                        requireHuffmanRoundTrip<BitOrder::MsbFirst>(codeLengths);
+                    }
+                }
+            }
+
+            GIVEN("the JPEG luminance DC table") {
+                const uint8_t countsPerLength[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+                const uint8_t symbols[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+                const MsbHuffmanDecoder decoder(countsPerLength, symbols);
+
+                // 00 010 1110 111111110 and then 1 bits
+                constexpr uint8_t bytes[] = { 0b00010111, 0b01111111, 0b10111111, 0b11111111 };
+
+                WHEN("a segment of a scan is decoded") {
+                    MsbBitReader reader(bytes, sizeof(bytes));
+
+                    THEN("the symbols follow the order of the table") {
+                        REQUIRE(decoder.isValid());
+                        REQUIRE(decoder.decode(reader) == 0);
+                        REQUIRE(decoder.decode(reader) == 1);
+                        REQUIRE(decoder.decode(reader) == 6);
+                        REQUIRE(decoder.decode(reader) == 11);
+                        REQUIRE(reader.position() == 18);
+
+                        // nine 1 bits are not a code
+                        REQUIRE(decoder.decode(reader) == MsbHuffmanDecoder::invalidSymbol);
+                        REQUIRE(reader.position() == 18);
+                    }
+                }
+            }
+
+            GIVEN("code lengths that do not describe a prefix code") {
+                const uint8_t overSubscribed[] = { 1, 1, 1 };
+                const uint8_t tooLong[] = { 1, 17 };
+
+                WHEN("decoders are built from them") {
+                    const HuffmanDecoder first(overSubscribed, 3);
+                    const HuffmanDecoder second(tooLong, 2);
+
+                    THEN("they are invalid") {
+                        REQUIRE_FALSE(first.isValid());
+                        REQUIRE_FALSE(second.isValid());
+                    }
+                }
+            }
+
+            GIVEN("an incomplete code") {
+                const uint8_t codeLengths[] = { 1 };
+                const HuffmanDecoder decoder(codeLengths, 1);
+
+                constexpr uint8_t bytes[] = { 0b00000110 };
+
+                WHEN("bits that are not a code are met") {
+                    BitReader reader(bytes, sizeof(bytes));
+                    uint16_t symbols[4] = {};
+
+                    THEN("decoding stops there") {
+                        REQUIRE(decoder.isValid());
+                        REQUIRE(decoder.decode(reader, symbols, 4) == 1);
+                        REQUIRE(symbols[0] == 0);
+                        REQUIRE(reader.position() == 1);
+                        REQUIRE(decoder.decode(reader) == HuffmanDecoder::invalidSymbol);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,131 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_layout.hpp>
+#include <bitter_read.hpp>
+
+namespace bitter {
+    namespace test {
+        //!
+        //! \brief  Checks decode() and encode() of a layout against getBits on random records
+        //!
+        template <BitOrder Order, typename... Fields>
+        void checkLayout(BasicLayout<Order, Fields...>) {
+            using LayoutType = BasicLayout<Order, Fields...>;
+
+            const size_t offsets[] = { Fields::offset... };
+            const size_t widths[] = { Fields::width... };
+
+            std::mt19937_64 random(0x9E3779B97F4A7C15 ^ LayoutType::bitCount);
+
+            for(size_t round = 0; round < 100; ++round) {
+                // a guard byte on either side shows nothing outside the record is touched
+                std::vector<uint8_t> buffer(LayoutType::byteCount + 2);
+                for(uint8_t& byte : buffer) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                const std::vector<uint8_t> original = buffer;
+                const typename LayoutType::Values decoded = LayoutType::decode(buffer.data() + 1);
+
+                for(size_t i = 0; i < LayoutType::fieldCount; ++i) {
+                    REQUIRE(decoded[i] == getBits<Order>(buffer.data() + 1, offsets[i], widths[i]));
+                }
+
+                typename LayoutType::Values values;
+                for(uint64_t& value : values) {
+                    value = random();
+                }
+
+                LayoutType::encode(buffer.data() + 1, values);
+
+                REQUIRE(buffer.front() == original.front());
+                REQUIRE(buffer.back() == original.back());
+
+                for(size_t bitNumber = 0; bitNumber < LayoutType::byteCount * 8; ++bitNumber) {
+                    bool inField = false;
+
+                    for(size_t i = 0; i < LayoutType::fieldCount; ++i) {
+                        if(bitNumber >= offsets[i] && bitNumber < offsets[i] + widths[i]) {
+                            inField = true;
+
+                            // the first bit of an MSB-first field is its most significant
+                            const size_t valueBit = Order == BitOrder::MsbFirst ? offsets[i] + widths[i] - 1 - bitNumber : bitNumber - offsets[i];
+                            REQUIRE(getBit<Order>(buffer.data() + 1, bitNumber) == (((values[i] >> valueBit) & 1) != 0 ? Bit::One : Bit::Zero));
+                        }
+                    }
+
+                    if(! inField) {
+                        REQUIRE(getBit<Order>(buffer.data() + 1, bitNumber) == getBit<Order>(original.data() + 1, bitNumber));
+                    }
+                }
+
+                const typename LayoutType::Values reencoded = LayoutType::decode(buffer.data() + 1);
+                for(size_t i = 0; i < LayoutType::fieldCount; ++i) {
+                    REQUIRE(reencoded[i] == (values[i] & detail::lowBitMask(widths[i])));
+                }
+            }
+        }
+
+        SCENARIO("packed records can be decoded and encoded with a layout") {
+            GIVEN("the documented example") {
+                using Header = Layout<Field<0, 3>, Field<3, 13>, Field<16, 16>>;
+                constexpr uint8_t data[] = { 0x29, 0x01, 0x34, 0x12 };
+
+                THEN("the documented result is returned") {
+                    REQUIRE(Header::fieldCount == 3);
+                    REQUIRE(Header::bitCount == 32);
+                    REQUIRE(Header::byteCount == 4);
+                    REQUIRE(Header::decode(data) == Header::Values({ 1, 37, 0x1234 }));
+
+                    uint8_t encoded[4] = { };
+                    Header::encode(encoded, { 1, 37, 0x1234 });
+                    REQUIRE(std::vector<uint8_t>(encoded, encoded + 4) == std::vector<uint8_t>(data, data + 4));
+                }
+            }
+
+            GIVEN("an MSB-first network header") {
+                // an IPv4 header's version, header length, DSCP, ECN and total length
+                using Ipv4 = MsbLayout<Field<0, 4>, Field<4, 4>, Field<8, 6>, Field<14, 2>, Field<16, 16>>;
+                constexpr uint8_t data[] = { 0x45, 0xB9, 0x05, 0xDC };
+
+                THEN("the fields are read from the most significant bit of each byte") {
+                    REQUIRE(Ipv4::decode(data) == Ipv4::Values({ 4, 5, 46, 1, 1500 }));
+                }
+            }
+
+            GIVEN("layouts with gaps, unsorted fields and fields crossing words") {
+                THEN("each field matches getBits and encoding keeps the bits outside the fields") {
+                    checkLayout(Layout<Field<0, 1>>());
+                    checkLayout(Layout<Field<0, 64>, Field<64, 32>>());
+                    checkLayout(Layout<Field<60, 9>, Field<3, 13>, Field<100, 64>, Field<170, 1>>());
+                    checkLayout(Layout<Field<1, 63>, Field<64, 64>, Field<128, 7>>());
+                    checkLayout(MsbLayout<Field<0, 1>>());
+                    checkLayout(MsbLayout<Field<0, 64>, Field<64, 32>>());
+                    checkLayout(MsbLayout<Field<60, 9>, Field<3, 13>, Field<100, 64>, Field<170, 1>>());
+                    checkLayout(MsbLayout<Field<1, 63>, Field<64, 64>, Field<128, 7>>());
+                }
+            }
+        }
+    }
+}
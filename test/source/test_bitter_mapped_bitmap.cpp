@@ -0,0 +1,129 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+#include <bitter_mapped_bitmap.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bitmaps can be kept in memory-mapped files") {
+            const char* const path = "test_bitter_mapped_bitmap.bin";
+            const size_t bitCount = 1000003;
+
+            GIVEN("a newly created file") {
+                MappedBitmap bitmap;
+                REQUIRE(bitmap.create(path, bitCount));
+
+                WHEN("bits are set and flushed") {
+                    REQUIRE(bitmap.advise(MappedBitmap::Access::Random));
+
+                    bitmap.setBit(12345, Bit::One);
+                    bitmap.setBits(500000, 64, 0xFF00FF00FF00FF00);
+                    bitmap.setBit(bitCount - 1, Bit::One);
+
+                    REQUIRE(bitmap.flush());
+                    bitmap.close();
+
+                    THEN("they can be found after opening the file again") {
+                        MappedBitmap reopened;
+                        REQUIRE(reopened.open(path, MappedBitmap::Mode::ReadOnly));
+                        REQUIRE(reopened.advise(MappedBitmap::Access::Sequential));
+
+                        REQUIRE(reopened.isOpen());
+                        REQUIRE_FALSE(reopened.isWritable());
+                        REQUIRE(reopened.sizeInBytes() == (bitCount + 7) / 8);
+                        REQUIRE(reopened.size() == reopened.sizeInBytes() * 8);
+
+                        REQUIRE(reopened.getBit(12345) == Bit::One);
+                        REQUIRE(reopened.getBits(500000, 64) == 0xFF00FF00FF00FF00);
+                        REQUIRE(reopened.countOnes() == 34);
+                        REQUIRE(reopened.countOnes(500000, 16) == 8);
+
+                        REQUIRE(reopened.findFirstSet() == 12345);
+                        REQUIRE(reopened.findNextSet(12346) == 500008);
+                        REQUIRE(reopened.findLastSet() == bitCount - 1);
+                        REQUIRE(reopened.findPreviousSet(bitCount - 2) == 500063);
+                        REQUIRE(reopened.findFirstClear() == 0);
+                        REQUIRE(reopened.findNextClear(500008) == 500016);
+                        REQUIRE(reopened.findLastClear() == reopened.size() - 1);
+                        REQUIRE(reopened.findPreviousClear(500063) == 500055);
+                    }
+                }
+
+                WHEN("the file is reopened for writing while still mapped") {
+                    MappedBitmap writer;
+                    REQUIRE(writer.open(path, MappedBitmap::Mode::ReadWrite));
+                    REQUIRE(writer.isWritable());
+
+                    writer.setBits(64, 8, 0xA5);
+
+                    THEN("both mappings see the change") {
+                        REQUIRE(bitmap.getBits(64, 8) == 0xA5);
+                        REQUIRE(bitmap.advise(MappedBitmap::Access::WillNeed, 64, 8));
+                    }
+                }
+
+                WHEN("the bitmap is moved") {
+                    bitmap.setBit(7, Bit::One);
+                    MappedBitmap moved(std::move(bitmap));
+
+                    THEN("the mapping moves with it") {
+                        REQUIRE(moved.isOpen());
+                        REQUIRE(moved.getBit(7) == Bit::One);
+                        REQUIRE_FALSE(bitmap.isOpen());
+                        REQUIRE(bitmap.data() == nullptr);
+                    }
+                }
+            }
+
+            GIVEN("a file that does not exist") {
+                std::remove(path);
+                MappedBitmap bitmap;
+
+                WHEN("it is opened") {
+                    THEN("opening fails") {
+                        REQUIRE_FALSE(bitmap.open(path, MappedBitmap::Mode::ReadOnly));
+                        REQUIRE_FALSE(bitmap.isOpen());
+                        REQUIRE_FALSE(bitmap.flush());
+                    }
+                }
+            }
+
+            GIVEN("an empty file") {
+                MappedBitmap bitmap;
+                REQUIRE(bitmap.create(path, 0));
+
+                WHEN("it is used") {
+                    THEN("it is an open bitmap without bits") {
+                        REQUIRE(bitmap.isOpen());
+                        REQUIRE(bitmap.size() == 0);
+                        REQUIRE(bitmap.countOnes() == 0);
+                        REQUIRE(bitmap.findFirstSet() == 0);
+                        REQUIRE(bitmap.flush());
+                    }
+                }
+            }
+
+            std::remove(path);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_morton.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        //!
+        //! \brief  Checks the Morton codes of pseudo-random coordinates against interleaving them one bit at a time
+        //!
+        template <typename T>
+        void requireMortonCodesMatchBitByBit(const size_t bitsPerCoordinate3) {
+            using Code2 = typename detail::MortonCode<T>::Code2;
+            using Code3 = typename detail::MortonCode<T>::Code3;
+
+            const size_t count = 1000;
+            std::vector<T> x(count), y(count), z(count);
+
+            std::mt19937 random(sizeof(T));
+            for(size_t i = 0; i < count; ++i) {
+                x[i] = static_cast<T>(random());
+                y[i] = static_cast<T>(random());
+                z[i] = static_cast<T>(random());
+            }
+
+            std::vector<Code2> codes2(count);
+            std::vector<Code3> codes3(count);
+
+            interleave2(x.data(), y.data(), codes2.data(), count);
+            interleave3(x.data(), y.data(), z.data(), codes3.data(), count);
+
+            for(size_t i = 0; i < count; ++i) {
+                Code2 expected2 = 0;
+                Code3 expected3 = 0;
+
+                for(size_t bit = 0; bit < sizeof(T) * 8; ++bit) {
+                    setBit(&expected2, 2 * bit, getBit(&x[i], bit));
+                    setBit(&expected2, (2 * bit) + 1, getBit(&y[i], bit));
+                }
+
+                for(size_t bit = 0; bit < bitsPerCoordinate3; ++bit) {
+                    setBit(&expected3, 3 * bit, getBit(&x[i], bit));
+                    setBit(&expected3, (3 * bit) + 1, getBit(&y[i], bit));
+                    setBit(&expected3, (3 * bit) + 2, getBit(&z[i], bit));
+                }
+
+                REQUIRE(interleave2(x[i], y[i]) == expected2);
+                REQUIRE(codes2[i] == expected2);
+                REQUIRE(interleave3(x[i], y[i], z[i]) == expected3);
+                REQUIRE(codes3[i] == expected3);
+            }
+
+            std::vector<T> decodedX(count), decodedY(count), decodedZ(count);
+
+            deinterleave2(codes2.data(), decodedX.data(), decodedY.data(), count);
+            REQUIRE(decodedX == x);
+            REQUIRE(decodedY == y);
+
+            deinterleave3(codes3.data(), decodedX.data(), decodedY.data(), decodedZ.data(), count);
+
+            const T mask = static_cast<T>(detail::lowBitMask(bitsPerCoordinate3));
+            for(size_t i = 0; i < count; ++i) {
+                REQUIRE(decodedX[i] == (x[i] & mask));
+                REQUIRE(decodedY[i] == (y[i] & mask));
+                REQUIRE(decodedZ[i] == (z[i] & mask));
+
+                T singleX, singleY, singleZ;
+                deinterleave3(codes3[i], singleX, singleY, singleZ);
+                REQUIRE(singleX == decodedX[i]);
+                REQUIRE(singleY == decodedY[i]);
+                REQUIRE(singleZ == decodedZ[i]);
+            }
+        }
+
+        SCENARIO("coordinates can be interleaved into Morton codes") {
+            GIVEN("small coordinates") {
+                WHEN("they are interleaved") {
+                    THEN("x takes the lowest bit") {
+                        REQUIRE(interleave2<uint8_t>(0b11, 0b01) == 0b0111);
+                        REQUIRE(interleave2<uint8_t>(0xFF, 0x00) == 0x5555);
+                        REQUIRE(interleave3<uint8_t>(0b1, 0b0, 0b1) == 0b101);
+                        REQUIRE(interleave3<uint16_t>(0xFFFF, 0, 0) == 0x0000249249249249);
+                        REQUIRE(interleave2<uint32_t>(0, 0xFFFFFFFF) == 0xAAAAAAAAAAAAAAAA);
+                    }
+                }
+            }
+
+            GIVEN("coordinates of every supported type") {
+                WHEN("they are interleaved and split again") {
+                    THEN("the codes match interleaving bit by bit and split back into the coordinates") {
+                        requireMortonCodesMatchBitByBit<uint8_t>(8);
+                        requireMortonCodesMatchBitByBit<uint16_t>(16);
+                        requireMortonCodesMatchBitByBit<uint32_t>(21);
+                    }
+                }
+            }
+
+            GIVEN("the shift-and-mask fallbacks") {
+                WHEN("they are given arbitrary words") {
+                    THEN("they agree with the PDEP and PEXT paths, whichever runs on this CPU") {
+                        std::mt19937_64 random(2);
+                        for(size_t i = 0; i < 1000; ++i) {
+                            const uint64_t value = random();
+
+                            REQUIRE(detail::spreadBits2Portable(value) == depositBits(value, uint64_t(0x5555555555555555)));
+                            REQUIRE(detail::compactBits2Portable(value) == extractBits(value, uint64_t(0x5555555555555555)));
+                            REQUIRE(detail::spreadBits3Portable(value) == depositBits(value, uint64_t(0x1249249249249249)));
+                            REQUIRE(detail::compactBits3Portable(value) == extractBits(value, uint64_t(0x1249249249249249)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,159 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <bitter_packed_array.hpp>
+#include <bitter_word.hpp>
+
+namespace bitter {
+    namespace test {
+        namespace {
+            std::vector<uint64_t> randomValues(const size_t count, const size_t width) {
+                std::vector<uint64_t> values(count);
+
+                std::mt19937_64 random(width);
+                for(auto& value : values) {
+                    value = random() & detail::lowBitMask(width);
+                }
+
+                return values;
+            }
+        }
+
+        SCENARIO("fixed-width integers can be packed") {
+            GIVEN("an array with a compile-time width") {
+                PackedArray<13> array(100);
+
+                WHEN("elements are set") {
+                    array.set(0, 8191);
+                    array.set(4, 0x1234);
+                    array.set(5, 0xFFFF);
+
+                    THEN("they read back masked to the width, leaving their neighbours alone") {
+                        REQUIRE(array.size() == 100);
+                        REQUIRE(array.width() == 13);
+
+                        REQUIRE(array.get(0) == 8191);
+                        REQUIRE(array.get(1) == 0);
+                        REQUIRE(array.get(3) == 0);
+                        REQUIRE(array.get(4) == 0x1234);
+                        REQUIRE(array.get(5) == 0x1FFF);
+                        REQUIRE(array.get(6) == 0);
+                    }
+                }
+            }
+
+            GIVEN("arrays of every runtime width") {
+                const size_t size = 301;
+
+                WHEN("they are filled one element at a time") {
+                    THEN("get, unpack and pack agree with each other") {
+                        for(size_t width = 1; width <= 64; ++width) {
+                            const auto values = randomValues(size, width);
+
+                            PackedArray<> array(size, width);
+                            REQUIRE(array.width() == width);
+
+                            for(size_t i = 0; i < size; ++i) {
+                                array.set(i, values[i] | ~detail::lowBitMask(width));
+                            }
+
+                            for(size_t i = 0; i < size; ++i) {
+                                REQUIRE(array.get(i) == values[i]);
+                            }
+
+                            for(const size_t begin : { size_t(0), size_t(1), size_t(7), size_t(64), size_t(150) }) {
+                                std::vector<uint64_t> unpacked(size - begin);
+                                array.unpack(begin, size, unpacked.data());
+                                REQUIRE(unpacked == std::vector<uint64_t>(values.begin() + begin, values.end()));
+
+                                if(width <= 32) {
+                                    std::vector<uint32_t> narrow(size - begin);
+                                    array.unpack(begin, size, narrow.data());
+                                    REQUIRE(std::vector<uint64_t>(narrow.begin(), narrow.end()) == unpacked);
+                                }
+                            }
+
+                            for(const size_t count : { size_t(0), size_t(1), size_t(63), size_t(size) }) {
+                                const auto newValues = randomValues(count, width + 100);
+
+                                PackedArray<> packed(size, width);
+                                for(size_t i = 0; i < size; ++i) {
+                                    packed.set(i, values[i]);
+                                }
+
+                                packed.pack(newValues.begin(), count);
+
+                                for(size_t i = 0; i < size; ++i) {
+                                    REQUIRE(packed.get(i) == (i < count ? (newValues[i] & detail::lowBitMask(width)) : values[i]));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            GIVEN("runtime widths outside [1, 64]") {
+                WHEN("arrays are created with them") {
+                    THEN("the arrays are empty") {
+                        for(const size_t width : { size_t(0), size_t(65), size_t(1000) }) {
+                            PackedArray<> array(100, width);
+
+                            REQUIRE(array.size() == 0);
+                            REQUIRE(array.width() == 0);
+                        }
+                    }
+                }
+            }
+
+            GIVEN("arrays with compile-time widths") {
+                WHEN("they are packed and unpacked in bulk") {
+                    THEN("the values survive the round trip") {
+                        const auto check = [](auto array) {
+                            const auto values = randomValues(array.size(), array.width());
+                            array.pack(values.data(), values.size());
+
+                            std::vector<uint64_t> unpacked;
+                            array.unpack(0, array.size(), std::back_inserter(unpacked));
+                            REQUIRE(unpacked == values);
+
+                            std::vector<uint32_t> narrow(array.size());
+                            array.unpack(0, array.size(), narrow.data());
+                            for(size_t i = 0; i < array.size(); ++i) {
+                                REQUIRE(narrow[i] == static_cast<uint32_t>(values[i]));
+                            }
+                        };
+
+                        check(PackedArray<1>(1000));
+                        check(PackedArray<3>(1000));
+                        check(PackedArray<17>(1000));
+                        check(PackedArray<25>(1001));
+                        check(PackedArray<26>(1001));
+                        check(PackedArray<33>(999));
+                        check(PackedArray<64>(999));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_rank_select.hpp>
+#include <bitter_read.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("rank and select queries can be answered") {
+            GIVEN("a single byte") {
+                constexpr uint8_t byte = 0b10100110;
+                const RankSelectIndex index(&byte, 8);
+
+                WHEN("it is queried") {
+                    THEN("the correct values should be returned") {
+                        REQUIRE(index.size() == 8);
+                        REQUIRE(index.countOnes() == 4);
+
+                        REQUIRE(index.rank1(0) == 0);
+                        REQUIRE(index.rank1(3) == 2);
+                        REQUIRE(index.rank1(8) == 4);
+                        REQUIRE(index.rank0(8) == 4);
+
+                        REQUIRE(index.select1(0) == 1);
+                        REQUIRE(index.select1(2) == 5);
+                        REQUIRE(index.select1(3) == 7);
+                        REQUIRE(index.select1(4) == 8);
+                    }
+                }
+            }
+
+            GIVEN("large buffers with different densities") {
+                const size_t totalBits = 70001;
+
+                WHEN("every rank and select query is made") {
+                    THEN("each result matches counting the bits one at a time") {
+                        for(const uint32_t density : { 1u, 20u, 128u, 250u, 256u }) {
+                            std::vector<uint8_t> bytes((totalBits + 7) / 8, 0);
+
+                            std::mt19937 random(density);
+                            for(size_t i = 0; i < totalBits; ++i) {
+                                if((random() & 0xFF) < density) {
+                                    bitter::setBit(bytes.data(), i, Bit::One);
+                                }
+                            }
+
+                            const RankSelectIndex index(bytes.data(), totalBits);
+
+                            size_t ones = 0;
+
+                            for(size_t i = 0; i < totalBits; ++i) {
+                                REQUIRE(index.rank1(i) == ones);
+
+                                if(bitter::getBit(bytes.data(), i) == Bit::One) {
+                                    REQUIRE(index.select1(ones) == i);
+                                    ++ones;
+                                }
+                            }
+
+                            REQUIRE(index.rank1(totalBits) == ones);
+                            REQUIRE(index.countOnes() == ones);
+                            REQUIRE(index.select1(ones) == totalBits);
+
+                            // the index is small compared to the buffer
+                            REQUIRE(index.indexSizeInBytes() * 100 < bytes.size() * 5);
+                        }
+                    }
+                }
+            }
+
+            GIVEN("a buffer with sparse, thin and dense regions") {
+                // 8192 set bits spread over more than 2^24 bits, over more than 2^17 bits, and close together
+                const size_t sparseBits = 48000000;
+                const size_t thinBits = 8000000;
+                const size_t totalBits = sparseBits + thinBits + 1000003;
+
+                std::vector<uint8_t> bytes((totalBits + 7) / 8, 0);
+
+                for(size_t i = 0; i < sparseBits; i += 4999) {
+                    bitter::setBit(bytes.data(), i, Bit::One);
+                }
+
+                for(size_t i = sparseBits; i < sparseBits + thinBits; i += 97) {
+                    bitter::setBit(bytes.data(), i, Bit::One);
+                }
+
+                std::mt19937 random(1);
+                for(size_t i = sparseBits + thinBits; i < totalBits; ++i) {
+                    if((random() & 1) != 0) {
+                        bitter::setBit(bytes.data(), i, Bit::One);
+                    }
+                }
+
+                const RankSelectIndex index(bytes.data(), totalBits);
+
+                WHEN("every select query is made") {
+                    THEN("each result is the next set bit") {
+                        size_t ones = 0;
+
+                        for(size_t i = 0; i < totalBits; ++i) {
+                            if(bitter::getBit(bytes.data(), i) == Bit::One) {
+                                REQUIRE(index.select1(ones) == i);
+                                REQUIRE(index.rank1(i) == ones);
+                                ++ones;
+                            }
+                        }
+
+                        REQUIRE(index.countOnes() == ones);
+                        REQUIRE(index.select1(ones) == totalBits);
+
+                        // storing the positions of the sparse set bits costs at most 3.2% more
+                        REQUIRE(index.indexSizeInBytes() * 100 < bytes.size() * 7);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -18,6 +18,8 @@
 #include <catch.hpp>
 
 #include <cstdint>
+#include <random>
+#include <vector>
 
 #include <bitter_read.hpp>
 
@@ -123,6 +125,121 @@ namespace bitter {
                 }
             }
         } 
+
+        SCENARIO("ranges of bits can be read from a target") {
+            GIVEN("multiple bytes") {
+                constexpr uint8_t bytes[] = { 0b01010101, 0b10101010, 0b11110000, 0b00001111 };
+
+                WHEN("byte aligned ranges are read") {
+                    THEN("the bytes are returned as a little-endian value") {
+                        REQUIRE(bitter::getBits(bytes, 0, 8) == 0b01010101);
+                        REQUIRE(bitter::getBits(bytes, 8, 8) == 0b10101010);
+                        REQUIRE(bitter::getBits(bytes, 0, 16) == 0b1010101001010101);
+                        REQUIRE(bitter::getBits(bytes, 0, 32) == 0x0FF0AA55);
+                    }
+                }
+
+                WHEN("ranges crossing byte boundaries are read") {
+                    THEN("the correct values should be returned") {
+                        REQUIRE(bitter::getBits(bytes, 4, 8) == 0b10100101);
+                        REQUIRE(bitter::getBits(bytes, 7, 3) == 0b100);
+                        REQUIRE(bitter::getBits(bytes, 20, 8) == 0b11111111);
+                        REQUIRE(bitter::getBits(bytes, 1, 0) == 0);
+                    }
+                }
+
+                WHEN("ranges are read in a constant expression") {
+                    THEN("the correct values should be returned") {
+                        static_assert(bitter::getBits(bytes, 4, 8) == 0b10100101, "");
+                        static_assert(bitter::getBits(bytes, 12, 12) == 0xF0A, "");
+                    }
+                }
+            }
+
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> bytes(37);
+
+                std::mt19937 random(12345);
+                for(auto& byte : bytes) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                WHEN("every range of up to 64 bits is read") {
+                    THEN("each value matches reading the bits one at a time") {
+                        const size_t totalBits = bytes.size() * 8;
+
+                        for(size_t bitCount = 0; bitCount <= 64; ++bitCount) {
+                            for(size_t bitOffset = 0; bitOffset + bitCount <= totalBits; ++bitOffset) {
+                                uint64_t expected = 0;
+
+                                for(size_t i = 0; i < bitCount; ++i) {
+                                    if(bitter::getBit(bytes.data(), bitOffset + i) == Bit::One) {
+                                        expected |= uint64_t(1) << i;
+                                    }
+                                }
+
+                                REQUIRE(bitter::getBits(bytes.data(), bitOffset, bitCount) == expected);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        SCENARIO("bits can be read most significant bit first") {
+            GIVEN("multiple bytes") {
+                constexpr uint8_t bytes[] = { 0xF0, 0x0F, 0x81 };
+
+                WHEN("single bits are read") {
+                    THEN("bit 0 is the most significant bit of the first byte") {
+                        REQUIRE(bitter::getBit<BitOrder::MsbFirst>(bytes, 0) == Bit::One);
+                        REQUIRE(bitter::getBit<BitOrder::MsbFirst>(bytes, 4) == Bit::Zero);
+                        REQUIRE(bitter::getBit<BitOrder::MsbFirst>(bytes, 12) == Bit::One);
+                        REQUIRE(bitter::getBit<BitOrder::MsbFirst>(bytes, 16) == Bit::One);
+                        REQUIRE(bitter::getBit<BitOrder::MsbFirst>(bytes, 23) == Bit::One);
+                    }
+                }
+
+                WHEN("ranges are read") {
+                    THEN("the first bit read is the most significant bit of the value") {
+                        REQUIRE(bitter::getBits<BitOrder::MsbFirst>(bytes, 0, 12) == 0xF00);
+                        REQUIRE(bitter::getBits<BitOrder::MsbFirst>(bytes, 4, 8) == 0x00);
+                        REQUIRE(bitter::getBits<BitOrder::MsbFirst>(bytes, 2, 3) == 0b110);
+                        REQUIRE(bitter::getBits<BitOrder::MsbFirst>(bytes, 0, 24) == 0xF00F81);
+                        REQUIRE(bitter::getBits<BitOrder::MsbFirst>(bytes, 5, 0) == 0);
+
+                        static_assert(bitter::getBits<BitOrder::MsbFirst>(bytes, 12, 12) == 0xF81, "");
+                    }
+                }
+            }
+
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> bytes(37);
+
+                std::mt19937 random(54321);
+                for(auto& byte : bytes) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                WHEN("every range of up to 64 bits is read") {
+                    THEN("each value matches reading the bits one at a time") {
+                        const size_t totalBits = bytes.size() * 8;
+
+                        for(size_t bitCount = 0; bitCount <= 64; ++bitCount) {
+                            for(size_t bitOffset = 0; bitOffset + bitCount <= totalBits; ++bitOffset) {
+                                uint64_t expected = 0;
+
+                                for(size_t i = 0; i < bitCount; ++i) {
+                                    expected = (expected << 1) | static_cast<uint64_t>(bitter::getBit<BitOrder::MsbFirst>(bytes.data(), bitOffset + i));
+                                }
+
+                                REQUIRE(bitter::getBits<BitOrder::MsbFirst>(bytes.data(), bitOffset, bitCount) == expected);
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 }
 
@@ -0,0 +1,111 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_read.hpp>
+#include <bitter_run_length.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bit buffers can be run-length encoded") {
+            GIVEN("two bytes") {
+                constexpr uint8_t bytes[] = { 0xF0, 0xFF };
+
+                WHEN("they are encoded") {
+                    const std::vector<uint8_t> encoded = encodeRuns(bytes, 16);
+
+                    THEN("the first bit is followed by the run lengths") {
+                        REQUIRE(encoded == std::vector<uint8_t>({ 0, 4, 12 }));
+                        REQUIRE(encodeRuns(bytes, 3) == std::vector<uint8_t>({ 0, 3 }));
+                        REQUIRE(encodeRuns(bytes, 0).empty());
+                    }
+                }
+            }
+
+            GIVEN("buffers with runs of very different lengths") {
+                WHEN("they are encoded and decoded") {
+                    THEN("the decoded bits are the original bits") {
+                        for(const size_t averageRun : { 1, 3, 40, 300, 100000 }) {
+                            const size_t bitCount = 300001;
+                            std::vector<uint8_t> original((bitCount + 7) / 8, 0);
+
+                            std::mt19937 random(static_cast<uint32_t>(averageRun));
+                            Bit bitValue = Bit::One;
+                            size_t runs = 0;
+
+                            for(size_t bitNumber = 0; bitNumber < bitCount; ++runs) {
+                                const size_t runLength = std::min<size_t>(1 + (random() % (2 * averageRun)), bitCount - bitNumber);
+
+                                fillBits(original.data(), bitNumber, runLength, bitValue);
+                                bitNumber += runLength;
+                                bitValue = bitValue == Bit::One ? Bit::Zero : Bit::One;
+                            }
+
+                            const std::vector<uint8_t> encoded = encodeRuns(original.data(), bitCount);
+
+                            // a byte or so per run for short runs, and very little for long ones
+                            REQUIRE(encoded[0] == 1);
+                            REQUIRE(encoded.size() <= 1 + (runs * 3));
+
+                            // a different pattern in the last byte shows the bits past the end are kept
+                            std::vector<uint8_t> decoded(original.size(), 0x55);
+                            REQUIRE(decodeRuns(decoded.data(), bitCount, encoded.data(), encoded.size()));
+
+                            for(size_t bitNumber = 0; bitNumber < bitCount; ++bitNumber) {
+                                REQUIRE(getBit(decoded.data(), bitNumber) == getBit(original.data(), bitNumber));
+                            }
+
+                            REQUIRE(getBits(decoded.data(), bitCount, 7) == (0x55 >> 1));
+                        }
+                    }
+                }
+            }
+
+            GIVEN("malformed encodings") {
+                uint8_t target[4] = { };
+
+                const std::vector<uint8_t> tooShort = { 0, 10, 5 };
+                const std::vector<uint8_t> tooLong = { 1, 20, 20 };
+                const std::vector<uint8_t> emptyRun = { 0, 16, 0 };
+                const std::vector<uint8_t> badFirstBit = { 2, 32 };
+                const std::vector<uint8_t> truncatedVarint = { 0, 0x80 };
+                const std::vector<uint8_t> valid = { 0, 0x80 | 30, 0 };
+
+                WHEN("they are decoded") {
+                    THEN("decoding fails") {
+                        REQUIRE_FALSE(decodeRuns(target, 32, tooShort.data(), tooShort.size()));
+                        REQUIRE_FALSE(decodeRuns(target, 32, tooLong.data(), tooLong.size()));
+                        REQUIRE_FALSE(decodeRuns(target, 32, emptyRun.data(), emptyRun.size()));
+                        REQUIRE_FALSE(decodeRuns(target, 32, badFirstBit.data(), badFirstBit.size()));
+                        REQUIRE_FALSE(decodeRuns(target, 32, truncatedVarint.data(), truncatedVarint.size()));
+                        REQUIRE_FALSE(decodeRuns(target, 32, valid.data(), 0));
+
+                        REQUIRE(decodeRuns(target, 30, valid.data(), valid.size()));
+                        REQUIRE(decodeRuns(target, 0, valid.data(), 0));
+                    }
+                }
+            }
+        }
+    }
+}
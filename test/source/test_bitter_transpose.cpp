@@ -0,0 +1,117 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <bitter_read.hpp>
+#include <bitter_transpose.hpp>
+#include <bitter_write.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("bit matrices can be transposed") {
+            GIVEN("8x8 matrices") {
+                WHEN("they are transposed") {
+                    THEN("every bit moves to the mirrored position") {
+                        REQUIRE(transpose8x8(0x00000000000000FF) == 0x0101010101010101);
+                        REQUIRE(transpose8x8(0x8040201008040201) == 0x8040201008040201);
+                        REQUIRE(transpose8x8(0x0000000000000002) == 0x0000000000000100);
+
+                        std::mt19937_64 random(0x0123456789ABCDEF);
+                        for(size_t i = 0; i < 100; ++i) {
+                            const uint64_t matrix = random();
+                            const uint64_t transposed = transpose8x8(matrix);
+
+                            for(size_t bit = 0; bit < 64; ++bit) {
+                                REQUIRE(getBit(&transposed, ((bit % 8) * 8) + (bit / 8)) == getBit(&matrix, bit));
+                            }
+
+                            REQUIRE(transpose8x8(transposed) == matrix);
+                        }
+                    }
+                }
+            }
+
+            GIVEN("a 64x64 matrix") {
+                uint64_t matrix[64];
+
+                std::mt19937_64 random(64);
+                for(auto& row : matrix) {
+                    row = random();
+                }
+
+                uint64_t transposed[64];
+                std::copy(std::begin(matrix), std::end(matrix), std::begin(transposed));
+
+                WHEN("it is transposed") {
+                    transpose64x64(transposed);
+
+                    THEN("bit c of row r moves to bit r of row c") {
+                        for(size_t row = 0; row < 64; ++row) {
+                            for(size_t column = 0; column < 64; ++column) {
+                                REQUIRE(((transposed[column] >> row) & 1) == ((matrix[row] >> column) & 1));
+                            }
+                        }
+                    }
+                }
+            }
+
+            GIVEN("matrices of many sizes") {
+                const std::vector<std::pair<size_t, size_t>> sizes = {
+                    { 0, 5 }, { 1, 1 }, { 7, 13 }, { 64, 64 }, { 130, 70 }, { 65, 200 }, { 128, 64 }, { 48, 200 }, { 256, 8 }
+                };
+
+                WHEN("they are transposed") {
+                    THEN("bit (r * columns + c) moves to bit (c * rows + r)") {
+                        for(const auto& size : sizes) {
+                            const size_t rows = size.first;
+                            const size_t columns = size.second;
+
+                            std::vector<uint8_t> source(((rows * columns) + 7) / 8);
+                            std::vector<uint8_t> target(source.size() + 1, 0);
+
+                            std::mt19937 random(static_cast<uint32_t>(rows + columns));
+                            for(auto& byte : source) {
+                                byte = static_cast<uint8_t>(random());
+                            }
+
+                            transposeBits(target.data(), source.data(), rows, columns);
+
+                            for(size_t row = 0; row < rows; ++row) {
+                                for(size_t column = 0; column < columns; ++column) {
+                                    REQUIRE(getBit(target.data(), (column * rows) + row) == getBit(source.data(), (row * columns) + column));
+                                }
+                            }
+
+                            // nothing is written past the transposed bits
+                            for(size_t bit = rows * columns; bit < target.size() * 8; ++bit) {
+                                REQUIRE(getBit(target.data(), bit) == Bit::Zero);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,212 @@
+/*
+    This file is part of libbitter.
+
+    libbitter is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    libbitter is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with libbitter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitter_bit_reader.hpp>
+#include <bitter_bit_writer.hpp>
+#include <bitter_universal_codes.hpp>
+
+namespace bitter {
+    namespace test {
+        SCENARIO("universal codes produce the standard codewords") {
+            GIVEN("an MsbBitWriter") {
+                MsbBitWriter writer;
+
+                WHEN("unsigned Exp-Golomb codes are written") {
+                    // 1 010 011 00100 00101
+                    writeExpGolomb(writer, 0);
+                    writeExpGolomb(writer, 1);
+                    writeExpGolomb(writer, 2);
+                    writeExpGolomb(writer, 3);
+                    writeExpGolomb(writer, 4);
+                    writer.finish();
+
+                    THEN("they match the codewords used by H.264") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b10100110, 0b01000010, 0b10000000 }));
+                    }
+                }
+
+                WHEN("signed Exp-Golomb codes are written") {
+                    // 1 010 011 00100 00101
+                    writeSignedExpGolomb(writer, 0);
+                    writeSignedExpGolomb(writer, 1);
+                    writeSignedExpGolomb(writer, -1);
+                    writeSignedExpGolomb(writer, 2);
+                    writeSignedExpGolomb(writer, -2);
+                    writer.finish();
+
+                    THEN("positive values get the odd code numbers") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b10100110, 0b01000010, 0b10000000 }));
+                    }
+                }
+
+                WHEN("Elias gamma and delta codes are written") {
+                    // gamma: 1 010 00101, delta: 1 0100 001010001
+                    writeEliasGamma(writer, 1);
+                    writeEliasGamma(writer, 2);
+                    writeEliasGamma(writer, 5);
+                    writeEliasDelta(writer, 1);
+                    writeEliasDelta(writer, 2);
+                    writeEliasDelta(writer, 17);
+                    writer.finish();
+
+                    THEN("they match the textbook codewords") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b10100010, 0b11010000, 0b10100010 }));
+                    }
+                }
+
+                WHEN("Golomb-Rice codes are written") {
+                    // 001 01, 1 11, 00001 00
+                    writeRice(writer, 9, 2);
+                    writeRice(writer, 3, 2);
+                    writeRice(writer, 16, 2);
+                    writer.finish();
+
+                    THEN("the quotient comes first, then the low bits") {
+                        REQUIRE(writer.buffer() == std::vector<uint8_t>({ 0b00101111, 0b00001000 }));
+                    }
+                }
+            }
+
+            GIVEN("an LSB-first stream of Exp-Golomb codes") {
+                // 1 010 011, each code starting at the lowest unused bit
+                constexpr uint8_t bytes[] = { 0b01100101 };
+                BitReader reader(bytes, sizeof(bytes));
+
+                WHEN("it is decoded in bulk") {
+                    uint64_t values[3];
+                    readExpGolomb(reader, values, 3);
+
+                    THEN("the info bits are read least significant first") {
+                        REQUIRE(values[0] == 0);
+                        REQUIRE(values[1] == 1);
+                        REQUIRE(values[2] == 2);
+                        REQUIRE(reader.position() == 7);
+                    }
+                }
+            }
+        }
+
+        SCENARIO("universal codes can be decoded back to the values that were encoded") {
+            GIVEN("values of every bit length") {
+                std::vector<uint64_t> values;
+                std::vector<int64_t> signedValues;
+
+                std::mt19937_64 random(7);
+                for(size_t i = 0; i < 1000; ++i) {
+                    const uint64_t value = random() >> (i % 64);
+                    values.push_back(value != 0 ? value : 1);
+                    signedValues.push_back(static_cast<int64_t>(value >> 1) * ((i % 2) ? -1 : 1));
+                }
+
+                values.push_back(1);
+                values.push_back(~uint64_t(0) - 1);
+                signedValues.push_back(0);
+                signedValues.push_back(INT64_MAX);
+                signedValues.push_back(-INT64_MAX);
+
+                WHEN("they are written and read back in both bit orders") {
+                    THEN("every code returns the same values") {
+                        auto roundTrip = [&](auto writer, auto makeReader) {
+                            writeExpGolomb(writer, values.data(), values.size());
+                            writeSignedExpGolomb(writer, signedValues.data(), signedValues.size());
+                            writeEliasGamma(writer, values.data(), values.size());
+                            writeEliasDelta(writer, values.data(), values.size());
+
+                            for(const uint64_t value : values) {
+                                writeRice(writer, value, 58);
+                            }
+
+                            for(uint64_t value = 0; value < 100; ++value) {
+                                writeRice(writer, value, 0);
+                            }
+
+                            writer.write(~uint64_t(0), 64);
+                            writer.finish();
+
+                            auto reader = makeReader(writer.buffer());
+
+                            std::vector<uint64_t> decoded(values.size());
+                            std::vector<int64_t> signedDecoded(signedValues.size());
+
+                            readExpGolomb(reader, decoded.data(), decoded.size());
+                            REQUIRE(decoded == values);
+
+                            readSignedExpGolomb(reader, signedDecoded.data(), signedDecoded.size());
+                            REQUIRE(signedDecoded == signedValues);
+
+                            readEliasGamma(reader, decoded.data(), decoded.size());
+                            REQUIRE(decoded == values);
+
+                            readEliasDelta(reader, decoded.data(), decoded.size());
+                            REQUIRE(decoded == values);
+
+                            readRice(reader, 58, decoded.data(), decoded.size());
+                            REQUIRE(decoded == values);
+
+                            // the longer of these codes do not fit in a register
+                            for(uint64_t value = 0; value < 100; ++value) {
+                                REQUIRE(readRice(reader, 0) == value);
+                            }
+
+                            REQUIRE(reader.read(64) == ~uint64_t(0));
+                            REQUIRE(reader.bitsRemaining() < 8);
+                        };
+
+                        roundTrip(BitWriter(), [](const std::vector<uint8_t>& buffer) { return BitReader(buffer.data(), buffer.size()); });
+                        roundTrip(MsbBitWriter(), [](const std::vector<uint8_t>& buffer) { return MsbBitReader(buffer.data(), buffer.size()); });
+                    }
+                }
+            }
+
+            GIVEN("a stream of zero bits") {
+                constexpr uint8_t bytes[16] = {};
+
+                WHEN("a code is read from it") {
+                    MsbBitReader expGolombReader(bytes, sizeof(bytes));
+                    MsbBitReader gammaReader(bytes, sizeof(bytes));
+                    BitReader deltaReader(bytes, sizeof(bytes));
+
+                    THEN("the code is reported as malformed") {
+                        REQUIRE(readExpGolomb(expGolombReader) == ~uint64_t(0));
+                        REQUIRE(readEliasGamma(gammaReader) == 0);
+                        REQUIRE(readEliasDelta(deltaReader) == 0);
+                        REQUIRE(expGolombReader.bitsRemaining() == 0);
+                    }
+                }
+            }
+        }
+
+        SCENARIO("the documented Exp-Golomb example decodes as described") {
+            GIVEN("the documented example") {
+                constexpr uint8_t data[] = { 0b01001100 };
+                MsbBitReader reader(data, sizeof(data));
+
+                THEN("the documented results are returned") {
+                    REQUIRE(readExpGolomb(reader) == 1);
+                    REQUIRE(readExpGolomb(reader) == 2);
+                    REQUIRE(reader.position() == 6);
+                }
+            }
+        }
+    }
+}
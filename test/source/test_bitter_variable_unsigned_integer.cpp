@@ -1153,6 +1153,54 @@ namespace bitter {
                 }
             }
         }
+
+        SCENARIO("bits of a VariableUnsignedInteger can be extracted and deposited under a mask") {
+            GIVEN("the documented examples") {
+                VariableUnsignedInteger value(1);
+                VariableUnsignedInteger mask(1);
+                mask = 0xF0u;
+
+                THEN("the documented results are returned") {
+                    value = 0xB2u;
+                    REQUIRE(extractBits(value, mask) == 0xBu);
+
+                    value = 0xBu;
+                    REQUIRE(depositBits(value, mask) == 0xB0u);
+                }
+            }
+
+            GIVEN("a value and mask wider than a word") {
+                VariableUnsignedInteger value(20);
+                VariableUnsignedInteger mask(20);
+                value = 0u;
+                mask = 0u;
+
+                // every other bit of the low 12 bytes is selected, then all of the high 8
+                for(size_t byte = 20; byte-- > 0;) {
+                    VariableUnsignedInteger valueByte(1);
+                    VariableUnsignedInteger maskByte(1);
+                    valueByte = static_cast<uint8_t>(0x3C ^ (byte * 37));
+                    maskByte = static_cast<uint8_t>(byte < 12 ? 0x55 : 0xFF);
+
+                    value = (value << 8u) | valueByte;
+                    mask = (mask << 8u) | maskByte;
+                }
+
+                WHEN("the masked bits are extracted and deposited back") {
+                    const VariableUnsignedInteger extracted = extractBits(value, mask);
+                    const VariableUnsignedInteger deposited = depositBits(extracted, mask);
+
+                    THEN("only the masked bits of the value come back") {
+                        REQUIRE((extracted >> 112u) == 0u);
+                        REQUIRE((extracted >> 111u) != 0u);
+                        REQUIRE(deposited == (value & mask));
+                        REQUIRE(extractBits(deposited, mask) == extracted);
+                        REQUIRE(extractBits(value, ~(mask ^ mask)) == value);
+                        REQUIRE(depositBits(value, mask ^ mask) == 0u);
+                    }
+                }
+            }
+        }
     }
 }
 
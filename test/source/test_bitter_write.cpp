@@ -18,11 +18,26 @@
 #include <catch.hpp>
 
 #include <cstdint>
+#include <random>
+#include <vector>
 
+#include <bitter_read.hpp>
 #include <bitter_write.hpp>
 
 namespace bitter {
     namespace test {
+        constexpr uint8_t setBitsInConstantExpression() {
+            uint8_t bytes[] = { 0, 0 };
+            bitter::setBits(bytes, 4, 8, 0xFF);
+            return bytes[1];
+        }
+
+        constexpr uint8_t setBitsMsbFirstInConstantExpression() {
+            uint8_t bytes[] = { 0xFF, 0xFF };
+            bitter::setBits<BitOrder::MsbFirst>(bytes, 4, 8, 0x5A);
+            return bytes[1];
+        }
+
         SCENARIO("bits can be written to the target") {
             GIVEN("a single byte with all zeros") {
                 uint8_t byte = 0b00000000;
@@ -157,6 +172,192 @@ namespace bitter {
                 }
             }
         }
+
+        SCENARIO("ranges of bits can be written to the target") {
+            GIVEN("multiple bytes with all zeros") {
+                uint8_t bytes[] = { 0, 0, 0 };
+
+                WHEN("a range crossing a byte boundary is set") {
+                    bitter::setBits(bytes, 4, 8, 0xFF);
+
+                    THEN("only the bits in the range change") {
+                        REQUIRE(bytes[0] == 0xF0);
+                        REQUIRE(bytes[1] == 0x0F);
+                        REQUIRE(bytes[2] == 0x00);
+                    }
+                }
+
+                WHEN("a range is set in a constant expression") {
+                    THEN("only the bits in the range change") {
+                        static_assert(setBitsInConstantExpression() == 0x0F, "");
+                    }
+                }
+
+                WHEN("a value wider than the range is set") {
+                    bitter::setBits(bytes, 6, 3, 0xFFFF);
+
+                    THEN("the extra bits of the value are ignored") {
+                        REQUIRE(bytes[0] == 0xC0);
+                        REQUIRE(bytes[1] == 0x01);
+                        REQUIRE(bytes[2] == 0x00);
+                    }
+                }
+            }
+
+            GIVEN("multiple bytes with all ones") {
+                uint8_t bytes[] = { 0xFF, 0xFF, 0xFF };
+
+                WHEN("a 13-bit range is cleared") {
+                    bitter::setBits(bytes, 5, 13, 0);
+
+                    THEN("only the bits in the range change") {
+                        REQUIRE(bytes[0] == 0x1F);
+                        REQUIRE(bytes[1] == 0x00);
+                        REQUIRE(bytes[2] == 0xFC);
+                    }
+                }
+            }
+
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> original(29);
+
+                std::mt19937 random(54321);
+                for(auto& byte : original) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                WHEN("every range of up to 64 bits is set") {
+                    THEN("each range matches setting the bits one at a time") {
+                        const size_t totalBits = original.size() * 8;
+                        const uint64_t value = 0xA5C3F00FDEADBEEF;
+
+                        for(size_t bitCount = 0; bitCount <= 64; ++bitCount) {
+                            for(size_t bitOffset = 0; bitOffset + bitCount <= totalBits; ++bitOffset) {
+                                std::vector<uint8_t> expected = original;
+                                std::vector<uint8_t> actual = original;
+
+                                for(size_t i = 0; i < bitCount; ++i) {
+                                    bitter::setBit(expected.data(), bitOffset + i, ((value >> i) & 1) ? Bit::One : Bit::Zero);
+                                }
+
+                                bitter::setBits(actual.data(), bitOffset, bitCount, value);
+
+                                REQUIRE(actual == expected);
+                                REQUIRE(bitter::getBits(actual.data(), bitOffset, bitCount) == (value & detail::lowBitMask(bitCount)));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        SCENARIO("bits can be written most significant bit first") {
+            GIVEN("multiple bytes with all zeros") {
+                uint8_t bytes[] = { 0, 0, 0 };
+
+                WHEN("single bits are set") {
+                    bitter::setBit<BitOrder::MsbFirst>(bytes, 0, Bit::One);
+                    bitter::setBit<BitOrder::MsbFirst>(bytes, 15, Bit::One);
+
+                    THEN("bit 0 is the most significant bit of the first byte") {
+                        REQUIRE(bytes[0] == 0x80);
+                        REQUIRE(bytes[1] == 0x01);
+                        REQUIRE(bytes[2] == 0x00);
+                    }
+                }
+
+                WHEN("a range crossing a byte boundary is set") {
+                    bitter::setBits<BitOrder::MsbFirst>(bytes, 4, 12, 0xABC);
+
+                    THEN("the most significant bit of the value is written first") {
+                        REQUIRE(bytes[0] == 0x0A);
+                        REQUIRE(bytes[1] == 0xBC);
+                        REQUIRE(bytes[2] == 0x00);
+                    }
+                }
+
+                WHEN("a range is set in a constant expression") {
+                    THEN("only the bits in the range change") {
+                        static_assert(setBitsMsbFirstInConstantExpression() == 0xAF, "");
+                    }
+                }
+            }
+
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> original(29);
+
+                std::mt19937 random(12345);
+                for(auto& byte : original) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                WHEN("every range of up to 64 bits is set") {
+                    THEN("each range matches setting the bits one at a time") {
+                        const size_t totalBits = original.size() * 8;
+                        const uint64_t value = 0xA5C3F00FDEADBEEF;
+
+                        for(size_t bitCount = 0; bitCount <= 64; ++bitCount) {
+                            for(size_t bitOffset = 0; bitOffset + bitCount <= totalBits; ++bitOffset) {
+                                std::vector<uint8_t> expected = original;
+                                std::vector<uint8_t> actual = original;
+
+                                for(size_t i = 0; i < bitCount; ++i) {
+                                    const uint64_t bit = (value >> (bitCount - 1 - i)) & 1;
+                                    bitter::setBit<BitOrder::MsbFirst>(expected.data(), bitOffset + i, bit ? Bit::One : Bit::Zero);
+                                }
+
+                                bitter::setBits<BitOrder::MsbFirst>(actual.data(), bitOffset, bitCount, value);
+
+                                REQUIRE(actual == expected);
+                                REQUIRE(bitter::getBits<BitOrder::MsbFirst>(actual.data(), bitOffset, bitCount) == (value & detail::lowBitMask(bitCount)));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        SCENARIO("ranges of bits can be filled") {
+            GIVEN("a buffer with a complex bit pattern") {
+                std::vector<uint8_t> original(40);
+
+                std::mt19937 random(777);
+                for(auto& byte : original) {
+                    byte = static_cast<uint8_t>(random());
+                }
+
+                WHEN("ranges of every length are filled with either bit") {
+                    THEN("each range matches setting the bits one at a time") {
+                        const size_t totalBits = original.size() * 8;
+
+                        for(const Bit bitValue : { Bit::Zero, Bit::One }) {
+                            for(size_t bitCount = 0; bitCount <= 200; bitCount += 7) {
+                                for(size_t bitOffset = 0; bitOffset + bitCount <= totalBits; bitOffset += 3) {
+                                    std::vector<uint8_t> expected = original;
+                                    std::vector<uint8_t> actual = original;
+                                    std::vector<uint8_t> actualMsbFirst = original;
+
+                                    for(size_t i = 0; i < bitCount; ++i) {
+                                        bitter::setBit(expected.data(), bitOffset + i, bitValue);
+                                    }
+
+                                    bitter::fillBits(actual.data(), bitOffset, bitCount, bitValue);
+                                    REQUIRE(actual == expected);
+
+                                    expected = original;
+                                    for(size_t i = 0; i < bitCount; ++i) {
+                                        bitter::setBit<BitOrder::MsbFirst>(expected.data(), bitOffset + i, bitValue);
+                                    }
+
+                                    bitter::fillBits<BitOrder::MsbFirst>(actualMsbFirst.data(), bitOffset, bitCount, bitValue);
+                                    REQUIRE(actualMsbFirst == expected);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 }
 